@@ -0,0 +1,116 @@
+/* Copyright (c) 2026, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/// \file   benchmark.cpp
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-16
+
+#include "benchmark.h"
+
+#include <naiades/base/parallel.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+
+namespace naiades::benchmarks {
+
+Suite &Suite::setRepetitions(h_size repetitions) {
+  repetitions_ = std::max<h_size>(repetitions, 1);
+  return *this;
+}
+
+Suite &Suite::setFilter(const std::string &filter) {
+  filter_ = filter;
+  return *this;
+}
+
+bool Suite::enabled(const std::string &name) const {
+  return filter_.empty() || name.find(filter_) != std::string::npos;
+}
+
+void Suite::run(const std::string &name, h_size size,
+                const std::function<void()> &f,
+                const std::function<void()> &setup) {
+  if (!enabled(name))
+    return;
+  // warm up
+  if (setup)
+    setup();
+  f();
+
+  std::vector<f64> times;
+  for (h_size r = 0; r < repetitions_; ++r) {
+    if (setup)
+      setup();
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    times.emplace_back(
+        std::chrono::duration<f64, std::milli>(end - start).count());
+  }
+  std::sort(times.begin(), times.end());
+
+  Measurement m;
+  m.name = name;
+  m.size = size;
+  m.repetitions = repetitions_;
+  m.min_ms = times.front();
+  m.median_ms = times[times.size() / 2];
+  m.mean_ms =
+      std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+  measurements_.emplace_back(m);
+  // progress goes to stderr, keeping stdout for the report
+  std::cerr << name << " [" << size << "] " << m.median_ms << " ms"
+            << std::endl;
+}
+
+const std::vector<Measurement> &Suite::measurements() const {
+  return measurements_;
+}
+
+void Suite::writeJson(std::ostream &os) const {
+  os << "{\n";
+  os << "  \"version\": \"" << NAIADES_VERSION << "\",\n";
+  os << "  \"threads\": " << ThreadPool::threadCount() << ",\n";
+  os << "  \"benchmarks\": [";
+  for (h_size i = 0; i < measurements_.size(); ++i) {
+    const auto &m = measurements_[i];
+    os << (i ? ",\n" : "\n");
+    os << "    {\"name\": \"" << m.name << "\", \"size\": " << m.size
+       << ", \"repetitions\": " << m.repetitions
+       << ", \"min_ms\": " << m.min_ms << ", \"median_ms\": " << m.median_ms
+       << ", \"mean_ms\": " << m.mean_ms << "}";
+  }
+  os << "\n  ]\n}\n";
+}
+
+void Suite::writeCsv(std::ostream &os) const {
+  os << "name,size,repetitions,min_ms,median_ms,mean_ms,threads,version\n";
+  for (const auto &m : measurements_)
+    os << m.name << "," << m.size << "," << m.repetitions << "," << m.min_ms
+       << "," << m.median_ms << "," << m.mean_ms << ","
+       << ThreadPool::threadCount() << "," << NAIADES_VERSION << "\n";
+}
+
+} // namespace naiades::benchmarks
@@ -0,0 +1,90 @@
+/* Copyright (c) 2026, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/// \file   benchmark.h
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-16
+/// \brief  Minimal timing harness for the benchmark suite.
+
+#pragma once
+
+#include <hermes/base/index.h>
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace naiades::benchmarks {
+
+/// Timing statistics of a benchmark case.
+struct Measurement {
+  std::string name;
+  /// Problem size of the case (resolution, point count, ...).
+  h_size size{0};
+  h_size repetitions{0};
+  f64 min_ms{0};
+  f64 median_ms{0};
+  f64 mean_ms{0};
+};
+
+/// \brief Runs and collects benchmark cases.
+///
+/// Every case is run once to warm up and then timed for a fixed number of
+/// repetitions. Results are written as JSON or CSV so runs of different
+/// releases can be compared.
+class Suite {
+public:
+  /// \param repetitions Timed runs per case.
+  Suite &setRepetitions(h_size repetitions);
+  /// \param filter Only cases whose name contains filter are run.
+  Suite &setFilter(const std::string &filter);
+
+  /// Times a case.
+  /// \param name Case name.
+  /// \param size Problem size.
+  /// \param f Timed function.
+  /// \param setup Untimed function called before every run of f.
+  void run(const std::string &name, h_size size,
+           const std::function<void()> &f,
+           const std::function<void()> &setup = {});
+  /// \return true if a case of the given name passes the filter.
+  bool enabled(const std::string &name) const;
+
+  const std::vector<Measurement> &measurements() const;
+  void writeJson(std::ostream &os) const;
+  void writeCsv(std::ostream &os) const;
+
+private:
+  std::vector<Measurement> measurements_;
+  std::string filter_;
+  h_size repetitions_{5};
+};
+
+// benchmark groups
+
+void numericBenchmarks(Suite &suite);
+void samplingBenchmarks(Suite &suite);
+void solversBenchmarks(Suite &suite);
+void geoBenchmarks(Suite &suite);
+
+} // namespace naiades::benchmarks
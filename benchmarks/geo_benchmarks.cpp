@@ -0,0 +1,97 @@
+/* Copyright (c) 2026, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/// \file   geo_benchmarks.cpp
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-16
+
+#include "benchmark.h"
+
+#include <naiades/geo/he.h>
+#include <naiades/spatial/morton_tree.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace naiades::benchmarks {
+
+void geoBenchmarks(Suite &suite) {
+  // half-edge construction of a regular quad mesh
+  for (u32 n : {32, 64, 128}) {
+    suite.run("HE2::addCell", n, [&]() {
+      geo::HE2 he;
+      for (h_size j = 0; j <= n; ++j)
+        for (h_size i = 0; i <= n; ++i)
+          he.addVertex({static_cast<f32>(i), static_cast<f32>(j)});
+      for (h_size j = 0; j < n; ++j)
+        for (h_size i = 0; i < n; ++i) {
+          h_index v = j * (n + 1) + i;
+          he.addCell({v, v + 1, v + n + 2, v + n + 1});
+        }
+    });
+  }
+  for (u32 n : {32, 64, 128, 512}) {
+    std::vector<hermes::geo::point2> vertices;
+    for (h_size j = 0; j <= n; ++j)
+      for (h_size i = 0; i <= n; ++i)
+        vertices.emplace_back(static_cast<f32>(i), static_cast<f32>(j));
+    std::vector<h_index> offsets = {0};
+    std::vector<h_index> cells;
+    for (h_size j = 0; j < n; ++j)
+      for (h_size i = 0; i < n; ++i) {
+        h_index v = j * (n + 1) + i;
+        cells.insert(cells.end(), {v, v + 1, v + n + 2, v + n + 1});
+        offsets.emplace_back(cells.size());
+      }
+    suite.run("HE2::fromArrays", n, [&]() {
+      auto he = geo::HE2::fromArrays(vertices, offsets, cells);
+      HERMES_ASSERT(he);
+    });
+  }
+
+  // adaptive refinement around a circle
+  for (h_size max_level : {8, 11, 14}) {
+    auto mt = *spatial::MortonTree2::fromMaxLevel(max_level);
+    const f32 c = 0.5f * mt.resolution();
+    const f32 r = 0.25f * mt.resolution();
+    auto predicate = [&](const spatial::MortonTree2::PredicateData &data) {
+      auto lower = data.bounds.lower();
+      auto upper = data.bounds.upper();
+      // distances from the circle center to the nearest and farthest points
+      // of the cell
+      f32 near2 = 0.f, far2 = 0.f;
+      for (auto [l, u] : {std::pair<f32, f32>(lower.i, upper.i),
+                          std::pair<f32, f32>(lower.j, upper.j)}) {
+        f32 d = std::max({l - c, 0.f, c - u});
+        f32 f = std::max(std::abs(l - c), std::abs(u - c));
+        near2 += d * d;
+        far2 += f * f;
+      }
+      return near2 <= r * r && r * r <= far2;
+    };
+    suite.run(
+        "MortonTree2::refine", mt.resolution(),
+        [&]() { mt.refine(predicate); }, [&]() { mt.reset(); });
+  }
+}
+
+} // namespace naiades::benchmarks
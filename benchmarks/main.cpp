@@ -0,0 +1,86 @@
+/* Copyright (c) 2026, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/// \file   main.cpp
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-16
+/// \brief  Benchmark suite entry point.
+///
+/// usage: naiades_benchmarks [--format json|csv] [--output file]
+///                           [--repetitions n] [--threads n] [--filter name]
+
+#include "benchmark.h"
+
+#include <naiades/base/parallel.h>
+
+#include <fstream>
+#include <iostream>
+
+namespace nb = naiades::benchmarks;
+
+int main(int argc, char **argv) {
+  std::string format = "json";
+  std::string output;
+  nb::Suite suite;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string arg = argv[i];
+    std::string value = argv[i + 1];
+    if (arg == "--format")
+      format = value;
+    else if (arg == "--output")
+      output = value;
+    else if (arg == "--repetitions")
+      suite.setRepetitions(std::stoul(value));
+    else if (arg == "--threads")
+      naiades::ThreadPool::setThreadCount(std::stoul(value));
+    else if (arg == "--filter")
+      suite.setFilter(value);
+    else {
+      std::cerr << "unknown option " << arg << std::endl;
+      return 1;
+    }
+  }
+  if (format != "json" && format != "csv") {
+    std::cerr << "unknown format " << format << std::endl;
+    return 1;
+  }
+
+  nb::numericBenchmarks(suite);
+  nb::samplingBenchmarks(suite);
+  nb::solversBenchmarks(suite);
+  nb::geoBenchmarks(suite);
+
+  std::ofstream file;
+  if (!output.empty()) {
+    file.open(output);
+    if (!file) {
+      std::cerr << "could not open " << output << std::endl;
+      return 1;
+    }
+  }
+  std::ostream &os = output.empty() ? std::cout : file;
+  if (format == "json")
+    suite.writeJson(os);
+  else
+    suite.writeCsv(os);
+  return 0;
+}
@@ -0,0 +1,242 @@
+/* Copyright (c) 2026, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/// \file   numeric_benchmarks.cpp
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-16
+
+#include "benchmark.h"
+
+#include <naiades/geo/grid.h>
+#include <naiades/numeric/boundary_conditions.h>
+#include <naiades/numeric/fast_poisson.h>
+#include <naiades/numeric/linear_solvers.h>
+#include <naiades/numeric/preconditioners.h>
+
+#include <algorithm>
+#include <string>
+
+namespace naiades::benchmarks {
+
+namespace {
+
+/// Unit square Poisson problem with zero Dirichlet boundaries.
+struct Poisson {
+  /// \param n Resolution along x.
+  /// \param aspect Cell aspect ratio (dy / dx), stretched cells slow down
+  ///               simple iterative solvers.
+  explicit Poisson(u32 n, u32 aspect = 1) {
+    fd = *numeric::Grid2FD::Config()
+              .setDomain(hermes::geo::bounds::bbox2::unit())
+              .setResolution({n, std::max<u32>(n / aspect, 1)})
+              .build();
+    fd.addFields<f32>({u.symbol, f.symbol});
+    fd.addBoundary(u.boundary_symbol,
+                   fd.mesh().boundaryIndices(u.boundary_symbol.loc));
+    fd.setBoundaryCondition(u.boundary_symbol, 0,
+                            numeric::bc::Dirichlet::Ptr::shared(0));
+    fd.resolveBoundaries();
+    auto x = fd.mesh().x(core::Element::cell());
+    auto y = fd.mesh().y(core::Element::cell());
+    auto f_field = *fd.getField<f32>(f.symbol);
+    f_field = 2.f * hermes::math::constants::pi * hermes::math::constants::pi *
+              numeric::sin(hermes::math::constants::pi * x) *
+              numeric::sin(hermes::math::constants::pi * y);
+  }
+
+  numeric::Grid2FD fd;
+  core::DiscreteSymbol f = core::DiscreteSymbol::cell("f");
+  core::DiscreteSymbol u = core::DiscreteSymbol::cell("u");
+};
+
+} // namespace
+
+void numericBenchmarks(Suite &suite) {
+  for (u32 n : {64, 128, 256, 512}) {
+    if (!suite.enabled("Grid2FD::L") && !suite.enabled("Boundary::resolve"))
+      break;
+    Poisson problem(n);
+    numeric::DiscreteExpression L;
+    suite.run("Grid2FD::L", n, [&]() { L = problem.fd.L(problem.u); });
+    suite.run("Boundary::resolve", n,
+              [&]() { problem.fd.resolveBoundaries(); });
+  }
+  for (u32 n : {64, 256, 1024}) {
+    if (!suite.enabled("Boundary::stencil"))
+      break;
+    Poisson problem(n);
+    auto &fd = problem.fd;
+    const auto &sym = problem.u.boundary_symbol;
+    // one region per 8 boundary faces, as with many inflow patches
+    auto faces = fd.mesh().boundaryIndices(sym.loc);
+    fd.boundary(sym) = numeric::Boundary();
+    for (h_size i = 0; i < faces.size(); i += 8) {
+      h_size region = 0;
+      fd.addBoundary(sym,
+                     {faces.begin() + i,
+                      faces.begin() + std::min<h_size>(i + 8, faces.size())},
+                     &region);
+      fd.setBoundaryCondition(sym, region,
+                              numeric::bc::Dirichlet::Ptr::shared(0));
+    }
+    fd.resolveBoundaries();
+    const auto &boundary = fd.boundary(sym);
+    real_t sum = 0;
+    suite.run("Boundary::stencil", n, [&]() {
+      for (auto face : faces)
+        sum += boundary.stencil(core::Index::global(face)).constant();
+    });
+    numeric::DiscreteExpression L;
+    suite.run("Boundary::stencil Grid2FD::L", n,
+              [&]() { L = fd.L(problem.u); });
+  }
+  for (u32 n : {128, 512, 2048}) {
+    if (!suite.enabled("DiscreteExpression::"))
+      break;
+    Poisson problem(n);
+    auto L = problem.fd.L(problem.u);
+    auto u_field = *problem.fd.getField<f32>(problem.u.symbol);
+    auto f_field = *problem.fd.getField<f32>(problem.f.symbol);
+    suite.run("DiscreteExpression::rows", n, [&]() {
+      for (auto row : L)
+        f_field[row.centerIndex()] = row(u_field);
+    });
+    suite.run("DiscreteExpression::apply", n,
+              [&]() { L.apply(u_field, f_field); });
+    suite.run("DiscreteExpression::axpy", n,
+              [&]() { L.axpy(0.5f, u_field, f_field); });
+  }
+  for (u32 n : {128, 512, 2048}) {
+    if (!suite.enabled("Grid2FD::evaluate"))
+      break;
+    Poisson problem(n);
+    auto u_field = *problem.fd.getField<f32>(problem.u.symbol);
+    auto f_field = *problem.fd.getField<f32>(problem.f.symbol);
+    suite.run("Grid2FD::evaluateLaplacian", n, [&]() {
+      problem.fd.evaluateLaplacian(problem.u, u_field, f_field);
+    });
+    suite.run("Grid2FD::evaluateLaplacian order 4", n, [&]() {
+      problem.fd.evaluateLaplacian(problem.u, u_field, f_field, 4);
+    });
+    suite.run("Grid2FD::evaluateDerivative xy", n, [&]() {
+      problem.fd.evaluateDerivative(numeric::derivative_bits::xy, problem.u,
+                                    u_field, f_field);
+    });
+  }
+  for (u32 n : {32, 64, 128}) {
+    if (!suite.enabled("CG::"))
+      break;
+    Poisson problem(n);
+    auto lhs = -problem.fd.L(problem.u);
+    numeric::solvers::CG cg;
+    cg.setUnknown(problem.u);
+    suite.run("CG::build", n, [&]() { cg.build(lhs, problem.f); });
+    auto u_field = *problem.fd.getField<f32>(problem.u.symbol);
+    auto f_field = *problem.fd.getField<f32>(problem.f.symbol);
+    suite.run(
+        "CG::solve", n, [&]() { cg.solve(u_field, {f_field}); },
+        [&]() { u_field = 0.f; });
+    // next time step: a nearby right-hand side, starting from the previous
+    // solution
+    std::vector<real_t> previous(u_field.size()), next(f_field.size());
+    cg.solve(u_field, {f_field});
+    std::copy(u_field.begin(), u_field.end(), previous.begin());
+    for (h_size i = 0; i < next.size(); ++i)
+      next[i] = 1.01f * f_field[i];
+    core::FieldCRef<real_t> next_field(next.data(), next.size());
+    cg.setWarmStart(true);
+    suite.run(
+        "CG::solve warm", n, [&]() { cg.solve(u_field, {next_field}); },
+        [&]() {
+          std::copy(previous.begin(), previous.end(), u_field.begin());
+        });
+    cg.setWarmStart(false);
+    // four right-hand sides sharing the operator, one by one and batched
+    std::vector<std::vector<real_t>> storage(4, std::vector<real_t>(n * n));
+    std::vector<core::FieldRef<real_t>> unknowns;
+    std::vector<core::FieldCRef<real_t>> sources(4, f_field);
+    for (auto &s : storage)
+      unknowns.emplace_back(s.data(), s.size());
+    suite.run("CG::solve x4", n, [&]() {
+      for (h_size k = 0; k < 4; ++k)
+        cg.solve(unknowns[k], {sources[k]});
+    });
+    suite.run("CG::solve batched x4", n,
+              [&]() { cg.solve(unknowns, sources); });
+  }
+  for (u32 n : {32, 64, 128}) {
+    if (!suite.enabled("PCG::"))
+      break;
+    Poisson problem(n, 8);
+    auto lhs = -problem.fd.L(problem.u);
+    auto u_field = *problem.fd.getField<f32>(problem.u.symbol);
+    auto f_field = *problem.fd.getField<f32>(problem.f.symbol);
+    auto run = [&](auto &cg) {
+      const auto name = std::string("PCG::") +
+                        std::string(cg.preconditionerName()) + "::";
+      cg.setUnknown(problem.u);
+      suite.run(name + "build", n, [&]() { cg.build(lhs, problem.f); });
+      suite.run(
+          name + "solve", n, [&]() { cg.solve(u_field, {f_field}); },
+          [&]() { u_field = 0.f; });
+    };
+    numeric::solvers::CG jacobi;
+    run(jacobi);
+    numeric::solvers::ICCG ic0;
+    run(ic0);
+    numeric::solvers::SSORCG ssor;
+    run(ssor);
+    numeric::solvers::BlockJacobiCG block_jacobi;
+    block_jacobi.preconditioner().setBlockSize(n);
+    run(block_jacobi);
+  }
+  for (u32 n : {32, 64, 128, 256}) {
+    if (!suite.enabled("LDLT::"))
+      break;
+    Poisson problem(n);
+    auto lhs = -problem.fd.L(problem.u);
+    numeric::solvers::LDLT ldlt;
+    ldlt.setUnknown(problem.u).setKeepPattern(false);
+    suite.run("LDLT::build", n, [&]() { ldlt.build(lhs, problem.f); });
+    ldlt.setKeepPattern(true);
+    suite.run("LDLT::refactor", n, [&]() { ldlt.build(lhs, problem.f); });
+    auto u_field = *problem.fd.getField<f32>(problem.u.symbol);
+    auto f_field = *problem.fd.getField<f32>(problem.f.symbol);
+    suite.run("LDLT::solve", n, [&]() { ldlt.solve(u_field, {f_field}); });
+  }
+  for (u32 n : {64, 128, 256, 512}) {
+    if (!suite.enabled("FastPoisson::"))
+      break;
+    Poisson problem(n);
+    auto config = numeric::solvers::FastPoisson::Config()
+                      .setDiscretization(problem.fd)
+                      .setSymbol(problem.u);
+    suite.run("FastPoisson::build", n, [&]() { config.build(); });
+    auto poisson = config.build().value();
+    auto u_field = *problem.fd.getField<f32>(problem.u.symbol);
+    auto f_field = *problem.fd.getField<f32>(problem.f.symbol);
+    suite.run("FastPoisson::solve", n,
+              [&]() { poisson.solve(u_field, {f_field}); });
+  }
+}
+
+} // namespace naiades::benchmarks
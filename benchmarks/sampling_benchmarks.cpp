@@ -0,0 +1,92 @@
+/* Copyright (c) 2026, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/// \file   sampling_benchmarks.cpp
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-16
+
+#include "benchmark.h"
+
+#include <naiades/sampling/sampler.h>
+#include <naiades/sampling/stencil.h>
+
+#include <random>
+
+namespace naiades::benchmarks {
+
+void samplingBenchmarks(Suite &suite) {
+  const std::pair<core::Element::Type, std::string> elements[] = {
+      {core::Element::Type::CELL, "cell"},
+      {core::Element::Type::VERTEX, "vertex"},
+      {core::Element::Type::U_FACE, "u_face"},
+      {core::Element::Type::V_FACE, "v_face"}};
+
+  for (u32 n : {256, 1024}) {
+    auto grid = *geo::Grid2::Config()
+                     .setCellSize(1.f / n)
+                     .setResolution({n, n})
+                     .build();
+    core::FieldSet fields;
+    for (const auto &[type, name] : elements)
+      fields.add<f32>(type, grid.elementIndexOffset(type), {name});
+    fields.setElementCountFrom(&grid);
+    for (const auto &[type, name] : elements)
+      *fields.get<f32>(name) = 1.f;
+
+    // staggered/collocated conversions
+    for (const auto &[src_type, src_name] : elements)
+      for (const auto &[dst_type, dst_name] : elements) {
+        auto src = *fields.get<f32>(src_name);
+        auto dst = *fields.get<f32>(dst_name);
+        core::FieldCRef<f32> csrc = src;
+        suite.run("sampling::sample/" + src_name + "->" + dst_name, n,
+                  [&]() { sampling::sample(grid, csrc, dst); });
+      }
+
+    // scattered positions
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<f32> d(0.f, 1.f);
+    std::vector<hermes::geo::point2> positions(n * n);
+    std::vector<f32> xs(n * n), ys(n * n);
+    for (h_size i = 0; i < positions.size(); ++i) {
+      xs[i] = d(rng);
+      ys[i] = d(rng);
+      positions[i] = {xs[i], ys[i]};
+    }
+    auto cell = core::FieldCRef<f32>(*fields.get<f32>("cell"));
+    volatile f32 sink = 0.f;
+    suite.run("sampling::bilinear", n * n, [&]() {
+      f32 s = 0.f;
+      for (const auto &p : positions)
+        s += sampling::bilinear(grid, cell.element(), p).evaluate(cell);
+      sink = s;
+    });
+    sampling::BilinearStencils stencils;
+    suite.run("sampling::bilinear/batch", n * n, [&]() {
+      sampling::bilinear(grid, cell.element(), xs, ys, stencils);
+    });
+    suite.run("sampling::sample/positions", n * n,
+              [&]() { sampling::sample(grid, cell, positions); });
+  }
+}
+
+} // namespace naiades::benchmarks
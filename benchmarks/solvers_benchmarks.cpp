@@ -0,0 +1,92 @@
+/* Copyright (c) 2026, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/// \file   solvers_benchmarks.cpp
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-16
+
+#include "benchmark.h"
+
+#include <naiades/solvers/convection.h>
+#include <naiades/solvers/semi_lagrangian.h>
+
+namespace naiades::benchmarks {
+
+void solversBenchmarks(Suite &suite) {
+  for (u32 n : {256, 1024}) {
+    auto grid = *geo::Grid2::Config()
+                     .setCellSize(1.f / n)
+                     .setResolution({n, n})
+                     .build();
+    core::FieldSet fields;
+    fields.add<f32>(core::Element::Type::CELL, 0, {"cu", "cv", "a", "b"});
+    fields.add<f32>(core::Element::Type::U_FACE,
+                    grid.elementIndexOffset(core::Element::Type::U_FACE),
+                    {"u"});
+    fields.add<f32>(core::Element::Type::V_FACE,
+                    grid.elementIndexOffset(core::Element::Type::V_FACE),
+                    {"v"});
+    fields.setElementCountFrom(&grid);
+    core::FieldCRef<f32> cu = *fields.get<f32>("cu");
+    core::FieldCRef<f32> cv = *fields.get<f32>("cv");
+    core::FieldCRef<f32> u = *fields.get<f32>("u");
+    core::FieldCRef<f32> v = *fields.get<f32>("v");
+    core::FieldCRef<f32> a = *fields.get<f32>("a");
+    auto b = *fields.get<f32>("b");
+    *fields.get<f32>("cu") = 0.5f;
+    *fields.get<f32>("cv") = 0.25f;
+    *fields.get<f32>("u") = 0.5f;
+    *fields.get<f32>("v") = 0.25f;
+    *fields.get<f32>("a") = 1.f;
+    const f32 dt = 1.f / n;
+
+    std::function<f32(const geo::Grid2 &, const core::FieldCRef<f32> &,
+                      const hermes::geo::point2 &)>
+        bilinear = [](const geo::Grid2 &grid,
+                      const core::FieldCRef<f32> &field,
+                      const hermes::geo::point2 &p) -> f32 {
+      return sampling::bilinear(grid, field.element(), p).evaluate(field);
+    };
+    suite.run("solvers::advect", n, [&]() {
+      solvers::advect<f32>(grid, cu, cv, bilinear, dt, a, b);
+    });
+
+    solvers::SemiLagrangian<f32> advection;
+    suite.run("SemiLagrangian::advect/euler", n, [&]() {
+      advection.setIntegrator(solvers::Integrator::EULER)
+          .setCorrection(solvers::AdvectionCorrection::NONE)
+          .advect(grid, u, v, dt, a, b);
+    });
+    suite.run("SemiLagrangian::advect/rk3", n, [&]() {
+      advection.setIntegrator(solvers::Integrator::RK3)
+          .setCorrection(solvers::AdvectionCorrection::NONE)
+          .advect(grid, u, v, dt, a, b);
+    });
+    suite.run("SemiLagrangian::advect/rk2+bfecc+cubic", n, [&]() {
+      advection.setIntegrator(solvers::Integrator::RK2)
+          .setCorrection(solvers::AdvectionCorrection::BFECC)
+          .advect<sampling::CubicSampler>(grid, u, v, dt, a, b);
+    });
+  }
+}
+
+} // namespace naiades::benchmarks
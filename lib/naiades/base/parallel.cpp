@@ -0,0 +1,157 @@
+/* Copyright (c) 2026, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/// \file   parallel.cpp
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-16
+
+#include <naiades/base/parallel.h>
+
+#include <cstdlib>
+#include <memory>
+
+namespace naiades {
+
+namespace {
+
+thread_local bool t_inside_task = false;
+
+std::mutex g_pool_mutex;
+std::unique_ptr<ThreadPool> g_pool;
+h_size g_thread_count = 0;
+
+h_size defaultThreadCount() {
+  if (const char *env = std::getenv("NAIADES_NUM_THREADS")) {
+    auto n = std::strtoul(env, nullptr, 10);
+    if (n > 0)
+      return n;
+    HERMES_WARN("Ignoring invalid NAIADES_NUM_THREADS value '{}'.", env);
+  }
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+} // namespace
+
+ThreadPool &ThreadPool::global() {
+  std::lock_guard<std::mutex> lock(g_pool_mutex);
+  if (!g_pool)
+    g_pool = std::make_unique<ThreadPool>(g_thread_count);
+  return *g_pool;
+}
+
+void ThreadPool::setThreadCount(h_size thread_count) {
+  std::lock_guard<std::mutex> lock(g_pool_mutex);
+  g_thread_count = thread_count;
+  g_pool.reset();
+}
+
+h_size ThreadPool::threadCount() { return global().size(); }
+
+h_size ThreadPool::chunkSize(h_size n, h_size min_chunk_size) {
+  // a few chunks per thread balance uneven iterations
+  const h_size chunk_count = 4 * threadCount();
+  return std::max(std::max<h_size>(min_chunk_size, 1),
+                  (n + chunk_count - 1) / chunk_count);
+}
+
+ThreadPool::ThreadPool(h_size thread_count) {
+  if (!thread_count)
+    thread_count = defaultThreadCount();
+  workers_.reserve(thread_count - 1);
+  for (h_size i = 1; i < thread_count; ++i)
+    workers_.emplace_back([this]() { work(); });
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for (auto &worker : workers_)
+    worker.join();
+}
+
+h_size ThreadPool::size() const { return workers_.size() + 1; }
+
+bool ThreadPool::insideTask() { return t_inside_task; }
+
+void ThreadPool::run(h_size task_count,
+                     const std::function<void(h_size)> &task) {
+  if (workers_.empty() || task_count < 2 || t_inside_task) {
+    for (h_size c = 0; c < task_count; ++c)
+      task(c);
+    return;
+  }
+  std::lock_guard<std::mutex> submit_lock(submit_mutex_);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    task_ = &task;
+    task_count_ = task_count;
+    next_task_ = 0;
+    ++generation_;
+  }
+  wake_.notify_all();
+  execute(task, task_count);
+  // once the caller runs out of chunks, only the chunks taken by workers are
+  // left, and workers that did not join yet must not see this task anymore
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_.wait(lock, [this]() { return active_workers_ == 0; });
+  task_ = nullptr;
+}
+
+void ThreadPool::execute(const std::function<void(h_size)> &task,
+                         h_size task_count) {
+  t_inside_task = true;
+  for (h_size c = next_task_++; c < task_count; c = next_task_++)
+    task(c);
+  t_inside_task = false;
+}
+
+void ThreadPool::work() {
+  u64 generation = 0;
+  while (true) {
+    const std::function<void(h_size)> *task = nullptr;
+    h_size task_count = 0;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      wake_.wait(lock, [&]() {
+        return stop_ || (task_ && generation_ != generation);
+      });
+      if (stop_)
+        return;
+      generation = generation_;
+      task = task_;
+      task_count = task_count_;
+      ++active_workers_;
+    }
+    execute(*task, task_count);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      --active_workers_;
+    }
+    done_.notify_one();
+  }
+}
+
+} // namespace naiades
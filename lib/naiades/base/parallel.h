@@ -0,0 +1,204 @@
+/* Copyright (c) 2026, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/// \file   parallel.h
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-16
+/// \brief  Thread pool and parallel loops.
+
+#pragma once
+
+#include <naiades/base/debug.h>
+
+#include <hermes/base/index.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace naiades {
+
+/// \brief Fixed set of worker threads that execute the chunks of parallel
+///        loops.
+///
+/// A single loop runs at a time. The thread that submits a loop also works on
+/// its chunks and only returns once all chunks are done. Loops started from
+/// inside a chunk (nested loops) run serially in the calling thread.
+///
+/// The global pool is created on first use with the number of threads given
+/// by the NAIADES_NUM_THREADS environment variable, or the hardware
+/// concurrency if not set.
+///
+/// \note Chunks must not throw.
+class ThreadPool {
+public:
+  /// \return The pool used by parallelFor and parallelReduce.
+  static ThreadPool &global();
+  /// Recreates the global pool.
+  /// \param thread_count Number of threads, including the caller thread. A
+  ///        value of 1 runs every loop serially, 0 restores the default.
+  /// \note Must not be called while a parallel loop is running.
+  static void setThreadCount(h_size thread_count);
+  /// \return Number of threads of the global pool.
+  static h_size threadCount();
+  /// \return Chunk size used by loops of n iterations when no grain size is
+  ///         given.
+  /// \param n Loop iteration count.
+  /// \param min_chunk_size Smallest chunk size.
+  static h_size chunkSize(h_size n, h_size min_chunk_size = 1);
+
+  /// \param thread_count Number of threads (0 selects the default).
+  explicit ThreadPool(h_size thread_count = 0);
+  ~ThreadPool();
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /// \return Number of threads, including the caller thread.
+  h_size size() const;
+  /// Calls task(c) for every c in [0, task_count) and waits for all of them.
+  void run(h_size task_count, const std::function<void(h_size)> &task);
+  /// \return True if called from a chunk of a running loop.
+  static bool insideTask();
+
+private:
+  void work();
+  void execute(const std::function<void(h_size)> &task, h_size task_count);
+
+  std::vector<std::thread> workers_;
+  std::mutex submit_mutex_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  const std::function<void(h_size)> *task_{nullptr};
+  h_size task_count_{0};
+  std::atomic<h_size> next_task_{0};
+  h_size active_workers_{0};
+  u64 generation_{0};
+  bool stop_{false};
+};
+
+/// Calls f(i) for every i in [first, last), split in chunks across the
+/// threads of the global pool.
+/// \param grain_size Number of iterations per chunk (0 selects automatically).
+/// \note f is called concurrently and must only write to data owned by i.
+template <typename F>
+void parallelFor(h_size first, h_size last, F &&f, h_size grain_size = 0) {
+  if (last <= first)
+    return;
+  const h_size n = last - first;
+  const h_size chunk = grain_size ? grain_size : ThreadPool::chunkSize(n);
+  const h_size chunk_count = (n + chunk - 1) / chunk;
+  if (chunk_count < 2 || ThreadPool::insideTask()) {
+    for (h_index i = first; i < last; ++i)
+      f(i);
+    return;
+  }
+  ThreadPool::global().run(chunk_count, [&](h_size c) {
+    const h_size b = first + c * chunk;
+    const h_size e = std::min(b + chunk, last);
+    for (h_index i = b; i < e; ++i)
+      f(i);
+  });
+}
+
+/// Calls f(ij) for every index of the range. Chunks are made of whole rows.
+/// \param grain_size Number of rows per chunk (0 selects automatically).
+template <typename F>
+void parallelFor(const hermes::range2 &range, F &&f, h_size grain_size = 0) {
+  const auto lower = range.lower();
+  const auto upper = range.upper();
+  if (upper.i <= lower.i || upper.j <= lower.j)
+    return;
+  const h_size rows = upper.j - lower.j;
+  const h_size row_size = upper.i - lower.i;
+  const h_size chunk =
+      grain_size ? grain_size
+                 : std::max<h_size>(1, ThreadPool::chunkSize(rows * row_size) /
+                                           row_size);
+  parallelFor(
+      0, (rows + chunk - 1) / chunk,
+      [&](h_index c) {
+        const h_size end = std::min((c + 1) * chunk, rows);
+        for (h_index row = c * chunk; row < end; ++row)
+          for (auto i = lower.i; i < upper.i; ++i)
+            f(hermes::index2(i, lower.j + static_cast<i32>(row)));
+      },
+      1);
+}
+
+/// Reduces f(i) over [first, last) with the given operation.
+/// \note Partial results are combined in chunk order, so the result only
+///       depends on the chunk size.
+/// \param identity Neutral element of reduce.
+/// \param f Maps an index into a value.
+/// \param reduce Combines two values.
+/// \param grain_size Number of iterations per chunk (0 selects automatically).
+template <typename T, typename F, typename R>
+T parallelReduce(h_size first, h_size last, const T &identity, F &&f,
+                 R &&reduce, h_size grain_size = 0) {
+  if (last <= first)
+    return identity;
+  const h_size n = last - first;
+  const h_size chunk = grain_size ? grain_size : ThreadPool::chunkSize(n);
+  const h_size chunk_count = (n + chunk - 1) / chunk;
+  std::vector<T> partials(chunk_count, identity);
+  parallelFor(
+      0, chunk_count,
+      [&](h_index c) {
+        const h_size b = first + c * chunk;
+        const h_size e = std::min(b + chunk, last);
+        T value = identity;
+        for (h_index i = b; i < e; ++i)
+          value = reduce(value, f(i));
+        partials[c] = value;
+      },
+      1);
+  T value = identity;
+  for (const auto &partial : partials)
+    value = reduce(value, partial);
+  return value;
+}
+
+/// Reduces f(ij) over the range (see parallelReduce).
+template <typename T, typename F, typename R>
+T parallelReduce(const hermes::range2 &range, const T &identity, F &&f,
+                 R &&reduce, h_size grain_size = 0) {
+  const auto lower = range.lower();
+  const auto upper = range.upper();
+  if (upper.i <= lower.i || upper.j <= lower.j)
+    return identity;
+  const h_size row_size = upper.i - lower.i;
+  return parallelReduce(
+      0, (upper.j - lower.j) * row_size, identity,
+      [&](h_index k) {
+        return f(hermes::index2(lower.i + static_cast<i32>(k % row_size),
+                                lower.j + static_cast<i32>(k / row_size)));
+      },
+      reduce, grain_size);
+}
+
+} // namespace naiades
@@ -0,0 +1,121 @@
+/* Copyright (c) 2026, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/// \file   connectivity.cpp
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-16
+
+#include <naiades/core/connectivity.h>
+
+namespace naiades::core {
+
+Adjacency
+Adjacency::fromLists(const std::vector<std::vector<h_size>> &rows) {
+  Adjacency adjacency;
+  adjacency.offsets_.reserve(rows.size() + 1);
+  for (const auto &row : rows) {
+    adjacency.indices_.insert(adjacency.indices_.end(), row.begin(),
+                              row.end());
+    adjacency.offsets_.emplace_back(adjacency.indices_.size());
+  }
+  return adjacency;
+}
+
+Adjacency Adjacency::fromRows(
+    h_size row_count,
+    const std::function<void(h_index, std::vector<h_size> &)> &row) {
+  Adjacency adjacency;
+  adjacency.offsets_.reserve(row_count + 1);
+  for (h_index i = 0; i < row_count; ++i) {
+    row(i, adjacency.indices_);
+    adjacency.offsets_.emplace_back(adjacency.indices_.size());
+  }
+  return adjacency;
+}
+
+Adjacency::Adjacency() noexcept : offsets_{0} {}
+
+Adjacency Adjacency::transposed(h_size column_count) const {
+  Adjacency t;
+  // count entries per column, then scan into offsets
+  t.offsets_.assign(column_count + 1, 0);
+  for (auto j : indices_) {
+    HERMES_ASSERT(j < column_count);
+    ++t.offsets_[j + 1];
+  }
+  for (h_index j = 0; j < column_count; ++j)
+    t.offsets_[j + 1] += t.offsets_[j];
+  // scatter rows in increasing order so transposed rows come out sorted
+  t.indices_.resize(indices_.size());
+  std::vector<h_size> cursor(t.offsets_.begin(), t.offsets_.end() - 1);
+  for (h_index i = 0; i < size(); ++i)
+    for (auto j : (*this)[i])
+      t.indices_[cursor[j]++] = i;
+  return t;
+}
+
+h_size Adjacency::size() const { return offsets_.size() - 1; }
+
+h_size Adjacency::nnz() const { return indices_.size(); }
+
+std::span<const h_size> Adjacency::operator[](h_index row) const {
+  HERMES_ASSERT(row + 1 < offsets_.size());
+  return std::span<const h_size>(indices_.data() + offsets_[row],
+                                 offsets_[row + 1] - offsets_[row]);
+}
+
+std::span<const h_size> Adjacency::offsets() const { return offsets_; }
+
+std::span<const h_size> Adjacency::indices() const { return indices_; }
+
+ConnectivityCache::ConnectivityCache(const ConnectivityCache &) noexcept {}
+
+ConnectivityCache &
+ConnectivityCache::operator=(const ConnectivityCache &) noexcept {
+  clear();
+  return *this;
+}
+
+const Adjacency &
+ConnectivityCache::get(Table table,
+                       const std::function<Adjacency()> &build) const {
+  const auto t = static_cast<h_size>(table);
+  HERMES_ASSERT(t < table_count_);
+  if (built_[t].load(std::memory_order_acquire))
+    return tables_[t];
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  if (!built_[t].load(std::memory_order_relaxed)) {
+    tables_[t] = build();
+    built_[t].store(true, std::memory_order_release);
+  }
+  return tables_[t];
+}
+
+void ConnectivityCache::clear() {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  for (h_size t = 0; t < table_count_; ++t) {
+    built_[t].store(false, std::memory_order_relaxed);
+    tables_[t] = Adjacency();
+  }
+}
+
+} // namespace naiades::core
@@ -0,0 +1,115 @@
+/* Copyright (c) 2026, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/// \file   connectivity.h
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-16
+/// \brief  Compressed connectivity tables.
+
+#pragma once
+
+#include <naiades/base/result.h>
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace naiades::core {
+
+/// \brief Adjacency list stored in compressed sparse row (CSR) layout.
+/// The neighbours of row i are stored contiguously in
+/// indices()[offsets()[i], offsets()[i + 1]).
+class Adjacency {
+public:
+  /// \brief Build a table from a list of rows.
+  /// \param rows
+  static Adjacency fromLists(const std::vector<std::vector<h_size>> &rows);
+  /// \brief Build a table by filling each row through a callback.
+  /// \param row_count Number of rows.
+  /// \param row Called as row(i, out) and pushes the indices of row i into out.
+  static Adjacency
+  fromRows(h_size row_count,
+           const std::function<void(h_index, std::vector<h_size> &)> &row);
+
+  Adjacency() noexcept;
+
+  /// \brief Compute the inverse relation.
+  /// \note Rows of the result are sorted by the index of the original row.
+  /// \param column_count Number of rows of the transposed table.
+  Adjacency transposed(h_size column_count) const;
+
+  /// \return Number of rows.
+  h_size size() const;
+  /// \return Total number of stored indices.
+  h_size nnz() const;
+  /// \param row
+  /// \return The indices of the given row.
+  std::span<const h_size> operator[](h_index row) const;
+  std::span<const h_size> offsets() const;
+  std::span<const h_size> indices() const;
+
+private:
+  std::vector<h_size> offsets_;
+  std::vector<h_size> indices_;
+};
+
+/// \brief Lazily built connectivity tables of a topology.
+/// Tables are built once on first access and shared by all subsequent
+/// queries. Concurrent reads are safe; clear() must not race with readers.
+/// \note Copies start empty, tables are rebuilt for the copied topology.
+class ConnectivityCache {
+public:
+  enum class Table : u8 {
+    CELL_VERTEX,
+    CELL_FACE,
+    FACE_VERTEX,
+    FACE_CELL,
+    VERTEX_CELL,
+    CELL_CELL,
+    COUNT
+  };
+
+  ConnectivityCache() noexcept = default;
+  ConnectivityCache(const ConnectivityCache &) noexcept;
+  ConnectivityCache &operator=(const ConnectivityCache &) noexcept;
+
+  /// \brief Get a table, building it if necessary.
+  /// \param table
+  /// \param build Called once to build the table when it is not cached yet.
+  ///              It may query other tables of the same cache.
+  const Adjacency &get(Table table,
+                       const std::function<Adjacency()> &build) const;
+  /// \brief Drop all cached tables.
+  void clear();
+
+private:
+  static constexpr h_size table_count_ = static_cast<h_size>(Table::COUNT);
+
+  mutable std::recursive_mutex mutex_;
+  mutable std::array<std::atomic<bool>, table_count_> built_{};
+  mutable std::array<Adjacency, table_count_> tables_;
+};
+
+} // namespace naiades::core
@@ -28,25 +28,13 @@
 
 #include <naiades/base/debug.h>
 
-namespace naiades::core {
+#include <algorithm>
+#include <cstring>
+#include <utility>
 
-numeric::Scalar operator-(const FieldRef<real_t> &field,
-                          const numeric::Scalar &s) {
-  HERMES_ASSERT(s.size() == field.size());
-  numeric::Scalar r(s.size());
-  for (h_index i = 0; i < s.size(); ++i)
-    r[i] = field[i] - s[i];
-  return r;
-}
+namespace naiades::core {
 
-numeric::Scalar operator-(const numeric::Scalar &s,
-                          const FieldRef<real_t> &field) {
-  HERMES_ASSERT(s.size() == field.size());
-  numeric::Scalar r = s;
-  for (h_index i = 0; i < s.size(); ++i)
-    r[i] -= field[i];
-  return r;
-}
+FieldGroup::FieldGroup(FieldStorage storage) : storage_{storage} {}
 
 void FieldGroup::setElement(Element loc) { element_ = loc; }
 
@@ -56,6 +44,68 @@ Element FieldGroup::element() const { return element_; }
 
 h_size FieldGroup::indexOffset() const { return index_offset_; }
 
+FieldStorage FieldGroup::storage() const { return storage_; }
+
+HeError FieldGroup::resize(h_size size) {
+  if (storage_ == FieldStorage::AOS)
+    return aos_.resize(size);
+  // each sub-field array starts at a multiple of soa_alignment
+  std::vector<h_size> offsets(field_sizes_.size());
+  h_size total = 0;
+  for (h_size f = 0; f < field_sizes_.size(); ++f) {
+    offsets[f] = total;
+    auto bytes = size * field_sizes_[f];
+    total += (bytes + soa_alignment - 1) / soa_alignment * soa_alignment;
+  }
+  std::vector<u8, AlignedAllocator<u8>> data;
+  try {
+    data.resize(total);
+  } catch (const std::bad_alloc &) {
+    return HeError::BadAllocation;
+  }
+  // keep current values
+  u8 *base = data.data();
+  h_size count = std::min(size, soa_size_);
+  for (h_size f = 0; count && f < field_offsets_.size(); ++f)
+    std::memcpy(base + offsets[f], soaPtr(f), count * field_sizes_[f]);
+
+  soa_data_ = std::move(data);
+  field_offsets_ = std::move(offsets);
+  soa_size_ = size;
+  return HeError::None;
+}
+
+h_size FieldGroup::fieldCount() const { return field_sizes_.size(); }
+
+h_size FieldGroup::size() const {
+  if (storage_ == FieldStorage::AOS)
+    return aos_.size();
+  return soa_size_;
+}
+
+u8 *FieldGroup::getPtr(h_size field_index, h_size element_index) {
+  return const_cast<u8 *>(
+      std::as_const(*this).getPtr(field_index, element_index));
+}
+
+const u8 *FieldGroup::getPtr(h_size field_index, h_size element_index) const {
+  if (storage_ == FieldStorage::AOS)
+    return aos_.getPtr(field_index, element_index);
+  const u8 *ptr = soaPtr(field_index);
+  return ptr ? ptr + element_index * field_sizes_[field_index] : nullptr;
+}
+
+u8 *FieldGroup::soaPtr(h_size field_index) {
+  return const_cast<u8 *>(std::as_const(*this).soaPtr(field_index));
+}
+
+const u8 *FieldGroup::soaPtr(h_size field_index) const {
+  if (field_index >= field_offsets_.size())
+    return nullptr;
+  // the storage is allocated aligned, so its copies need no padding
+  return soa_data_.data() + field_offsets_[field_index];
+}
+
 NaResult FieldSet::setElementCount(Element loc, h_size count) {
   for (auto &item : fields_) {
     if (item.second.element() == loc)
@@ -35,6 +35,7 @@
 #include <hermes/geometry/vector.h>
 #include <hermes/storage/aos.h>
 
+#include <new>
 #include <string>
 #include <type_traits>
 #include <unordered_map>
@@ -42,13 +43,91 @@
 
 namespace naiades::core {
 
-template <typename T> class FieldRef : public hermes::mem::AoS::FieldView<T> {
+template <typename T> class FieldRef;
+template <typename T> class FieldCRef;
+
+} // namespace naiades::core
+
+namespace naiades::numeric {
+
+template <typename T>
+struct is_scalar_view<core::FieldRef<T>> : std::is_arithmetic<T> {};
+template <typename T>
+struct is_scalar_view<core::FieldCRef<T>> : std::is_arithmetic<T> {};
+
+} // namespace naiades::numeric
+
+namespace naiades::core {
+
+/// Forward iterator over the values of a strided field view.
+template <typename T> class FieldIterator {
+public:
+  using value_type = std::remove_const_t<T>;
+  using difference_type = std::ptrdiff_t;
+  using reference = T &;
+
+  FieldIterator() = default;
+  FieldIterator(T *ptr, h_size stride)
+      : ptr_{reinterpret_cast<Byte *>(ptr)}, stride_{stride} {}
+
+  T &operator*() const { return *reinterpret_cast<T *>(ptr_); }
+  FieldIterator &operator++() {
+    ptr_ += stride_;
+    return *this;
+  }
+  FieldIterator operator++(int) {
+    auto it = *this;
+    ++(*this);
+    return it;
+  }
+  bool operator==(const FieldIterator &rhs) const { return ptr_ == rhs.ptr_; }
+  bool operator!=(const FieldIterator &rhs) const { return ptr_ != rhs.ptr_; }
+
+private:
+  using Byte = std::conditional_t<std::is_const_v<T>, const u8, u8>;
+
+  Byte *ptr_{nullptr};
+  h_size stride_{0};
+};
+
+/// Strided view over the values of a sub-field of a FieldGroup.
+/// \note Consecutive values are stride() bytes apart. Sub-fields of SOA
+///       field groups are contiguous (stride() == sizeof(T)).
+template <typename T> class FieldRef {
 public:
-  FieldRef(const hermes::mem::AoS::FieldView<T> &field_view)
-      : hermes::mem::AoS::FieldView<T>(field_view) {}
+  FieldRef() = default;
+  /// \param data Address of the first value.
+  /// \param size Number of values.
+  /// \param stride Distance, in bytes, between consecutive values.
+  FieldRef(T *data, h_size size, h_size stride = sizeof(T))
+      : data_{reinterpret_cast<u8 *>(data)}, size_{size}, stride_{stride} {}
 
   Element element() const { return element_; }
   h_size indexOffset() const { return index_offset_; }
+  h_size size() const { return size_; }
+  /// \return Distance, in bytes, between consecutive values.
+  h_size stride() const { return stride_; }
+  /// \return True if values are packed (stride() == sizeof(T)).
+  bool contiguous() const { return stride_ == sizeof(T); }
+  /// \note Only meaningful as an array when contiguous().
+  T *data() { return reinterpret_cast<T *>(data_); }
+  const T *data() const { return reinterpret_cast<const T *>(data_); }
+
+  FieldIterator<T> begin() { return {data(), stride_}; }
+  FieldIterator<T> end() {
+    return {reinterpret_cast<T *>(data_ + size_ * stride_), stride_};
+  }
+  FieldIterator<const T> begin() const { return {data(), stride_}; }
+  FieldIterator<const T> end() const {
+    return {reinterpret_cast<const T *>(data_ + size_ * stride_), stride_};
+  }
+
+  HERMES_CPU_GPU T &operator[](h_index i) {
+    return *reinterpret_cast<T *>(data_ + i * stride_);
+  }
+  HERMES_CPU_GPU const T &operator[](h_index i) const {
+    return *reinterpret_cast<const T *>(data_ + i * stride_);
+  }
 
   FieldRef &operator=(const T &value) {
     auto n = this->size();
@@ -58,12 +137,15 @@ public:
     return *this;
   }
 
-  // template <typename U = T,
-  //           typename = std::enable_if_t<std::is_floating_point_v<U>::value>>
-  FieldRef &operator=(const numeric::Scalar &s) {
-    HERMES_ASSERT(s.size() == (*this).size());
-    for (h_index i = 0; i < s.size(); ++i)
-      (*this)[i] = s[i];
+  /// Evaluates a scalar expression (see numeric::ScalarExpression) into the
+  /// field in a single pass.
+  template <typename E>
+  FieldRef &operator=(const numeric::ScalarExpression<E> &expr) {
+    const E &e = expr.derived();
+    HERMES_ASSERT(e.size() == 0 || e.size() == (*this).size());
+    auto n = this->size();
+    for (h_index i = 0; i < n; ++i)
+      (*this)[i] = static_cast<T>(e[i]);
     return *this;
   }
 
@@ -84,21 +166,47 @@ public:
 private:
   friend class FieldGroup;
 
+  u8 *data_{nullptr};
+  h_size size_{0};
+  h_size stride_{sizeof(T)};
   Element element_;
   h_size index_offset_{0};
 };
 
-template <typename T>
-class FieldCRef : public hermes::mem::AoS::ConstFieldView<T> {
+/// Read-only counterpart of FieldRef.
+template <typename T> class FieldCRef {
 public:
-  FieldCRef(const hermes::mem::AoS::ConstFieldView<T> &field_view)
-      : hermes::mem::AoS::ConstFieldView<T>(field_view) {}
+  FieldCRef() = default;
+  /// \param data Address of the first value.
+  /// \param size Number of values.
+  /// \param stride Distance, in bytes, between consecutive values.
+  FieldCRef(const T *data, h_size size, h_size stride = sizeof(T))
+      : data_{reinterpret_cast<const u8 *>(data)}, size_{size},
+        stride_{stride} {}
   FieldCRef(const FieldRef<T> &field)
-      : hermes::mem::AoS::ConstFieldView<T>(
-            static_cast<hermes::mem::AoS::ConstFieldView<T>>(field)),
-        element_(field.element()), index_offset_(field.indexOffset()) {}
+      : FieldCRef(field.data(), field.size(), field.stride()) {
+    element_ = field.element();
+    index_offset_ = field.indexOffset();
+  }
 
   Element element() const { return element_; }
+  h_size indexOffset() const { return index_offset_; }
+  h_size size() const { return size_; }
+  /// \return Distance, in bytes, between consecutive values.
+  h_size stride() const { return stride_; }
+  /// \return True if values are packed (stride() == sizeof(T)).
+  bool contiguous() const { return stride_ == sizeof(T); }
+  /// \note Only meaningful as an array when contiguous().
+  const T *data() const { return reinterpret_cast<const T *>(data_); }
+
+  FieldIterator<const T> begin() const { return {data(), stride_}; }
+  FieldIterator<const T> end() const {
+    return {reinterpret_cast<const T *>(data_ + size_ * stride_), stride_};
+  }
+
+  HERMES_CPU_GPU const T &operator[](h_index i) const {
+    return *reinterpret_cast<const T *>(data_ + i * stride_);
+  }
 
   HERMES_CPU_GPU const T &at(const Index &i) const {
     if (i.space() == IndexSpace::LOCAL)
@@ -108,7 +216,7 @@ public:
   }
 
   hermes::Interval<T> valueRange() const {
-    auto n = hermes::mem::AoS::ConstFieldView<T>::size_;
+    auto n = size_;
     hermes::Interval<T> interval(0, 0);
     if (n > 0) {
       interval.low = (*this)[0];
@@ -124,27 +232,49 @@ public:
 private:
   friend class FieldGroup;
 
+  const u8 *data_{nullptr};
+  h_size size_{0};
+  h_size stride_{sizeof(T)};
   Element element_;
   h_size index_offset_{0};
 };
 
-numeric::Scalar operator-(const FieldRef<real_t> &field,
-                          const numeric::Scalar &s);
+// Lazy arithmetic between field views and scalar expressions
+// (see numeric::ScalarExpression).
 
-numeric::Scalar operator-(const numeric::Scalar &s,
-                          const FieldRef<real_t> &field);
+using numeric::operator+;
+using numeric::operator-;
+using numeric::operator*;
+using numeric::operator/;
+
+/// Memory layout of the sub-fields of a field group:
+/// - AOS: values of all sub-fields are interleaved per element.
+/// - SOA: each sub-field is stored in its own aligned array.
+enum class FieldStorage : u8 { AOS, SOA };
 
 /// A field group holds one or more sub-fields defined over a single type of
 /// discrete location (ex: vertex and face centers).
-/// \note The values are stored in a single array of structs.
+/// \note By default, the values are stored in a single array of structs.
+///       SOA field groups store each sub-field in its own array, aligned to
+///       soa_alignment bytes, so kernels touching a single sub-field read
+///       contiguous memory.
+/// \note The sub-field layout is kept in a hermes::mem::AoS, which only holds
+///       the values of AOS field groups.
 /// \note Field groups carry an index offset that can be present in certain
 ///       discretizations structures. The index offset transforms the indices
 ///       into global and local indices. For example, the indices of a field
 ///       group of N elements in a given field group of N elements are:
 ///       - local indices:  [0, N)
 ///       - global indices: [offset, N + offset )
-class FieldGroup : public hermes::mem::AoS {
+class FieldGroup {
 public:
+  /// Alignment, in bytes, of each sub-field array in SOA storage.
+  static constexpr h_size soa_alignment = 64;
+
+  FieldGroup() = default;
+  /// \param storage Memory layout of the sub-fields.
+  explicit FieldGroup(FieldStorage storage);
+
   /// \param loc Type of element indexed by this field.
   void setElement(Element loc);
   /// \param o Index offset.
@@ -153,16 +283,53 @@ public:
   Element element() const;
   /// \return The index offset carried by this field group.
   h_size indexOffset() const;
+  /// \return The memory layout of the sub-fields.
+  FieldStorage storage() const;
+
+  /// Appends a sub-field of type T.
+  /// \note Sub-fields must be pushed before resize().
+  /// \return The index of the new sub-field.
+  template <typename T> h_size pushField(const std::string &name = "") {
+    static_assert(alignof(T) <= soa_alignment);
+    aos_.pushField<T>(name);
+    field_sizes_.emplace_back(sizeof(T));
+    return field_sizes_.size() - 1;
+  }
+  /// \return The number of sub-fields.
+  h_size fieldCount() const;
+  /// \param size New number of elements.
+  HeError resize(h_size size);
+  /// \return The number of elements.
+  h_size size() const;
+  /// \return The address of the value of a sub-field at an element.
+  u8 *getPtr(h_size field_index, h_size element_index);
+  const u8 *getPtr(h_size field_index, h_size element_index) const;
 
   template <typename T> FieldRef<T> get(h_size field_index) {
-    FieldRef<T> acc(this->field<T>(field_index));
+    FieldRef<T> acc;
+    if (storage_ == FieldStorage::SOA) {
+      acc = FieldRef<T>(reinterpret_cast<T *>(soaPtr(field_index)),
+                        soa_size_);
+    } else {
+      auto view = aos_.field<T>(field_index);
+      if (view.size())
+        acc = FieldRef<T>(&view[0], view.size(), viewStride(view));
+    }
     acc.element_ = element_;
     acc.index_offset_ = index_offset_;
     return acc;
   }
 
   template <typename T> FieldCRef<T> get(h_size field_index) const {
-    FieldCRef<T> acc(this->field<T>(field_index));
+    FieldCRef<T> acc;
+    if (storage_ == FieldStorage::SOA) {
+      acc = FieldCRef<T>(reinterpret_cast<const T *>(soaPtr(field_index)),
+                         soa_size_);
+    } else {
+      auto view = aos_.field<T>(field_index);
+      if (view.size())
+        acc = FieldCRef<T>(&view[0], view.size(), viewStride(view));
+    }
     acc.element_ = element_;
     acc.index_offset_ = index_offset_;
     return acc;
@@ -171,8 +338,44 @@ public:
 private:
   friend class FieldSet;
 
+  /// Allocates soa_alignment aligned blocks, so copies of the SOA storage
+  /// keep their arrays aligned.
+  template <typename T> struct AlignedAllocator {
+    using value_type = T;
+
+    AlignedAllocator() = default;
+    template <typename U> AlignedAllocator(const AlignedAllocator<U> &) {}
+
+    T *allocate(std::size_t n) {
+      return static_cast<T *>(
+          ::operator new(n * sizeof(T), std::align_val_t(soa_alignment)));
+    }
+    void deallocate(T *p, std::size_t) {
+      ::operator delete(p, std::align_val_t(soa_alignment));
+    }
+    bool operator==(const AlignedAllocator &) const { return true; }
+  };
+
+  /// \return Distance, in bytes, between consecutive values of an AoS view.
+  template <typename View> static h_size viewStride(const View &view) {
+    if (view.size() < 2)
+      return sizeof(std::remove_cvref_t<decltype(view[0])>);
+    return reinterpret_cast<const u8 *>(&view[1]) -
+           reinterpret_cast<const u8 *>(&view[0]);
+  }
+  u8 *soaPtr(h_size field_index);
+  const u8 *soaPtr(h_size field_index) const;
+
   Element element_{Element::Type::NONE};
   h_size index_offset_{0};
+  FieldStorage storage_{FieldStorage::AOS};
+  // sub-field layout, and values of AOS storage
+  hermes::mem::AoS aos_;
+  // SOA storage
+  std::vector<h_size> field_sizes_;
+  std::vector<h_size> field_offsets_;
+  std::vector<u8, AlignedAllocator<u8>> soa_data_;
+  h_size soa_size_{0};
 
 #ifdef NAIADES_INCLUDE_DEBUG_TRAITS
   friend struct hermes::DebugTraits<FieldGroup>;
@@ -254,12 +457,16 @@ template <typename T> struct DebugTraits<naiades::core::FieldRef<T>> {
 template <> struct DebugTraits<naiades::core::FieldGroup> {
   static HERMES_CONST_OR_CONSTEXPR bool is_string_serializable = true;
   static DebugMessage message(const naiades::core::FieldGroup &data) {
-    return DebugMessage()
-        .addTitle("Field Group")
+    auto m = DebugMessage();
+    m.addTitle("Field Group")
         .add("element", data.element_)
         .add("index offset", data.index_offset_)
-        .add("size", data.size())
-        .add("values", hermes::to_string(static_cast<hermes::mem::AoS>(data)));
+        .add("size", data.size());
+    if (data.storage_ == naiades::core::FieldStorage::AOS)
+      m.add("values", hermes::to_string(data.aos_));
+    else
+      m.add("storage", "SOA").addArray("sub-field sizes", data.field_sizes_);
+    return m;
   }
 };
 
@@ -28,6 +28,32 @@
 
 namespace naiades::core {
 
+namespace {
+
+std::optional<ConnectivityCache::Table> connectivityTable(Element element,
+                                                          Element connected) {
+  using Table = ConnectivityCache::Table;
+  if (element.is(element_primitive_bits::cell)) {
+    if (connected.is(element_primitive_bits::vertex))
+      return Table::CELL_VERTEX;
+    if (connected.is(element_primitive_bits::face))
+      return Table::CELL_FACE;
+    if (connected.is(element_primitive_bits::cell))
+      return Table::CELL_CELL;
+  } else if (element.is(element_primitive_bits::face)) {
+    if (connected.is(element_primitive_bits::vertex))
+      return Table::FACE_VERTEX;
+    if (connected.is(element_primitive_bits::cell))
+      return Table::FACE_CELL;
+  } else if (element.is(element_primitive_bits::vertex)) {
+    if (connected.is(element_primitive_bits::cell))
+      return Table::VERTEX_CELL;
+  }
+  return std::nullopt;
+}
+
+} // namespace
+
 std::vector<std::vector<h_size>> Topology::indices(Element loc,
                                                    Element sub_loc) const {
   std::vector<std::vector<h_size>> is;
@@ -39,6 +65,61 @@ std::vector<std::vector<h_size>> Topology::indices(Element loc,
   return is;
 }
 
+const Adjacency &Topology::connectivity(Element element,
+                                       Element connected_element) const {
+  static const Adjacency empty;
+  auto table = connectivityTable(element, connected_element);
+  if (!table) {
+    HERMES_NOT_IMPLEMENTED;
+    return empty;
+  }
+  return connectivity_.get(*table,
+                           [&]() { return buildConnectivity(*table); });
+}
+
+void Topology::invalidateConnectivity() { connectivity_.clear(); }
+
+Adjacency Topology::buildConnectivity(ConnectivityCache::Table table) const {
+  using Table = ConnectivityCache::Table;
+  auto rows = [&](Element loc, Element sub_loc) {
+    const h_size offset = elementIndexOffset(loc);
+    return Adjacency::fromRows(
+        elementCount(loc), [&](h_index i, std::vector<h_size> &row) {
+          auto is = indices(ElementIndex::global(loc, i + offset), sub_loc);
+          row.insert(row.end(), is.begin(), is.end());
+        });
+  };
+  switch (table) {
+  case Table::CELL_VERTEX:
+    return rows(Element::cell(), Element::vertex());
+  case Table::CELL_FACE:
+    return rows(Element::cell(), Element::face());
+  case Table::FACE_VERTEX:
+    return rows(Element::face(), Element::vertex());
+  case Table::FACE_CELL:
+    return connectivity(Element::cell(), Element::face())
+        .transposed(elementCount(Element::face()));
+  case Table::VERTEX_CELL:
+    return connectivity(Element::cell(), Element::vertex())
+        .transposed(elementCount(Element::vertex()));
+  case Table::CELL_CELL: {
+    const auto &cell_faces = connectivity(Element::cell(), Element::face());
+    const auto &face_cells = connectivity(Element::face(), Element::cell());
+    return Adjacency::fromRows(
+        cell_faces.size(), [&](h_index c, std::vector<h_size> &row) {
+          for (auto f : cell_faces[c])
+            for (auto n : face_cells[f])
+              if (n != c)
+                row.emplace_back(n);
+        });
+  }
+  default:
+    break;
+  }
+  HERMES_NOT_IMPLEMENTED;
+  return {};
+}
+
 std::vector<Neighbour> Topology::star(const ElementIndex &iloc,
                                       Element boundary_loc) const {
   return star(iloc, iloc.element, {boundary_loc});
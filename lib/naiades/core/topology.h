@@ -28,6 +28,7 @@
 #pragma once
 
 #include <naiades/base/result.h>
+#include <naiades/core/connectivity.h>
 #include <naiades/core/element.h>
 #include <naiades/core/element_set.h>
 
@@ -70,6 +71,23 @@ public:
   virtual std::vector<h_size> indices(const ElementIndex &iloc,
                                       Element sub_element) const = 0;
 
+  // connectivity
+
+  /// \brief Get the cached connectivity between two element types.
+  /// Supported pairs are cell->vertex, cell->face, face->vertex, face->cell,
+  /// vertex->cell and cell->cell (cells sharing a face). Row i holds the
+  /// global indices of the elements connected to the i-th element.
+  /// \note Tables are built on first use and reused until
+  ///       invalidateConnectivity() is called.
+  /// \param element
+  /// \param connected_element
+  /// \return CSR table of the given relation.
+  const Adjacency &connectivity(Element element,
+                                Element connected_element) const;
+  /// \brief Drop all cached connectivity tables.
+  /// \note Must be called whenever elements are added or removed.
+  void invalidateConnectivity();
+
   // boundary
 
   /// Get the indices of an element type  at the boundary.
@@ -118,6 +136,16 @@ public:
   /// \param interior_loc
   virtual h_size interiorNeighbour(const ElementIndex &boundary_element,
                                    const Element &interior_loc) const = 0;
+
+protected:
+  /// \brief Build a connectivity table.
+  /// The default implementation gathers element rows through indices() and
+  /// derives the remaining relations from them.
+  /// \param table
+  virtual Adjacency buildConnectivity(ConnectivityCache::Table table) const;
+
+private:
+  ConnectivityCache connectivity_;
 };
 
 } // namespace naiades::core
@@ -27,9 +27,12 @@
 #include <naiades/geo/grid.h>
 
 #include <naiades/numeric/boundary.h>
+#include <naiades/numeric/fd_stencil.h>
 
 #include <hermes/math/space_filling.h>
 
+#include <utility>
+
 namespace naiades::geo {
 
 Result<Grid2> Grid2::Config::build() const {
@@ -40,6 +43,7 @@ Result<Grid2> Grid2::Config::build() const {
 }
 
 void Grid2::setSize(const hermes::size2 &size) {
+  invalidateConnectivity();
   resolution_ = size;
   bounds_.upper = bounds_.lower + hermes::geo::vec2(size.width * cell_size_.x,
                                                     size.height * cell_size_.y);
@@ -171,6 +175,16 @@ h_size Grid2::flatIndex(core::Element loc, const hermes::index2 &index) const {
   return elementIndexOffset(loc) + index.j * res.width + index.i;
 }
 
+h_size Grid2::flatIndex(core::Element loc, const hermes::index2 &index,
+                        const GridLayout &layout) const {
+  return elementIndexOffset(loc) + layout.flatIndex(index);
+}
+
+GridLayout Grid2::layout(core::Element loc, GridStorage storage,
+                         u32 tile_size) const {
+  return GridLayout(resolution(loc), storage, tile_size);
+}
+
 core::ElementIndex
 Grid2::computeGlobalIndex(const core::ElementIndex &iloc) const {
   if (iloc.element.is(core::element_primitive_bits::face)) {
@@ -268,7 +282,8 @@ std::vector<h_size> Grid2::indices(const core::ElementIndex &iloc,
 
   std::vector<h_size> is;
   auto ij = index(iloc);
-  const hermes::range2 sub_range(resolution(sub_element));
+  // general faces resolve into their horizontal|vertical types
+  const auto element = computeGlobalIndex(iloc).element;
 
   if (iloc.element == core::Element::CELL) {
     if (sub_element == core::Element::Type::VERTEX) {
@@ -282,26 +297,26 @@ std::vector<h_size> Grid2::indices(const core::ElementIndex &iloc,
       is.emplace_back(
           safeFlatIndex(core::Element::Type::VERTICAL_FACE, ij.plus(0, 0)));
       is.emplace_back(
-          safeFlatIndex(core::Element::Type::HORIZONTAL_FACE, ij.plus(1, 0)));
+          safeFlatIndex(core::Element::Type::HORIZONTAL_FACE, ij.plus(0, 1)));
       is.emplace_back(
-          safeFlatIndex(core::Element::Type::VERTICAL_FACE, ij.plus(0, 1)));
+          safeFlatIndex(core::Element::Type::VERTICAL_FACE, ij.plus(1, 0)));
     } else if (sub_element == core::Element::Type::HORIZONTAL_FACE) {
       is.emplace_back(
           safeFlatIndex(core::Element::Type::HORIZONTAL_FACE, ij.plus(0, 0)));
       is.emplace_back(
-          safeFlatIndex(core::Element::Type::HORIZONTAL_FACE, ij.plus(1, 0)));
+          safeFlatIndex(core::Element::Type::HORIZONTAL_FACE, ij.plus(0, 1)));
     } else if (sub_element == core::Element::Type::VERTICAL_FACE) {
       is.emplace_back(
           safeFlatIndex(core::Element::Type::VERTICAL_FACE, ij.plus(0, 0)));
       is.emplace_back(
-          safeFlatIndex(core::Element::Type::VERTICAL_FACE, ij.plus(0, 1)));
+          safeFlatIndex(core::Element::Type::VERTICAL_FACE, ij.plus(1, 0)));
     } else {
       HERMES_NOT_IMPLEMENTED;
     }
-  } else if (iloc.element == core::Element::Type::HORIZONTAL_FACE) {
+  } else if (element == core::Element::Type::HORIZONTAL_FACE) {
     is.emplace_back(safeFlatIndex(sub_element, ij.plus(0, 0)));
     is.emplace_back(safeFlatIndex(sub_element, ij.plus(1, 0)));
-  } else if (iloc.element == core::Element::Type::VERTICAL_FACE) {
+  } else if (element == core::Element::Type::VERTICAL_FACE) {
     is.emplace_back(safeFlatIndex(sub_element, ij.plus(0, 0)));
     is.emplace_back(safeFlatIndex(sub_element, ij.plus(0, 1)));
   } else {
@@ -510,68 +525,325 @@ Result<Grid2FD> Grid2FD::Config::build() const {
   return Result<Grid2FD>(std::move(grid_fd));
 }
 
-DiscreteOperator Grid2FD::derivative(derivative_bits d, h_size index,
-                                     const core::DiscreteSymbol &sym) const {
-  DiscreteOperator op(index);
-
-  // sanity error checks
-  auto it = boundaries_.find(sym.boundary_symbol);
-  HERMES_ASSERT(it != boundaries_.end() && topology_);
+namespace {
+
+/// State of the operators of a symbol that does not depend on the element.
+struct StencilContext {
+  StencilContext(const geo::Grid2 &mesh, const Boundary &boundary,
+                 const core::DiscreteSymbol &sym)
+      : mesh{mesh}, boundary{boundary}, sym{sym},
+        resolution{mesh.resolution(sym.symbol.loc)} {
+    const auto h = mesh.cellSize();
+    kx = 1 / (h.x * h.x);
+    ky = 1 / (h.y * h.y);
+    // cell neighbours of interior cells follow from the row-major layout
+    cells = sym.symbol.loc.is(core::element_primitive_bits::cell) &&
+            sym.boundary_symbol.loc.is(core::element_primitive_bits::face);
+  }
 
-  // get mesh
-  const geo::Grid2 *mesh = static_cast<const geo::Grid2 *>(topology_.get());
-  // get boundary
-  auto &boundary = it->second;
+  hermes::index2 index(h_size flat_index) const {
+    if (cells)
+      return {static_cast<i32>(flat_index % resolution.width),
+              static_cast<i32>(flat_index / resolution.width)};
+    return mesh.index(core::ElementIndex::global(sym.symbol.loc, flat_index));
+  }
 
-  auto addNeighbour = [&](const core::Neighbour &n, real_t k) {
-    if (n.element_index.element != sym.symbol.loc)
-      op += boundary.stencil(n.element_index.index) * k;
-    else
-      op.add(*n.element_index.index, k);
-  };
-  auto ij = mesh->index(core::ElementIndex::global(sym.symbol.loc, index));
+  const geo::Grid2 &mesh;
+  const Boundary &boundary;
+  const core::DiscreteSymbol &sym;
+  hermes::size2 resolution;
+  real_t kx{0};
+  real_t ky{0};
+  bool cells{false};
+};
+
+/// Adds k times the neighbour of ij in the given orientation to op. Boundary
+/// neighbours are expanded into their boundary stencils.
+void addNeighbour(const StencilContext &c, const hermes::index2 &ij,
+                  core::element_orientation_bits orientation, real_t k,
+                  DiscreteOperator &op) {
+  auto n = c.mesh.neighbour(c.sym.symbol.loc, ij, orientation,
+                            c.sym.boundary_symbol.loc);
+  if (n.element_index.element != c.sym.symbol.loc)
+    op.addScaled(c.boundary.stencil(n.element_index.index), k);
+  else
+    op.add(*n.element_index.index, k);
+}
+
+/// Adds the second difference along x or y centered at the element index to
+/// op.
+void addDerivative(const StencilContext &c, derivative_bits d, h_size index,
+                   const hermes::index2 &ij, DiscreteOperator &op) {
+  // TODO assuming ghost point, so boundary distance is h
+  // TODO if we want to allow non-uniform distances we need to consider h/2
   if (d == derivative_bits::x) {
-    auto left = mesh->neighbour(sym.symbol.loc, ij,
-                                core::element_orientation_bits::left,
-                                sym.boundary_symbol.loc);
-    auto right = mesh->neighbour(sym.symbol.loc, ij,
-                                 core::element_orientation_bits::right,
-                                 sym.boundary_symbol.loc);
-    // TODO assuming ghost point, so boundary distance is hx
-    // TODO if we want to allow non-uniform distances we need to consider hx/2
-    auto hx = mesh->cellSize().x;
-    auto k = 1 / (hx * hx);
-    addNeighbour(left, k);
-    addNeighbour(right, k);
-    op.add(index, -2 * k);
+    if (c.cells && ij.i > 0 &&
+        ij.i + 1 < static_cast<i32>(c.resolution.width)) {
+      op.add(index - 1, c.kx);
+      op.add(index + 1, c.kx);
+    } else {
+      addNeighbour(c, ij, core::element_orientation_bits::left, c.kx, op);
+      addNeighbour(c, ij, core::element_orientation_bits::right, c.kx, op);
+    }
+    op.add(index, -2 * c.kx);
   } else if (d == derivative_bits::y) {
-    auto down = mesh->neighbour(sym.symbol.loc, ij,
-                                core::element_orientation_bits::down,
-                                sym.boundary_symbol.loc);
-    auto up =
-        mesh->neighbour(sym.symbol.loc, ij, core::element_orientation_bits::up,
-                        sym.boundary_symbol.loc);
-    // TODO assuming ghost point, so boundary distance is hy
-    // TODO if we want to allow non-uniform distances we need to consider hy/2
-    auto hy = mesh->cellSize().y;
-    auto k = 1 / (hy * hy);
-    addNeighbour(down, k);
-    addNeighbour(up, k);
-    op.add(index, -2 * k);
+    const h_size width = c.resolution.width;
+    if (c.cells && ij.j > 0 &&
+        ij.j + 1 < static_cast<i32>(c.resolution.height)) {
+      op.add(index - width, c.ky);
+      op.add(index + width, c.ky);
+    } else {
+      addNeighbour(c, ij, core::element_orientation_bits::down, c.ky, op);
+      addNeighbour(c, ij, core::element_orientation_bits::up, c.ky, op);
+    }
+    op.add(index, -2 * c.ky);
   } else {
     // err
   }
+}
+
+/// Adds the terms of a radius 1 stencil centered at the element index to op.
+/// Terms outside the grid are expanded into boundary stencils, diagonal
+/// terms past a corner take the average of both boundary neighbours.
+template <h_size N>
+void addStencil(const StencilContext &c, const fd::Stencil<N> &s,
+                const std::array<real_t, N> &weights, const hermes::index2 &ij,
+                DiscreteOperator &op) {
+  const i32 w = static_cast<i32>(c.resolution.width);
+  const i32 h = static_cast<i32>(c.resolution.height);
+  for (h_size k = 0; k < N; ++k) {
+    const hermes::index2 t(ij.i + s.taps[k].i, ij.j + s.taps[k].j);
+    const bool inside_x = t.i >= 0 && t.i < w;
+    const bool inside_y = t.j >= 0 && t.j < h;
+    const auto x_side = s.taps[k].i < 0 ? core::element_orientation_bits::left
+                                        : core::element_orientation_bits::right;
+    const auto y_side = s.taps[k].j < 0 ? core::element_orientation_bits::down
+                                        : core::element_orientation_bits::up;
+    if (inside_x && inside_y)
+      op.add(t.j * w + t.i, weights[k]);
+    else if (inside_y)
+      addNeighbour(c, {ij.i, t.j}, x_side, weights[k], op);
+    else if (inside_x)
+      addNeighbour(c, {t.i, ij.j}, y_side, weights[k], op);
+    else {
+      addNeighbour(c, ij, x_side, weights[k] / 2, op);
+      addNeighbour(c, ij, y_side, weights[k] / 2, op);
+    }
+  }
+}
+
+/// Evaluates the stencil S over the cells [first, last) of a row, where
+/// offsets are the flat offsets of the terms.
+template <auto S, std::size_t... K>
+void applyRow(const real_t *in, real_t *out, i64 first, i64 last,
+              const i64 *offsets,
+              const std::array<real_t, decltype(S)::size> &weights,
+              std::index_sequence<K...>) {
+  // local copies, so they are not reloaded after every store to out
+  const i64 o[] = {offsets[K]...};
+  const real_t w[] = {weights[K]...};
+  for (i64 i = first; i < last; ++i)
+    out[i] = ((w[K] * in[i + o[K]]) + ...);
+}
+
+/// Evaluates out = S(in) over a cell field. Cells within the radius of S from
+/// the domain boundary are evaluated with the generic operator path using the
+/// radius 1 stencil R instead.
+template <auto S, auto R>
+void evaluateStencil(const StencilContext &c, const core::FieldCRef<real_t> &in,
+                     core::FieldRef<real_t> &out) {
+  constexpr i32 r = S.radius();
+  const i64 w = c.resolution.width;
+  const i64 h = c.resolution.height;
+  const auto d = c.mesh.cellSize();
+  const auto weights = S.weights(d.x, d.y);
+  const auto ring_weights = R.weights(d.x, d.y);
+  std::array<i64, decltype(S)::size> offsets;
+  for (h_size k = 0; k < offsets.size(); ++k)
+    offsets[k] = S.taps[k].j * w + S.taps[k].i;
+  const real_t *x = in.data();
+  real_t *y = out.data();
+
+  const h_size chunk =
+      std::max<h_size>(1, ThreadPool::chunkSize(w * h) / std::max<i64>(w, 1));
+  parallelFor(
+      0, h,
+      [&](h_index j) {
+        DiscreteOperator op;
+        auto ring = [&](i64 first, i64 last) {
+          for (i64 i = first; i < last; ++i) {
+            const h_size index = j * w + i;
+            op.clear(index);
+            addStencil(c, R, ring_weights,
+                       {static_cast<i32>(i), static_cast<i32>(j)}, op);
+            real_t s = op.constant();
+            for (const auto &node : op.nodes())
+              s += node.second * x[node.first];
+            y[index] = s;
+          }
+        };
+        const i64 row = static_cast<i64>(j);
+        if (row < r || row >= h - r || w <= 2 * r) {
+          ring(0, w);
+          return;
+        }
+        ring(0, r);
+        applyRow<S>(x + row * w, y + row * w, r, w - r, offsets.data(),
+                    weights, std::make_index_sequence<decltype(S)::size>());
+        ring(w - r, w);
+      },
+      chunk);
+}
+
+/// Dispatches evaluateStencil for the derivative D of the given order.
+template <derivative_bits D>
+NaResult evaluateDerivative(const StencilContext &c, u32 order,
+                            const core::FieldCRef<real_t> &in,
+                            core::FieldRef<real_t> &out) {
+  constexpr auto ring = fd::derivativeStencil<D, 2>();
+  if (order == 2)
+    evaluateStencil<ring, ring>(c, in, out);
+  else if (order == 4)
+    evaluateStencil<fd::derivativeStencil<D, 4>(), ring>(c, in, out);
+  else {
+    HERMES_ERROR("Unsupported finite difference order {}.", order);
+    return NaResult::inputError();
+  }
+  return NaResult::noError();
+}
+
+/// Checks that sym and its fields can be evaluated by the stencil kernels.
+NaResult checkStencilInput(const Grid2FD &fd, const core::DiscreteSymbol &sym,
+                           const core::FieldCRef<real_t> &in,
+                           const core::FieldRef<real_t> &out) {
+  if (!sym.symbol.loc.is(core::element_primitive_bits::cell) ||
+      !sym.boundary_symbol.loc.is(core::element_primitive_bits::face)) {
+    HERMES_ERROR("Stencil evaluation requires a cell symbol.");
+    return NaResult::inputError();
+  }
+  if (!fd.boundaries().count(sym.boundary_symbol)) {
+    HERMES_ERROR("Missing boundary for symbol {}.", sym.symbol.name);
+    return NaResult::notFound();
+  }
+  const auto n = fd.mesh().resolution(sym.symbol.loc).total();
+  if (in.size() != n || out.size() != n || !in.contiguous() ||
+      !out.contiguous()) {
+    HERMES_ERROR("Stencil evaluation requires contiguous fields of size {}.",
+                 n);
+    return NaResult::inputError();
+  }
+  return NaResult::noError();
+}
+
+} // namespace
+
+const Boundary &
+Grid2FD::symbolBoundary(const core::DiscreteSymbol &sym) const {
+  // sanity error checks
+  auto it = boundaries_.find(sym.boundary_symbol);
+  HERMES_ASSERT(it != boundaries_.end() && topology_);
+  return it->second;
+}
+
+DiscreteOperator Grid2FD::derivative(derivative_bits d, h_size index,
+                                     const core::DiscreteSymbol &sym) const {
+  DiscreteOperator op(index);
+  const StencilContext c(mesh(), symbolBoundary(sym), sym);
+  addDerivative(c, d, index, c.index(index), op);
   return op;
 }
 
 DiscreteOperator Grid2FD::laplacian(h_size index,
                                     const core::DiscreteSymbol &sym) const {
   DiscreteOperator op(index);
-  op += derivative(derivative_bits::x, index, sym);
-  op += derivative(derivative_bits::y, index, sym);
+  const StencilContext c(mesh(), symbolBoundary(sym), sym);
+  const auto ij = c.index(index);
+  addDerivative(c, derivative_bits::x, index, ij, op);
+  addDerivative(c, derivative_bits::y, index, ij, op);
   return op;
 }
 
+DiscreteExpression
+Grid2FD::derivativeExpression(derivative_bits d,
+                              const core::DiscreteSymbol &sym) const {
+  const StencilContext c(mesh(), symbolBoundary(sym), sym);
+  return assembleRows(sym, [&](h_index i, DiscreteOperator &op) {
+    addDerivative(c, d, i, c.index(i), op);
+  });
+}
+
+DiscreteExpression
+Grid2FD::laplacianExpression(const core::DiscreteSymbol &sym) const {
+  const StencilContext c(mesh(), symbolBoundary(sym), sym);
+  return assembleRows(sym, [&](h_index i, DiscreteOperator &op) {
+    const auto ij = c.index(i);
+    addDerivative(c, derivative_bits::x, i, ij, op);
+    addDerivative(c, derivative_bits::y, i, ij, op);
+  });
+}
+
+NaResult Grid2FD::evaluateDerivative(derivative_bits d,
+                                     const core::DiscreteSymbol &sym,
+                                     const core::FieldCRef<real_t> &in,
+                                     core::FieldRef<real_t> &out,
+                                     u32 order) const {
+  NAIADES_RETURN_BAD_RESULT(checkStencilInput(*this, sym, in, out));
+  const StencilContext c(mesh(), symbolBoundary(sym), sym);
+  // x and y are second derivatives, as in addDerivative
+  switch (d) {
+  case derivative_bits::x:
+  case derivative_bits::xx:
+    return numeric::evaluateDerivative<derivative_bits::xx>(c, order, in, out);
+  case derivative_bits::y:
+  case derivative_bits::yy:
+    return numeric::evaluateDerivative<derivative_bits::yy>(c, order, in, out);
+  case derivative_bits::xy:
+  case derivative_bits::yx:
+    return numeric::evaluateDerivative<derivative_bits::xy>(c, order, in, out);
+  default:
+    break;
+  }
+  HERMES_ERROR("Unsupported derivative for stencil evaluation.");
+  return NaResult::inputError();
+}
+
+NaResult Grid2FD::evaluateFirstDerivative(derivative_bits d,
+                                          const core::DiscreteSymbol &sym,
+                                          const core::FieldCRef<real_t> &in,
+                                          core::FieldRef<real_t> &out,
+                                          u32 order) const {
+  NAIADES_RETURN_BAD_RESULT(checkStencilInput(*this, sym, in, out));
+  const StencilContext c(mesh(), symbolBoundary(sym), sym);
+  switch (d) {
+  case derivative_bits::x:
+    return numeric::evaluateDerivative<derivative_bits::x>(c, order, in, out);
+  case derivative_bits::y:
+    return numeric::evaluateDerivative<derivative_bits::y>(c, order, in, out);
+  default:
+    break;
+  }
+  HERMES_ERROR("Unsupported first derivative for stencil evaluation.");
+  return NaResult::inputError();
+}
+
+NaResult Grid2FD::evaluateLaplacian(const core::DiscreteSymbol &sym,
+                                    const core::FieldCRef<real_t> &in,
+                                    core::FieldRef<real_t> &out,
+                                    u32 order) const {
+  NAIADES_RETURN_BAD_RESULT(checkStencilInput(*this, sym, in, out));
+  const StencilContext c(mesh(), symbolBoundary(sym), sym);
+  constexpr auto ring = fd::laplacianStencil<2>();
+  if (order == 2)
+    evaluateStencil<ring, ring>(c, in, out);
+  else if (order == 4)
+    evaluateStencil<fd::laplacianStencil<4>(), ring>(c, in, out);
+  else {
+    HERMES_ERROR("Unsupported finite difference order {}.", order);
+    return NaResult::inputError();
+  }
+  return NaResult::noError();
+}
+
 DiscreteOperator Grid2FD::divergence(const core::Element &loc, h_size index,
                                      const core::Element &vector_loc,
                                      bool staggered) const {
@@ -30,6 +30,7 @@
 #include "naiades/core/element.h"
 #include <naiades/core/field.h>
 #include <naiades/core/mesh.h>
+#include <naiades/geo/grid_layout.h>
 #include <naiades/numeric/spatial_discretization.h>
 
 #include <hermes/base/size.h>
@@ -124,6 +125,14 @@ public:
   hermes::size2 resolution(core::Element loc) const;
   /// Grid flat index from index
   h_size flatIndex(core::Element loc, const hermes::index2 &index) const;
+  /// Grid flat index from index, for fields stored with the given layout.
+  /// \note The layout must be computed for the same element type.
+  h_size flatIndex(core::Element loc, const hermes::index2 &index,
+                   const GridLayout &layout) const;
+  /// Storage layout of the elements of a given type.
+  GridLayout layout(core::Element loc,
+                    GridStorage storage = GridStorage::ROW_MAJOR,
+                    u32 tile_size = 16) const;
   /// Grid index from flat index
   hermes::index2 index(const core::ElementIndex &iloc) const;
   /// Grid safe index (clamped)
@@ -312,10 +321,63 @@ public:
   virtual DiscreteOperator divergence(const core::Element &loc, h_size index,
                                       const core::Element &vector_loc,
                                       bool staggered) const override;
+  /// Evaluates a central difference derivative of a cell field directly,
+  /// without assembling operators.
+  /// Interior cells use the compile-time stencils of fd::derivativeStencil.
+  /// Cells closer to the domain boundary than the stencil radius use the
+  /// second order stencil, with boundary terms expanded into the boundary
+  /// stencils of the symbol.
+  /// \note As in derivative(), x and y denote second derivatives. With order
+  ///       2 the result matches dx(sym) and dy(sym).
+  /// \param d x (or xx), y (or yy) or xy (mixed derivative).
+  /// \param sym Cell symbol with resolved boundaries.
+  /// \param in Contiguous field of sym.
+  /// \param out Contiguous field receiving the derivative (must not overlap
+  ///            in).
+  /// \param order Accuracy order of interior cells (2 or 4).
+  NaResult evaluateDerivative(derivative_bits d,
+                              const core::DiscreteSymbol &sym,
+                              const core::FieldCRef<real_t> &in,
+                              core::FieldRef<real_t> &out,
+                              u32 order = 2) const;
+  /// Evaluates a central difference first derivative of a cell field
+  /// directly, following the rules of evaluateDerivative().
+  /// \param d x or y.
+  /// \param sym Cell symbol with resolved boundaries.
+  /// \param in Contiguous field of sym.
+  /// \param out Contiguous field receiving the derivative (must not overlap
+  ///            in).
+  /// \param order Accuracy order of interior cells (2 or 4).
+  NaResult evaluateFirstDerivative(derivative_bits d,
+                                   const core::DiscreteSymbol &sym,
+                                   const core::FieldCRef<real_t> &in,
+                                   core::FieldRef<real_t> &out,
+                                   u32 order = 2) const;
+  /// Evaluates the discrete Laplacian of a cell field directly, without
+  /// assembling operators. With order 2 the result matches L(sym).
+  /// \param sym Cell symbol with resolved boundaries.
+  /// \param in Contiguous field of sym.
+  /// \param out Contiguous field receiving the Laplacian (must not overlap
+  ///            in).
+  /// \param order Accuracy order of interior cells (2 or 4).
+  NaResult evaluateLaplacian(const core::DiscreteSymbol &sym,
+                             const core::FieldCRef<real_t> &in,
+                             core::FieldRef<real_t> &out,
+                             u32 order = 2) const;
+
+protected:
+  DiscreteExpression
+  derivativeExpression(derivative_bits d,
+                       const core::DiscreteSymbol &sym) const override;
+  DiscreteExpression
+  laplacianExpression(const core::DiscreteSymbol &sym) const override;
 
 private:
   friend struct Config;
 
+  /// \return The resolved boundary of the symbol.
+  const Boundary &symbolBoundary(const core::DiscreteSymbol &sym) const;
+
 #ifdef NAIADES_INCLUDE_DEBUG_TRAITS
   friend struct hermes::DebugTraits<Grid2FD>;
 #endif
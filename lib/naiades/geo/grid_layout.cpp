@@ -0,0 +1,92 @@
+/* Copyright (c) 2026, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/// \file   grid_layout.cpp
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-16
+
+#include <naiades/geo/grid_layout.h>
+
+#include <hermes/math/space_filling.h>
+
+#include <numeric>
+
+namespace naiades::geo {
+
+GridLayout::GridLayout(const hermes::size2 &resolution, GridStorage storage,
+                       u32 tile_size)
+    : resolution_{resolution}, storage_{storage},
+      width_{static_cast<i32>(resolution.width)},
+      height_{static_cast<i32>(resolution.height)} {
+  tile_shift_ = 0;
+  while ((1u << tile_shift_) < tile_size)
+    ++tile_shift_;
+  tile_mask_ = (1 << tile_shift_) - 1;
+  tiles_x_ = (width_ + tile_mask_) >> tile_shift_;
+  const i32 tiles_y = (height_ + tile_mask_) >> tile_shift_;
+  const h_size tile_count = static_cast<h_size>(tiles_x_) * tiles_y;
+
+  tile_order_.resize(tile_count);
+  std::iota(tile_order_.begin(), tile_order_.end(), 0);
+  if (storage_ == GridStorage::MORTON_TILED) {
+    std::vector<u64> codes(tile_count);
+    for (h_index t = 0; t < tile_count; ++t)
+      codes[t] = hermes::math::space_filling::mortonEncode(
+          hermes::index2(static_cast<i32>(t % tiles_x_),
+                         static_cast<i32>(t / tiles_x_)));
+    std::sort(tile_order_.begin(), tile_order_.end(),
+              [&](h_index a, h_index b) { return codes[a] < codes[b]; });
+  }
+  if (storage_ == GridStorage::ROW_MAJOR)
+    return;
+
+  // cropped tiles on the upper boundaries keep the storage compact
+  tile_offsets_.resize(tile_count);
+  h_index offset = 0;
+  for (auto t : tile_order_) {
+    tile_offsets_[t] = offset;
+    const i32 i0 = static_cast<i32>(t % tiles_x_) << tile_shift_;
+    const i32 j0 = static_cast<i32>(t / tiles_x_) << tile_shift_;
+    offset += static_cast<h_size>(std::min(i0 + tile_mask_ + 1, width_) - i0) *
+              (std::min(j0 + tile_mask_ + 1, height_) - j0);
+  }
+}
+
+hermes::index2 GridLayout::index(h_index flat_index) const {
+  HERMES_ASSERT(flat_index < size());
+  if (storage_ == GridStorage::ROW_MAJOR)
+    return hermes::index2(static_cast<i32>(flat_index % width_),
+                          static_cast<i32>(flat_index / width_));
+  // tiles in storage order have increasing offsets
+  auto it = std::upper_bound(
+      tile_order_.begin(), tile_order_.end(), flat_index,
+      [&](h_index k, h_index t) { return k < tile_offsets_[t]; });
+  const h_index t = *(it - 1);
+  const i32 i0 = static_cast<i32>(t % tiles_x_) << tile_shift_;
+  const i32 j0 = static_cast<i32>(t / tiles_x_) << tile_shift_;
+  const i32 tile_width = std::min(tile_mask_ + 1, width_ - i0);
+  const h_index local = flat_index - tile_offsets_[t];
+  return hermes::index2(i0 + static_cast<i32>(local % tile_width),
+                        j0 + static_cast<i32>(local / tile_width));
+}
+
+} // namespace naiades::geo
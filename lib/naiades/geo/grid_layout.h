@@ -0,0 +1,134 @@
+/* Copyright (c) 2026, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/// \file   grid_layout.h
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-16
+/// \brief  Storage layouts of structured element arrays.
+
+#pragma once
+
+#include <naiades/base/parallel.h>
+
+#include <hermes/base/index.h>
+#include <hermes/base/size.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace naiades::geo {
+
+/// Storage orders of structured element arrays.
+enum class GridStorage {
+  ROW_MAJOR,    //!< element (i, j) is stored at j * width + i
+  TILED,        //!< square tiles stored contiguously, tiles by rows
+  MORTON_TILED, //!< square tiles stored contiguously, tiles in Morton order
+};
+
+/// \brief Maps element coordinates (i, j) of a structured array to storage
+///        indices.
+///
+/// Tiled storages keep each tile contiguous (by rows inside the tile), so
+/// 5-point stencils and interpolation gathers touch few cache lines. Tiles on
+/// the upper boundaries are cropped, therefore the storage size is always
+/// width * height and tiled fields fit in the same FieldGroups of row-major
+/// fields.
+class GridLayout {
+public:
+  GridLayout() noexcept = default;
+  /// \param resolution Element resolution.
+  /// \param storage Storage order.
+  /// \param tile_size Tile side, rounded up to a power of two.
+  GridLayout(const hermes::size2 &resolution,
+             GridStorage storage = GridStorage::ROW_MAJOR, u32 tile_size = 16);
+
+  GridStorage storage() const { return storage_; }
+  const hermes::size2 &resolution() const { return resolution_; }
+  u32 tileSize() const { return 1u << tile_shift_; }
+  /// \return Number of stored elements.
+  h_size size() const { return resolution_.total(); }
+
+  /// \return Storage index of the element (i, j).
+  h_index flatIndex(i32 i, i32 j) const {
+    if (storage_ == GridStorage::ROW_MAJOR)
+      return static_cast<h_index>(j) * width_ + i;
+    const i32 ti = i >> tile_shift_;
+    const i32 tj = j >> tile_shift_;
+    const i32 tile_width =
+        std::min(1 << tile_shift_, width_ - (ti << tile_shift_));
+    return tile_offsets_[tj * tiles_x_ + ti] +
+           static_cast<h_index>(j & tile_mask_) * tile_width + (i & tile_mask_);
+  }
+  h_index flatIndex(const hermes::index2 &ij) const {
+    return flatIndex(ij.i, ij.j);
+  }
+  /// \return Element coordinates of the storage index.
+  hermes::index2 index(h_index flat_index) const;
+
+  /// \brief Calls f(flat_index, i, j) for every element.
+  /// Tiles are processed in parallel and in storage order, and elements of
+  /// tiled storages are visited in storage order.
+  template <typename F> void forEach(F &&f) const {
+    parallelFor(
+        0, tile_order_.size(),
+        [&](h_index t) {
+          const i32 ti = static_cast<i32>(tile_order_[t] % tiles_x_);
+          const i32 tj = static_cast<i32>(tile_order_[t] / tiles_x_);
+          const i32 i0 = ti << tile_shift_;
+          const i32 j0 = tj << tile_shift_;
+          const i32 i1 = std::min(i0 + (1 << tile_shift_), width_);
+          const i32 j1 = std::min(j0 + (1 << tile_shift_), height_);
+          for (i32 j = j0; j < j1; ++j) {
+            // rows of a tile are contiguous in every storage
+            const h_index row = flatIndex(i0, j);
+            for (i32 i = i0; i < i1; ++i)
+              f(row + (i - i0), i, j);
+          }
+        },
+        1);
+  }
+
+private:
+  hermes::size2 resolution_;
+  GridStorage storage_{GridStorage::ROW_MAJOR};
+  i32 width_{0};
+  i32 height_{0};
+  i32 tile_shift_{4};
+  i32 tile_mask_{15};
+  i32 tiles_x_{0};
+  /// first storage index of each tile (tiles by rows)
+  std::vector<h_index> tile_offsets_;
+  /// tiles (by rows) in storage order
+  std::vector<h_index> tile_order_;
+};
+
+/// \brief Copy values between two layouts of the same resolution:
+///        dst[to.flatIndex(i, j)] = src[from.flatIndex(i, j)].
+template <typename Src, typename Dst>
+void relayout(const GridLayout &from, const Src &src, const GridLayout &to,
+              Dst &&dst) {
+  HERMES_ASSERT(from.size() == to.size());
+  from.forEach(
+      [&](h_index k, i32 i, i32 j) { dst[to.flatIndex(i, j)] = src[k]; });
+}
+
+} // namespace naiades::geo
@@ -26,20 +26,26 @@
 
 #include <naiades/geo/he.h>
 
+#include <naiades/base/parallel.h>
+
+#include <algorithm>
+#include <limits>
 #include <unordered_set>
 
 namespace naiades::geo {
 
-h_index HE2::null_index_ = 1 << 20;
+h_index HE2::null_index_ = std::numeric_limits<h_index>::max();
 
 HE2::HE2() noexcept : boundary_start_he_{HE2::null_index_} {}
 
 h_index HE2::addVertex(const hermes::geo::point2 &position) {
+  invalidateConnectivity();
   vertices_.push_back({.position = position, .he_index = null_index_});
   return vertices_.size() - 1;
 }
 
 h_index HE2::addCell(const std::vector<h_index> &oriented_vertex_indices) {
+  invalidateConnectivity();
   const h_index cell_index = cells_.size();
   const h_size cell_size = oriented_vertex_indices.size();
   std::vector<h_index> internal_half_edges(cell_size);
@@ -72,6 +78,213 @@ h_index HE2::addCell(const std::vector<h_index> &oriented_vertex_indices) {
   return cells_.size() - 1;
 }
 
+Result<HE2> HE2::fromArrays(std::span<const hermes::geo::point2> vertices,
+                            std::span<const h_index> cell_offsets,
+                            std::span<const h_index> cell_vertices) {
+  const h_size vertex_count = vertices.size();
+  const h_size corner_count = cell_vertices.size();
+  if (cell_offsets.empty() || cell_offsets.front() != 0 ||
+      cell_offsets.back() != corner_count)
+    return NaResult::inputError();
+  const h_size cell_count = cell_offsets.size() - 1;
+  // every index (up to 2 half-edges per corner) must stay below the sentinel
+  if (corner_count >= null_index_ / 2 || vertex_count >= null_index_ ||
+      cell_count >= null_index_)
+    return NaResult::inputError();
+  for (h_index c = 0; c < cell_count; ++c)
+    if (cell_offsets[c + 1] < cell_offsets[c] + 3)
+      return NaResult::inputError();
+  for (auto v : cell_vertices)
+    if (v >= vertex_count)
+      return NaResult::inputError();
+
+  // each cell corner k starts the internal half-edge that goes from
+  // cell_vertices[k] to the vertex of the next corner of the same cell
+  std::vector<h_index> corner_cell(corner_count);
+  parallelFor(0, cell_count, [&](h_index c) {
+    for (h_index k = cell_offsets[c]; k < cell_offsets[c + 1]; ++k)
+      corner_cell[k] = c;
+  });
+  auto nextCorner = [&](h_index k) {
+    auto c = corner_cell[k];
+    return k + 1 == cell_offsets[c + 1] ? cell_offsets[c] : k + 1;
+  };
+  auto prevCorner = [&](h_index k) {
+    auto c = corner_cell[k];
+    return k == cell_offsets[c] ? cell_offsets[c + 1] - 1 : k - 1;
+  };
+  auto cornerEnd = [&](h_index k) { return cell_vertices[nextCorner(k)]; };
+  auto edgeMin = [&](h_index k) {
+    return std::min(cell_vertices[k], cornerEnd(k));
+  };
+  auto edgeMax = [&](h_index k) {
+    return std::max(cell_vertices[k], cornerEnd(k));
+  };
+
+  // sort corners by edge key (min vertex, max vertex): a counting sort on
+  // the min vertex followed by sorting each (valence sized) bucket, so both
+  // half-edges of an edge end up next to each other
+  std::vector<h_index> bucket_offsets(vertex_count + 1, 0);
+  for (h_index k = 0; k < corner_count; ++k)
+    ++bucket_offsets[edgeMin(k) + 1];
+  for (h_index v = 0; v < vertex_count; ++v)
+    bucket_offsets[v + 1] += bucket_offsets[v];
+  std::vector<h_index> sorted_corners(corner_count);
+  {
+    std::vector<h_index> cursor(bucket_offsets.begin(),
+                                bucket_offsets.end() - 1);
+    for (h_index k = 0; k < corner_count; ++k)
+      sorted_corners[cursor[edgeMin(k)]++] = k;
+  }
+  parallelFor(0, vertex_count, [&](h_index v) {
+    std::sort(sorted_corners.begin() + bucket_offsets[v],
+              sorted_corners.begin() + bucket_offsets[v + 1],
+              [&](h_index a, h_index b) {
+                auto ma = edgeMax(a);
+                auto mb = edgeMax(b);
+                return ma < mb || (ma == mb && a < b);
+              });
+  });
+
+  HE2 he;
+  he.vertices_.resize(vertex_count);
+  for (h_index v = 0; v < vertex_count; ++v)
+    he.vertices_[v] = {.position = vertices[v], .he_index = null_index_};
+
+  // create full-edges: the even half-edge belongs to the first corner, the odd
+  // one to the opposite corner or to the boundary.
+  // The edge map used by addCell is only rebuilt if the mesh is extended.
+  std::vector<h_index> corner_he(corner_count);
+  he.half_edges_.reserve(2 * corner_count);
+  for (h_index i = 0; i < corner_count;) {
+    const auto k = sorted_corners[i];
+    h_index j = i + 1;
+    while (j < corner_count && edgeMin(sorted_corners[j]) == edgeMin(k) &&
+           edgeMax(sorted_corners[j]) == edgeMax(k))
+      ++j;
+    // manifold edges are shared by at most two cells with opposite directions
+    if (j - i > 2 || (j - i == 2 && cell_vertices[sorted_corners[i + 1]] ==
+                                        cell_vertices[k]))
+      return NaResult::inputError();
+    const h_index even_he = he.half_edges_.size();
+    corner_he[k] = even_he;
+    he.half_edges_.push_back({.vertex_index = cell_vertices[k],
+                              .cell_index = corner_cell[k],
+                              .next_he = null_index_,
+                              .prev_he = null_index_});
+    if (j - i == 2) {
+      const auto t = sorted_corners[i + 1];
+      corner_he[t] = even_he + 1;
+      he.half_edges_.push_back({.vertex_index = cell_vertices[t],
+                                .cell_index = corner_cell[t],
+                                .next_he = null_index_,
+                                .prev_he = null_index_});
+    } else {
+      he.half_edges_.push_back({.vertex_index = cornerEnd(k),
+                                .cell_index = null_index_,
+                                .next_he = null_index_,
+                                .prev_he = null_index_});
+    }
+    i = j;
+  }
+
+  // internal loops follow the cell corners
+  parallelFor(0, corner_count, [&](h_index k) {
+    auto &half_edge = he.half_edges_[corner_he[k]];
+    half_edge.next_he = corner_he[nextCorner(k)];
+    half_edge.prev_he = corner_he[prevCorner(k)];
+  });
+
+  // boundary loops: a manifold boundary vertex has a single outgoing boundary
+  // half-edge, which is the next of the boundary half-edge arriving at it
+  std::vector<h_index> boundary_out(vertex_count, null_index_);
+  for (h_index h = 1; h < he.half_edges_.size(); h += 2) {
+    if (he.half_edges_[h].cell_index != null_index_)
+      continue;
+    auto &out = boundary_out[he.half_edges_[h].vertex_index];
+    if (out != null_index_)
+      return NaResult::inputError();
+    out = h;
+  }
+  for (h_index h = 1; h < he.half_edges_.size(); h += 2) {
+    if (he.half_edges_[h].cell_index != null_index_)
+      continue;
+    auto next = boundary_out[he.heEnd(h)];
+    HERMES_ASSERT(next != null_index_);
+    he.half_edges_[h].next_he = next;
+    he.half_edges_[next].prev_he = h;
+    if (he.boundary_start_he_ == null_index_)
+      he.boundary_start_he_ = h;
+  }
+
+  // boundary vertices must reference their outgoing boundary half-edge
+  for (h_index h = 0; h < he.half_edges_.size(); ++h) {
+    auto &vertex = he.vertices_[he.half_edges_[h].vertex_index];
+    if (vertex.he_index == null_index_)
+      vertex.he_index = h;
+  }
+  for (h_index v = 0; v < vertex_count; ++v)
+    if (boundary_out[v] != null_index_)
+      he.vertices_[v].he_index = boundary_out[v];
+
+  he.cells_.resize(cell_count);
+  parallelFor(0, cell_count, [&](h_index c) {
+    hermes::geo::point2 center;
+    for (h_index k = cell_offsets[c]; k < cell_offsets[c + 1]; ++k)
+      center += hermes::geo::vec2(vertices[cell_vertices[k]]);
+    center /= static_cast<real_t>(cell_offsets[c + 1] - cell_offsets[c]);
+    he.cells_[c] = {.center = center, .he_index = corner_he[cell_offsets[c]]};
+  });
+
+  return Result<HE2>(std::move(he));
+}
+
+NaResult HE2::renumber(const MeshPermutation &permutation) {
+  if (permutation.vertices.size() != vertices_.size() ||
+      permutation.faces.size() != half_edges_.size() / 2 ||
+      permutation.cells.size() != cells_.size())
+    return NaResult::inputError();
+  // half-edges move with their full-edge and keep their parity, so twins
+  // remain even-odd pairs
+  auto newHe = [&](h_index he) {
+    if (he == null_index_)
+      return he;
+    return 2 * permutation.faces.newIndex(he / 2) + he % 2;
+  };
+  auto newCell = [&](h_index cell) {
+    if (cell == null_index_)
+      return cell;
+    return permutation.cells.newIndex(cell);
+  };
+
+  std::vector<HalfEdge> half_edges(half_edges_.size());
+  for (h_index he = 0; he < half_edges_.size(); ++he) {
+    const auto &half_edge = half_edges_[he];
+    half_edges[newHe(he)] = {
+        .vertex_index = permutation.vertices.newIndex(half_edge.vertex_index),
+        .cell_index = newCell(half_edge.cell_index),
+        .next_he = newHe(half_edge.next_he),
+        .prev_he = newHe(half_edge.prev_he)};
+  }
+  std::vector<Vertex> vertices(vertices_.size());
+  for (h_index v = 0; v < vertices_.size(); ++v)
+    vertices[permutation.vertices.newIndex(v)] = {
+        .position = vertices_[v].position,
+        .he_index = newHe(vertices_[v].he_index)};
+  std::vector<Cell> cells(cells_.size());
+  for (h_index c = 0; c < cells_.size(); ++c)
+    cells[permutation.cells.newIndex(c)] = {
+        .center = cells_[c].center, .he_index = newHe(cells_[c].he_index)};
+
+  half_edges_ = std::move(half_edges);
+  vertices_ = std::move(vertices);
+  cells_ = std::move(cells);
+  boundary_start_he_ = newHe(boundary_start_he_);
+  edge_vertices_to_edge_index_map_.clear();
+  invalidateConnectivity();
+  return NaResult::noError();
+}
+
 h_index HE2::heTwin(h_index he_index) const {
   return he_index + (he_index % 2 ? -1 : 1);
 }
@@ -132,6 +345,13 @@ std::vector<h_index> HE2::heLoop(h_index he_index) const {
 
 h_index HE2::addOrientedFace(h_index va, h_index vb) {
   HERMES_ASSERT(va < vertices_.size() && vb < vertices_.size());
+  // meshes built from arrays do not fill the edge map
+  if (edge_vertices_to_edge_index_map_.size() != half_edges_.size() / 2) {
+    edge_vertices_to_edge_index_map_.clear();
+    edge_vertices_to_edge_index_map_.reserve(half_edges_.size() / 2);
+    for (h_index he = 0; he < half_edges_.size(); he += 2)
+      edge_vertices_to_edge_index_map_[EdgeKey(heStart(he), heEnd(he))] = he;
+  }
   auto key = EdgeKey(va, vb);
   auto it = edge_vertices_to_edge_index_map_.find(key);
   if (it != edge_vertices_to_edge_index_map_.end()) {
@@ -192,10 +412,7 @@ std::vector<h_index> HE2::outgoingHEs(h_index vertex_index) const {
   if (start == null_index_)
     return hes;
   auto curr = start;
-  auto i = 0;
   do {
-    if (i++ == 5)
-      break;
     hes.emplace_back(curr);
     curr = heTwin(curr);
     curr = half_edges_[curr].next_he;
@@ -211,10 +428,7 @@ std::vector<h_index> HE2::incomingHEs(h_index vertex_index) const {
     return hes;
   start = heTwin(start);
   auto curr = start;
-  auto i = 0;
   do {
-    if (i++ == 5)
-      break;
     hes.emplace_back(curr);
     curr = half_edges_[curr].next_he;
     curr = heTwin(curr);
@@ -494,10 +708,11 @@ bool HE2::isBoundary(const core::ElementIndex &iloc) const {
   auto he = null_index_;
   if (iloc.element.is(core::element_primitive_bits::cell)) {
     HERMES_ASSERT(iloc.index < cells_.size());
-    auto loop = heLoop(cells_[iloc.index].he_index);
-    for (auto he : loop)
-      if (half_edges_[he].cell_index == null_index_ ||
-          half_edges_[heTwin(he)].cell_index == null_index_)
+    const auto &face_cells =
+        connectivity(core::Element::face(), core::Element::cell());
+    for (auto face :
+         connectivity(iloc.element, core::Element::face())[*iloc.index])
+      if (face_cells[face].size() < 2)
         return true;
     return false;
   } else if (iloc.element.is(core::element_primitive_bits::face)) {
@@ -547,20 +762,24 @@ HE2::star(const core::ElementIndex &iloc, core::Element star_loc,
   if (iloc.element.is(core::element_primitive_bits::cell)) {
     HERMES_ASSERT(iloc.index < cells_.size());
     if (star_loc.is(core::element_primitive_bits::cell)) {
-      HERMES_ASSERT(cells_[iloc.index].he_index < half_edges_.size());
-      for (auto he : heLoop(cells_[iloc.index].he_index)) {
-        auto he_t = heTwin(he);
-        auto n_cell = half_edges_[he_t].cell_index;
-        if (n_cell != null_index_) {
+      const auto &face_cells =
+          connectivity(core::Element::face(), core::Element::cell());
+      // faces follow the half-edge loop of the cell
+      for (auto face :
+           connectivity(iloc.element, core::Element::face())[*iloc.index]) {
+        auto face_cell_indices = face_cells[face];
+        if (face_cell_indices.size() == 2) {
+          auto n_cell = face_cell_indices[0] == *iloc.index
+                            ? face_cell_indices[1]
+                            : face_cell_indices[0];
           auto cell_iloc = core::ElementIndex::global(iloc.element, n_cell);
           s.push_back({.element_index = cell_iloc,
-                       .distance = hermes::geo::distance(center_pos,
-                                                         center(cell_iloc))});
+                       .distance = hermes::geo::distance(
+                           center_pos, cells_[n_cell].center)});
         } else if (boundary_loc) {
           HERMES_ASSERT(*boundary_loc == core::Element::FACE);
           // the boundary is represented by the center of the face
-          auto n_face = heFace(he_t);
-          auto face_iloc = core::ElementIndex::global(*boundary_loc, n_face);
+          auto face_iloc = core::ElementIndex::global(*boundary_loc, face);
           s.push_back({.element_index = face_iloc,
                        .distance = hermes::geo::distance(center_pos,
                                                          center(face_iloc))});
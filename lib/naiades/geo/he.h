@@ -27,11 +27,14 @@
 #pragma once
 
 #include <naiades/core/mesh.h>
+#include <naiades/geo/reorder.h>
 #include <naiades/numeric/spatial_discretization.h>
 
 #include <hermes/geometry/vector.h>
 #include <hermes/numeric/numeric.h>
 
+#include <span>
+
 namespace naiades::geo {
 
 struct EdgeKey {
@@ -56,7 +59,8 @@ private:
 namespace std {
 template <> struct hash<naiades::geo::EdgeKey> {
   std::size_t operator()(const naiades::geo::EdgeKey &key) const noexcept {
-    return key.a_ ^ (key.b_ << 1);
+    return std::hash<u64>{}((static_cast<u64>(key.a_) << 32) ^
+                            static_cast<u64>(key.b_));
   }
 };
 } // namespace std
@@ -88,6 +92,19 @@ class HE2 : public core::Mesh2 {
 public:
   using Ptr = hermes::Ref<HE2>;
 
+  /// \brief Build a mesh from flat arrays in linear time.
+  /// The oriented vertices of cell c are
+  /// cell_vertices[cell_offsets[c], cell_offsets[c + 1]).
+  /// \note Cells must follow the same orientation rules of addCell and the
+  ///       mesh must be manifold, vertices may have any valence.
+  /// \param vertices Vertex positions.
+  /// \param cell_offsets Cell ranges (cell count + 1 entries).
+  /// \param cell_vertices Concatenated cell vertex indices.
+  /// \return The mesh or inputError for invalid or non-manifold input.
+  static Result<HE2> fromArrays(std::span<const hermes::geo::point2> vertices,
+                                std::span<const h_index> cell_offsets,
+                                std::span<const h_index> cell_vertices);
+
   HE2() noexcept;
   virtual ~HE2() = default;
 
@@ -99,6 +116,12 @@ public:
   /// \return The index of the newly created cell.
   /// \note This creates the faces for the new cell if necessary.
   h_index addCell(const std::vector<h_index> &oriented_vertex_indices);
+  /// \brief Renumber vertices, faces and cells.
+  /// \note Fields stored in the old numbering can be moved with
+  ///       Permutation::apply and mapped back with Permutation::applyInverse.
+  /// \param permutation New numbering of each element type.
+  /// \return inputError if the permutation sizes do not match the mesh.
+  NaResult renumber(const MeshPermutation &permutation);
 
   /// \return The twin half-edge index.
   h_index heTwin(h_index he_index) const;
@@ -0,0 +1,223 @@
+/* Copyright (c) 2026, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/// \file   reorder.cpp
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-16
+
+#include <naiades/geo/reorder.h>
+
+#include <hermes/math/space_filling.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace naiades::geo {
+
+namespace {
+
+/// Number of bits per axis used to quantize element centers.
+constexpr u32 curve_bits = 16;
+
+/// Hilbert curve index of a cell of a 2^curve_bits x 2^curve_bits grid.
+u64 hilbertIndex(u32 x, u32 y) {
+  constexpr u32 n = 1u << curve_bits;
+  u64 d = 0;
+  for (u32 s = n / 2; s > 0; s /= 2) {
+    const u32 rx = (x & s) > 0;
+    const u32 ry = (y & s) > 0;
+    d += static_cast<u64>(s) * s * ((3 * rx) ^ ry);
+    // rotate the quadrant so the sub-curve has the canonical orientation
+    if (ry == 0) {
+      if (rx == 1) {
+        x = n - 1 - x;
+        y = n - 1 - y;
+      }
+      std::swap(x, y);
+    }
+  }
+  return d;
+}
+
+/// Orders points along a space-filling curve over their bounding box.
+std::vector<h_index> curveOrder(const std::vector<hermes::geo::point2> &points,
+                                Ordering ordering) {
+  const h_size n = points.size();
+  hermes::geo::point2 lower = n ? points[0] : hermes::geo::point2();
+  hermes::geo::point2 upper = lower;
+  for (const auto &p : points) {
+    lower = {std::min(lower.x, p.x), std::min(lower.y, p.y)};
+    upper = {std::max(upper.x, p.x), std::max(upper.y, p.y)};
+  }
+  const real_t max_coordinate = static_cast<real_t>((1u << curve_bits) - 1);
+  auto quantize = [&](real_t v, real_t l, real_t u) {
+    if (u <= l)
+      return 0u;
+    const real_t t = std::clamp((v - l) / (u - l), real_t(0), real_t(1));
+    return static_cast<u32>(t * max_coordinate);
+  };
+  std::vector<u64> keys(n);
+  for (h_index i = 0; i < n; ++i) {
+    const u32 x = quantize(points[i].x, lower.x, upper.x);
+    const u32 y = quantize(points[i].y, lower.y, upper.y);
+    keys[i] = ordering == Ordering::HILBERT
+                  ? hilbertIndex(x, y)
+                  : hermes::math::space_filling::mortonEncode(hermes::index2(
+                        static_cast<i32>(x), static_cast<i32>(y)));
+  }
+  std::vector<h_index> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](h_index a, h_index b) { return keys[a] < keys[b]; });
+  return order;
+}
+
+/// Reverse Cuthill-McKee order of the nodes of a graph.
+std::vector<h_index> rcmOrder(const core::Adjacency &graph) {
+  const h_size n = graph.size();
+  std::vector<h_index> order;
+  order.reserve(n);
+  std::vector<bool> visited(n, false);
+  // nodes sorted by degree, used to pick the start of each component
+  std::vector<h_index> by_degree(n);
+  std::iota(by_degree.begin(), by_degree.end(), 0);
+  auto degree = [&](h_index i) { return graph[i].size(); };
+  std::stable_sort(by_degree.begin(), by_degree.end(),
+                   [&](h_index a, h_index b) { return degree(a) < degree(b); });
+  std::vector<h_index> neighbours;
+  for (auto start : by_degree) {
+    if (visited[start])
+      continue;
+    visited[start] = true;
+    // breadth-first search visiting neighbours by increasing degree
+    h_index head = order.size();
+    order.emplace_back(start);
+    for (; head < order.size(); ++head) {
+      neighbours.clear();
+      for (auto j : graph[order[head]])
+        if (!visited[j]) {
+          visited[j] = true;
+          neighbours.emplace_back(j);
+        }
+      std::stable_sort(
+          neighbours.begin(), neighbours.end(),
+          [&](h_index a, h_index b) { return degree(a) < degree(b); });
+      order.insert(order.end(), neighbours.begin(), neighbours.end());
+    }
+  }
+  std::reverse(order.begin(), order.end());
+  return order;
+}
+
+/// Vertices connected by a face.
+core::Adjacency vertexGraph(const core::Mesh2 &mesh) {
+  const auto &face_vertices =
+      mesh.connectivity(core::Element::face(), core::Element::vertex());
+  const auto vertex_faces =
+      face_vertices.transposed(mesh.elementCount(core::Element::vertex()));
+  return core::Adjacency::fromRows(
+      vertex_faces.size(), [&](h_index v, std::vector<h_size> &row) {
+        for (auto f : vertex_faces[v])
+          for (auto u : face_vertices[f])
+            if (u != v)
+              row.emplace_back(u);
+      });
+}
+
+/// Faces sorted by the first (new) index of their cells.
+std::vector<h_index> facesFollowingCells(const core::Mesh2 &mesh,
+                                         const Permutation &cells) {
+  const auto &face_cells =
+      mesh.connectivity(core::Element::face(), core::Element::cell());
+  std::vector<h_index> key(face_cells.size());
+  for (h_index f = 0; f < face_cells.size(); ++f) {
+    key[f] = cells.size();
+    for (auto c : face_cells[f])
+      key[f] = std::min(key[f], cells.newIndex(c));
+  }
+  std::vector<h_index> order(face_cells.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](h_index a, h_index b) { return key[a] < key[b]; });
+  return order;
+}
+
+} // namespace
+
+Permutation Permutation::identity(h_size size) {
+  std::vector<h_index> order(size);
+  std::iota(order.begin(), order.end(), 0);
+  return *fromOrder(std::move(order));
+}
+
+Result<Permutation> Permutation::fromOrder(std::vector<h_index> order) {
+  Permutation p;
+  p.new_index_.assign(order.size(), order.size());
+  for (h_index i = 0; i < order.size(); ++i) {
+    if (order[i] >= order.size() || p.new_index_[order[i]] != order.size())
+      return NaResult::inputError();
+    p.new_index_[order[i]] = i;
+  }
+  p.old_index_ = std::move(order);
+  return Result<Permutation>(std::move(p));
+}
+
+h_size Permutation::size() const { return new_index_.size(); }
+
+h_index Permutation::newIndex(h_index old_index) const {
+  HERMES_ASSERT(old_index < new_index_.size());
+  return new_index_[old_index];
+}
+
+h_index Permutation::oldIndex(h_index new_index) const {
+  HERMES_ASSERT(new_index < old_index_.size());
+  return old_index_[new_index];
+}
+
+std::span<const h_index> Permutation::order() const { return old_index_; }
+
+Permutation Permutation::inverse() const {
+  Permutation p;
+  p.new_index_ = old_index_;
+  p.old_index_ = new_index_;
+  return p;
+}
+
+MeshPermutation computeOrdering(const core::Mesh2 &mesh, Ordering ordering) {
+  MeshPermutation p;
+  if (ordering == Ordering::RCM) {
+    p.cells = *Permutation::fromOrder(rcmOrder(
+        mesh.connectivity(core::Element::cell(), core::Element::cell())));
+    p.vertices = *Permutation::fromOrder(rcmOrder(vertexGraph(mesh)));
+    p.faces = *Permutation::fromOrder(facesFollowingCells(mesh, p.cells));
+    return p;
+  }
+  p.cells = *Permutation::fromOrder(
+      curveOrder(mesh.centers(core::Element::cell()), ordering));
+  p.vertices = *Permutation::fromOrder(
+      curveOrder(mesh.centers(core::Element::vertex()), ordering));
+  p.faces = *Permutation::fromOrder(
+      curveOrder(mesh.centers(core::Element::face()), ordering));
+  return p;
+}
+
+} // namespace naiades::geo
@@ -0,0 +1,102 @@
+/* Copyright (c) 2026, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/// \file   reorder.h
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-16
+/// \brief  Element reordering for memory locality.
+
+#pragma once
+
+#include <naiades/core/mesh.h>
+
+#include <span>
+#include <vector>
+
+namespace naiades::geo {
+
+/// Element orderings.
+enum class Ordering {
+  RCM,     //!< reverse Cuthill-McKee (minimizes the adjacency bandwidth)
+  MORTON,  //!< Z-order curve over element centers
+  HILBERT, //!< Hilbert curve over element centers
+};
+
+/// \brief Renumbering of a sequence of elements.
+/// Element old_index is moved to newIndex(old_index), and the element at
+/// new_index came from oldIndex(new_index).
+class Permutation {
+public:
+  static Permutation identity(h_size size);
+  /// \param order Old index of each new position.
+  /// \return The permutation or inputError if order is not a permutation.
+  static Result<Permutation> fromOrder(std::vector<h_index> order);
+
+  Permutation() noexcept = default;
+
+  h_size size() const;
+  h_index newIndex(h_index old_index) const;
+  h_index oldIndex(h_index new_index) const;
+  /// \return Old index of each new position.
+  std::span<const h_index> order() const;
+  /// \return The permutation that undoes this one.
+  Permutation inverse() const;
+
+  /// \brief Move values to the new numbering: dst[newIndex(i)] = src[i].
+  /// \param src Values in the old numbering.
+  /// \param dst Values in the new numbering.
+  template <typename Src, typename Dst>
+  void apply(const Src &src, Dst &&dst) const {
+    HERMES_ASSERT(src.size() == size() && dst.size() == size());
+    for (h_index i = 0; i < new_index_.size(); ++i)
+      dst[new_index_[i]] = src[i];
+  }
+  /// \brief Move values back to the old numbering: dst[i] = src[newIndex(i)].
+  /// \param src Values in the new numbering.
+  /// \param dst Values in the old numbering.
+  template <typename Src, typename Dst>
+  void applyInverse(const Src &src, Dst &&dst) const {
+    HERMES_ASSERT(src.size() == size() && dst.size() == size());
+    for (h_index i = 0; i < new_index_.size(); ++i)
+      dst[i] = src[new_index_[i]];
+  }
+
+private:
+  std::vector<h_index> new_index_;
+  std::vector<h_index> old_index_;
+};
+
+/// Permutations of all element types of a 2-dimensional mesh.
+struct MeshPermutation {
+  Permutation vertices;
+  Permutation faces;
+  Permutation cells;
+};
+
+/// \brief Compute a locality preserving order for the elements of a mesh.
+/// Cells and vertices are ordered independently. Under RCM faces follow the
+/// order of their cells, space-filling curves order faces by their centers.
+/// \param mesh
+/// \param ordering
+MeshPermutation computeOrdering(const core::Mesh2 &mesh, Ordering ordering);
+
+} // namespace naiades::geo
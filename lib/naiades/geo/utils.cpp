@@ -52,30 +52,30 @@ Result<HE2> triangulate(std::vector<hermes::geo::point2> &points) {
   }
   igl::triangle::triangulate(V, E, H, "a0.005q", V2, F2);
 
-  HE2 he;
-  // add vertices
-  for (i32 v = 0; v < V2.rows(); ++v) {
-    he.addVertex(hermes::geo::point2(V2(v, 0), V2(v, 1)));
+  std::vector<hermes::geo::point2> vertices;
+  vertices.reserve(V2.rows());
+  for (i32 v = 0; v < V2.rows(); ++v)
+    vertices.emplace_back(V2(v, 0), V2(v, 1));
+  std::vector<h_index> cell_offsets(F2.rows() + 1);
+  std::vector<h_index> cell_vertices(3 * F2.rows());
+  for (i32 t = 0; t < F2.rows(); ++t) {
+    cell_offsets[t + 1] = 3 * (t + 1);
+    for (i32 k = 0; k < 3; ++k)
+      cell_vertices[3 * t + k] = static_cast<h_index>(F2(t, k));
   }
-  for (i32 t = 0; t < F2.rows(); ++t)
-    he.addCell({
-        static_cast<h_index>(F2(t, 0)),
-        static_cast<h_index>(F2(t, 1)),
-        static_cast<h_index>(F2(t, 2)),
-    });
 
-  return Result<HE2>(std::move(he));
+  return HE2::fromArrays(vertices, cell_offsets, cell_vertices);
 }
 
 Result<HE2> convert2HE(const Grid2 &grid) {
-  HE2 he;
-  for (auto v : grid.centers(core::Element::vertex()))
-    he.addVertex(v);
-  for (auto c : grid.elements(core::Element::cell())) {
-    auto vertices = grid.indices(c.globalIndex(), core::Element::vertex());
-    he.addCell(vertices);
-  }
-  return Result<HE2>(std::move(he));
+  const auto &cell_vertices =
+      grid.connectivity(core::Element::cell(), core::Element::vertex());
+  return HE2::fromArrays(
+      grid.centers(core::Element::vertex()),
+      std::vector<h_index>(cell_vertices.offsets().begin(),
+                           cell_vertices.offsets().end()),
+      std::vector<h_index>(cell_vertices.indices().begin(),
+                           cell_vertices.indices().end()));
 }
 
 } // namespace naiades::geo
@@ -49,18 +49,6 @@ Scalar &Scalar::operator=(const Scalar &rhs) {
   return *this;
 }
 
-h_size Scalar::size() const { return data_.size(); }
-
-real_t Scalar::operator[](h_index i) const {
-  HERMES_ASSERT(i < data_.size());
-  return data_[i];
-}
-
-real_t &Scalar::operator[](h_index i) {
-  HERMES_ASSERT(i < data_.size());
-  return data_[i];
-}
-
 hermes::Interval<f32> Scalar::valueRange() const {
   auto n = data_.size();
   hermes::Interval<f32> interval(0, 0);
@@ -76,105 +64,31 @@ hermes::Interval<f32> Scalar::valueRange() const {
 }
 
 // arithmetic functions
-Scalar &Scalar::operator-=(const Scalar &rhs) {
-  for (h_index i = 0; i < data_.size(); ++i)
-    data_[i] -= rhs.data_[i];
-  return *this;
-}
-Scalar &Scalar::operator+=(const Scalar &rhs) {
-  HERMES_ASSERT(data_.size() == rhs.data_.size());
-  for (h_index i = 0; i < data_.size(); ++i)
-    data_[i] += rhs.data_[i];
-  return *this;
-}
-Scalar &Scalar::operator*=(const Scalar &rhs) {
-  HERMES_ASSERT(data_.size() == rhs.data_.size());
-  for (h_index i = 0; i < data_.size(); ++i)
-    data_[i] *= rhs.data_[i];
-  return *this;
-}
-Scalar &Scalar::operator/=(const Scalar &rhs) {
-  HERMES_ASSERT(data_.size() == rhs.data_.size());
-  for (h_index i = 0; i < data_.size(); ++i)
-    data_[i] /= rhs.data_[i];
-  return *this;
-}
 
 Scalar &Scalar::operator-=(real_t s) {
-  for (h_index i = 0; i < data_.size(); ++i)
-    data_[i] -= s;
+  parallelFor(
+      0, data_.size(), [&](h_index i) { data_[i] -= s; },
+      ThreadPool::chunkSize(data_.size(), parallel_grain_size));
   return *this;
 }
 Scalar &Scalar::operator+=(real_t s) {
-  for (h_index i = 0; i < data_.size(); ++i)
-    data_[i] += s;
+  parallelFor(
+      0, data_.size(), [&](h_index i) { data_[i] += s; },
+      ThreadPool::chunkSize(data_.size(), parallel_grain_size));
   return *this;
 }
 Scalar &Scalar::operator*=(real_t s) {
-  for (h_index i = 0; i < data_.size(); ++i)
-    data_[i] *= s;
+  parallelFor(
+      0, data_.size(), [&](h_index i) { data_[i] *= s; },
+      ThreadPool::chunkSize(data_.size(), parallel_grain_size));
   return *this;
 }
 Scalar &Scalar::operator/=(real_t s) {
   HERMES_ASSERT(!hermes::numbers::cmp::is_zero(s));
-  for (h_index i = 0; i < data_.size(); ++i)
-    data_[i] /= s;
+  parallelFor(
+      0, data_.size(), [&](h_index i) { data_[i] /= s; },
+      ThreadPool::chunkSize(data_.size(), parallel_grain_size));
   return *this;
 }
 
-Scalar operator+(const Scalar &lhs, const Scalar &rhs) {
-  Scalar r = lhs;
-  r += rhs;
-  return r;
-}
-Scalar operator-(const Scalar &lhs, const Scalar &rhs) {
-  Scalar r = lhs;
-  r -= rhs;
-  return r;
-}
-Scalar operator*(real_t s, const Scalar &field) {
-  Scalar r = field;
-  r *= s;
-  return r;
-}
-Scalar operator*(const Scalar &field, real_t s) { return s * field; }
-Scalar operator*(const Scalar &lhs, const Scalar &rhs) {
-  HERMES_ASSERT(lhs.data_.size() == rhs.data_.size());
-  Scalar r = lhs;
-  r *= rhs;
-  return r;
-}
-
-// math/trigonometric functions
-
-real_t sum(const Scalar &field) {
-  real_t s = 0;
-  for (h_index i = 0; i < field.data_.size(); ++i)
-    s += field.data_[i];
-  return s;
-}
-Scalar sqr(const Scalar &field) {
-  Scalar r = field;
-  r *= field;
-  return r;
-}
-Scalar sin(const Scalar &field) {
-  Scalar r = field;
-  for (h_index i = 0; i < field.data_.size(); ++i)
-    r.data_[i] = std::sin(r.data_[i]);
-  return r;
-}
-Scalar sinh(const Scalar &field) {
-  Scalar r = field;
-  for (h_index i = 0; i < field.data_.size(); ++i)
-    r.data_[i] = std::sinh(r.data_[i]);
-  return r;
-}
-Scalar abs(const Scalar &field) {
-  Scalar r = field;
-  for (h_index i = 0; i < field.data_.size(); ++i)
-    r.data_[i] = std::fabs(r.data_[i]);
-  return r;
-}
-
-} // namespace naiades::numeric
\ No newline at end of file
+} // namespace naiades::numeric
\ No newline at end of file
@@ -27,16 +27,62 @@
 
 #pragma once
 
+#include <naiades/base/parallel.h>
 #include <naiades/numeric/discrete_operator.h>
 
 #include <hermes/numeric/interval.h>
 
+#include <cmath>
+#include <concepts>
+#include <functional>
+#include <type_traits>
+
 namespace naiades::numeric {
 
+/// Base class (CRTP) of lazy scalar expressions.
+/// \note Expressions are not evaluated when built. Arithmetic operators and
+///       math functions only record the operation tree, which is evaluated
+///       element-wise in a single loop once the expression is assigned to a
+///       Scalar (or a FieldRef), accumulated into one or reduced by sum().
+///       Scalar splits the loop across threads for large fields.
+///       Evaluating an expression of N operands reads each operand once and
+///       writes the destination once, without temporary arrays.
+/// \note The destination may appear in its own expression (ex: s = s * s),
+///       since every element only depends on the same element of the
+///       operands.
+/// \tparam E Derived expression type.
+template <typename E> class ScalarExpression {
+public:
+  const E &derived() const { return static_cast<const E &>(*this); }
+  /// \return Number of elements (0 for constants, which broadcast).
+  h_size size() const { return derived().size(); }
+  real_t operator[](h_index i) const { return derived()[i]; }
+};
+
+/// Marks field view types (ex: core::FieldRef<real_t>) that can be used as
+/// operands of scalar expressions. Views are captured by value.
+template <typename T> struct is_scalar_view : std::false_type {};
+
+template <typename T>
+concept scalar_expression_type =
+    std::is_base_of_v<ScalarExpression<std::remove_cvref_t<T>>,
+                      std::remove_cvref_t<T>>;
+
+template <typename T>
+concept scalar_operand_type =
+    scalar_expression_type<T> ||
+    is_scalar_view<std::remove_cvref_t<T>>::value ||
+    std::is_arithmetic_v<std::remove_cvref_t<T>>;
+
 /// A scalar field is a multi-dimensional scalar that accepts most arithmetic
 /// operators and functions.
-class Scalar {
+/// \note Operators and functions return lazy expressions (see
+///       ScalarExpression) that are converted into a Scalar on demand.
+class Scalar : public ScalarExpression<Scalar> {
 public:
+  /// Smallest number of elements processed by a thread.
+  static constexpr h_size parallel_grain_size = 4096;
+
   static Scalar zero(h_size size);
   static Scalar one(h_size size);
   static Scalar constant(h_size size, real_t v);
@@ -44,56 +90,250 @@ public:
   Scalar() noexcept = default;
   Scalar(h_size size) noexcept;
   Scalar(const Scalar &rhs) noexcept;
+  Scalar(Scalar &&rhs) noexcept = default;
+  /// Evaluates the expression into a new scalar field.
+  template <typename E> Scalar(const ScalarExpression<E> &expr) {
+    data_.resize(expr.size());
+    assign(expr.derived());
+  }
 
   Scalar &operator=(const Scalar &rhs);
+  Scalar &operator=(Scalar &&rhs) noexcept = default;
+  template <typename E> Scalar &operator=(const ScalarExpression<E> &expr) {
+    if (data_.size() != expr.size()) {
+      // the expression may reference this field, so evaluate it aside
+      Scalar r(expr);
+      data_ = std::move(r.data_);
+      return *this;
+    }
+    assign(expr.derived());
+    return *this;
+  }
 
-  h_size size() const;
-  real_t operator[](h_index i) const;
-  real_t &operator[](h_index i);
+  h_size size() const { return data_.size(); }
+  real_t operator[](h_index i) const {
+    HERMES_ASSERT(i < data_.size());
+    return data_[i];
+  }
+  real_t &operator[](h_index i) {
+    HERMES_ASSERT(i < data_.size());
+    return data_[i];
+  }
+  const real_t *data() const { return data_.data(); }
+  real_t *data() { return data_.data(); }
   hermes::Interval<f32> valueRange() const;
 
   // arithmetic functions
 
-  Scalar &operator-=(const Scalar &rhs);
-  Scalar &operator+=(const Scalar &rhs);
-  Scalar &operator*=(const Scalar &rhs);
-  Scalar &operator/=(const Scalar &rhs);
+  template <typename E> Scalar &operator-=(const ScalarExpression<E> &expr) {
+    return update(expr.derived(), std::minus<>());
+  }
+  template <typename E> Scalar &operator+=(const ScalarExpression<E> &expr) {
+    return update(expr.derived(), std::plus<>());
+  }
+  template <typename E> Scalar &operator*=(const ScalarExpression<E> &expr) {
+    return update(expr.derived(), std::multiplies<>());
+  }
+  template <typename E> Scalar &operator/=(const ScalarExpression<E> &expr) {
+    return update(expr.derived(), std::divides<>());
+  }
   Scalar &operator-=(real_t s);
   Scalar &operator+=(real_t s);
   Scalar &operator*=(real_t s);
   Scalar &operator/=(real_t s);
 
-  friend Scalar operator+(const Scalar &lhs, const Scalar &rhs);
-  friend Scalar operator-(const Scalar &lhs, const Scalar &rhs);
-  friend Scalar operator*(real_t s, const Scalar &field);
-  friend Scalar operator*(const Scalar &field, real_t s);
-  friend Scalar operator*(const Scalar &lhs, const Scalar &rhs);
+private:
+  template <typename E> void assign(const E &expr) {
+    real_t *out = data_.data();
+    const h_size n = data_.size();
+    parallelFor(
+        0, n, [&](h_index i) { out[i] = expr[i]; },
+        ThreadPool::chunkSize(n, parallel_grain_size));
+  }
 
-  // math/trigonometric functions
+  template <typename E, typename Op> Scalar &update(const E &expr, Op op) {
+    HERMES_ASSERT(expr.size() == 0 || expr.size() == data_.size());
+    real_t *out = data_.data();
+    const h_size n = data_.size();
+    parallelFor(
+        0, n, [&](h_index i) { out[i] = op(out[i], expr[i]); },
+        ThreadPool::chunkSize(n, parallel_grain_size));
+    return *this;
+  }
 
-  friend real_t sum(const Scalar &field);
-  friend Scalar sqr(const Scalar &field);
-  friend Scalar sin(const Scalar &field);
-  friend Scalar sinh(const Scalar &field);
-  friend Scalar abs(const Scalar &field);
+  std::vector<real_t> data_;
+};
+
+/// Constant operand, broadcast to the size of the other operands.
+class ScalarConstant : public ScalarExpression<ScalarConstant> {
+public:
+  explicit ScalarConstant(real_t value) : value_{value} {}
+  h_size size() const { return 0; }
+  real_t operator[](h_index) const { return value_; }
 
 private:
-  std::vector<real_t> data_;
+  real_t value_;
 };
 
-Scalar operator+(const Scalar &lhs, const Scalar &rhs);
-Scalar operator-(const Scalar &lhs, const Scalar &rhs);
-Scalar operator*(real_t s, const Scalar &field);
-Scalar operator*(const Scalar &field, real_t s);
-Scalar operator*(const Scalar &lhs, const Scalar &rhs);
+/// Scalar field operand captured by reference.
+class ScalarReference : public ScalarExpression<ScalarReference> {
+public:
+  explicit ScalarReference(const Scalar &field) : data_{field.data()},
+                                                   size_{field.size()} {}
+  h_size size() const { return size_; }
+  real_t operator[](h_index i) const { return data_[i]; }
+
+private:
+  const real_t *data_;
+  h_size size_;
+};
+
+/// Field view operand (see is_scalar_view) captured by value.
+template <typename V>
+class ScalarView : public ScalarExpression<ScalarView<V>> {
+public:
+  explicit ScalarView(const V &view) : view_{view} {}
+  h_size size() const { return view_.size(); }
+  real_t operator[](h_index i) const {
+    return static_cast<real_t>(view_[i]);
+  }
+
+private:
+  V view_;
+};
+
+/// Element-wise unary operation node.
+template <typename Op, typename E>
+class ScalarUnaryExpression
+    : public ScalarExpression<ScalarUnaryExpression<Op, E>> {
+public:
+  explicit ScalarUnaryExpression(E expr) : expr_{std::move(expr)} {}
+  h_size size() const { return expr_.size(); }
+  real_t operator[](h_index i) const { return Op()(expr_[i]); }
+
+private:
+  E expr_;
+};
+
+/// Element-wise binary operation node.
+template <typename Op, typename L, typename R>
+class ScalarBinaryExpression
+    : public ScalarExpression<ScalarBinaryExpression<Op, L, R>> {
+public:
+  ScalarBinaryExpression(L lhs, R rhs)
+      : lhs_{std::move(lhs)}, rhs_{std::move(rhs)} {
+    HERMES_ASSERT(lhs_.size() == 0 || rhs_.size() == 0 ||
+                  lhs_.size() == rhs_.size());
+  }
+  h_size size() const { return lhs_.size() ? lhs_.size() : rhs_.size(); }
+  real_t operator[](h_index i) const { return Op()(lhs_[i], rhs_[i]); }
+
+private:
+  L lhs_;
+  R rhs_;
+};
+
+/// Wraps a value into the node stored by an expression.
+/// \note Named scalar fields are referenced, temporary fields are moved into
+///       the expression and expressions and views are copied.
+template <scalar_operand_type T> auto makeScalarOperand(T &&value) {
+  using U = std::remove_cvref_t<T>;
+  if constexpr (std::is_arithmetic_v<U>)
+    return ScalarConstant(static_cast<real_t>(value));
+  else if constexpr (is_scalar_view<U>::value)
+    return ScalarView<U>(value);
+  else if constexpr (std::is_same_v<U, Scalar> &&
+                     std::is_lvalue_reference_v<T>)
+    return ScalarReference(value);
+  else
+    return U(std::forward<T>(value));
+}
+
+template <typename T>
+using scalar_operand_t = decltype(makeScalarOperand(std::declval<T>()));
+
+template <typename L, typename R>
+concept scalar_binary_operands =
+    scalar_operand_type<L> && scalar_operand_type<R> &&
+    !(std::is_arithmetic_v<std::remove_cvref_t<L>> &&
+      std::is_arithmetic_v<std::remove_cvref_t<R>>);
+
+template <typename Op, typename L, typename R>
+auto makeScalarExpression(L &&lhs, R &&rhs) {
+  return ScalarBinaryExpression<Op, scalar_operand_t<L>, scalar_operand_t<R>>(
+      makeScalarOperand(std::forward<L>(lhs)),
+      makeScalarOperand(std::forward<R>(rhs)));
+}
+
+template <typename Op, typename E> auto makeScalarExpression(E &&expr) {
+  return ScalarUnaryExpression<Op, scalar_operand_t<E>>(
+      makeScalarOperand(std::forward<E>(expr)));
+}
+
+// arithmetic functions
+
+template <typename L, typename R>
+  requires scalar_binary_operands<L, R>
+auto operator+(L &&lhs, R &&rhs) {
+  return makeScalarExpression<std::plus<>>(std::forward<L>(lhs),
+                                           std::forward<R>(rhs));
+}
+template <typename L, typename R>
+  requires scalar_binary_operands<L, R>
+auto operator-(L &&lhs, R &&rhs) {
+  return makeScalarExpression<std::minus<>>(std::forward<L>(lhs),
+                                            std::forward<R>(rhs));
+}
+template <typename L, typename R>
+  requires scalar_binary_operands<L, R>
+auto operator*(L &&lhs, R &&rhs) {
+  return makeScalarExpression<std::multiplies<>>(std::forward<L>(lhs),
+                                                 std::forward<R>(rhs));
+}
+template <typename L, typename R>
+  requires scalar_binary_operands<L, R>
+auto operator/(L &&lhs, R &&rhs) {
+  return makeScalarExpression<std::divides<>>(std::forward<L>(lhs),
+                                              std::forward<R>(rhs));
+}
+template <scalar_expression_type E> auto operator-(E &&expr) {
+  return makeScalarExpression<std::negate<>>(std::forward<E>(expr));
+}
 
 // math/trigonometric functions
 
-real_t sum(const Scalar &field);
-Scalar sqr(const Scalar &field);
-Scalar sin(const Scalar &field);
-Scalar sinh(const Scalar &field);
-Scalar abs(const Scalar &field);
+struct ScalarSqr {
+  real_t operator()(real_t v) const { return v * v; }
+};
+struct ScalarSin {
+  real_t operator()(real_t v) const { return std::sin(v); }
+};
+struct ScalarSinh {
+  real_t operator()(real_t v) const { return std::sinh(v); }
+};
+struct ScalarAbs {
+  real_t operator()(real_t v) const { return std::fabs(v); }
+};
+
+template <typename E> real_t sum(const ScalarExpression<E> &expr) {
+  const E &e = expr.derived();
+  const h_size n = e.size();
+  return parallelReduce(
+      0, n, real_t(0), [&](h_index i) { return e[i]; }, std::plus<>(),
+      ThreadPool::chunkSize(n, Scalar::parallel_grain_size));
+}
+template <scalar_expression_type E> auto sqr(E &&expr) {
+  return makeScalarExpression<ScalarSqr>(std::forward<E>(expr));
+}
+template <scalar_expression_type E> auto sin(E &&expr) {
+  return makeScalarExpression<ScalarSin>(std::forward<E>(expr));
+}
+template <scalar_expression_type E> auto sinh(E &&expr) {
+  return makeScalarExpression<ScalarSinh>(std::forward<E>(expr));
+}
+template <scalar_expression_type E> auto abs(E &&expr) {
+  return makeScalarExpression<ScalarAbs>(std::forward<E>(expr));
+}
 
 /// a += k * b
 // template <typename T>
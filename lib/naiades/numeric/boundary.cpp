@@ -26,8 +26,27 @@
 
 #include <naiades/numeric/boundary.h>
 
+#include <naiades/base/parallel.h>
+
+#include <algorithm>
+#include <bit>
+
 namespace naiades::numeric {
 
+namespace {
+
+// the lookup is indexed directly while it spans at most this many entries per
+// boundary element
+constexpr h_size max_dense_lookup_ratio = 4;
+
+/// Fibonacci hashing: the top (64 - shift) bits of key * 2^64 / phi.
+h_size lookupSlot(h_size key, u32 shift) {
+  return static_cast<h_size>((static_cast<u64>(key) * 0x9E3779B97F4A7C15ull) >>
+                             shift);
+}
+
+} // namespace
+
 Boundary::Region::Region(const core::Element &element_type,
                          const std::vector<h_size> &indices)
     : boundary_element_type_{element_type},
@@ -49,16 +68,15 @@ NaResult Boundary::Region::resolve(core::Topology::Ptr topology) {
   if (!(bool)condition_)
     return NaResult::checkError();
   stencils_.resize(index_set_.size());
-  for (auto it : index_set_) {
+  parallelFor(0, index_set_.size(), [&](h_index i) {
     auto boundary_element =
-        core::ElementIndex::global(boundary_element_type_, it.global_index);
+        core::ElementIndex::global(boundary_element_type_, index_set_[i]);
     auto interior_index =
         topology->interiorNeighbour(boundary_element, interior_element_type_);
     auto interior_element =
         core::ElementIndex::global(interior_element_type_, interior_index);
-    stencils_[it.local_set_index] =
-        condition_->resolve(boundary_element, interior_element);
-  }
+    stencils_[i] = condition_->resolve(boundary_element, interior_element);
+  });
   return NaResult::noError();
 }
 
@@ -103,6 +121,8 @@ Boundary &Boundary::addRegion(const std::vector<h_size> &indices,
   if (region_index)
     *region_index = regions_.size();
   regions_.emplace_back(boundary_element_type_, indices);
+  // the new region has no stencils until the next resolve()
+  lookup_.clear();
   return *this;
 }
 
@@ -120,11 +140,73 @@ Boundary &Boundary::setCondition(bc::BoundaryCondition::Ptr condition) {
 }
 
 NaResult Boundary::resolve(core::Topology::Ptr topology) {
+  lookup_.clear();
   for (auto &region : regions_)
     NAIADES_RETURN_BAD_RESULT(region.resolve(topology));
+  buildLookup();
   return NaResult::noError();
 }
 
+void Boundary::buildLookup() {
+  lookup_.clear();
+  lookup_first_ = 0;
+  lookup_shift_ = 0;
+  h_size count = 0;
+  h_size first = LookupEntry::invalid_key;
+  h_size last = 0;
+  for (const auto &region : regions_)
+    for (const auto &item : region.index_set_) {
+      first = std::min(first, item.global_index);
+      last = std::max(last, item.global_index);
+      ++count;
+    }
+  if (!count)
+    return;
+
+  if (last - first < max_dense_lookup_ratio * count) {
+    lookup_first_ = first;
+    lookup_.resize(last - first + 1);
+  } else {
+    // at most half of the table is used, so probe sequences stay short
+    const u32 bits = std::bit_width(2 * count - 1);
+    lookup_shift_ = 64 - bits;
+    lookup_.resize(h_size(1) << bits);
+  }
+  const h_size mask = lookup_.size() - 1;
+  for (u32 r = 0; r < regions_.size(); ++r)
+    for (const auto &item : regions_[r].index_set_) {
+      const h_size key = item.global_index;
+      h_size slot = key - lookup_first_;
+      if (lookup_shift_) {
+        slot = lookupSlot(key, lookup_shift_);
+        while (lookup_[slot].key != LookupEntry::invalid_key &&
+               lookup_[slot].key != key)
+          slot = (slot + 1) & mask;
+      }
+      // overlapping regions keep the stencil of the first region
+      if (lookup_[slot].key == LookupEntry::invalid_key)
+        lookup_[slot] = {key, r, static_cast<u32>(item.local_set_index)};
+    }
+}
+
+const Boundary::LookupEntry *Boundary::findEntry(h_size global_index) const {
+  if (!lookup_shift_) {
+    const h_size slot = global_index - lookup_first_;
+    if (global_index < lookup_first_ || slot >= lookup_.size() ||
+        lookup_[slot].key != global_index)
+      return nullptr;
+    return &lookup_[slot];
+  }
+  const h_size mask = lookup_.size() - 1;
+  for (h_size slot = lookupSlot(global_index, lookup_shift_);;
+       slot = (slot + 1) & mask) {
+    if (lookup_[slot].key == global_index)
+      return &lookup_[slot];
+    if (lookup_[slot].key == LookupEntry::invalid_key)
+      return nullptr;
+  }
+}
+
 const core::Element &Boundary::boundaryElement() const {
   return boundary_element_type_;
 }
@@ -134,15 +216,20 @@ const core::Element &Boundary::interiorElement() const {
 }
 
 const DiscreteOperator &Boundary::stencil(const core::Index &index) const {
-  for (const auto &region : regions_)
-    if (region.contains(index))
-      return region.stencil(index);
+  if (!lookup_.empty() && !index.isLocal()) {
+    if (const auto *entry = findEntry(*index))
+      return regions_[entry->region].stencils_[entry->index];
+  } else {
+    for (const auto &region : regions_)
+      if (region.contains(index))
+        return region.stencil(index);
+  }
   HERMES_WARN("Index {} not found in boundary.", hermes::to_string(index));
   static DiscreteOperator s_dop;
   return s_dop;
 }
 
-const std::vector<Boundary::Region> Boundary::regions() const {
+const std::vector<Boundary::Region> &Boundary::regions() const {
   return regions_;
 }
 
@@ -152,9 +239,10 @@ NaResult Boundary::Region::compute(core::FieldCRef<f32> interior_field,
     HERMES_ERROR("Boundary region not resolved before compute!");
     return NaResult::checkError();
   }
-  for (auto i : index_set_)
-    field.at(core::Index::global(i.global_index)) =
-        stencils_[i.local_set_index](interior_field);
+  parallelFor(0, index_set_.size(), [&](h_index i) {
+    field.at(core::Index::global(index_set_[i])) =
+        stencils_[i](interior_field);
+  });
   return NaResult::noError();
 }
 
@@ -131,17 +131,42 @@ public:
   NaResult compute(core::FieldCRef<f32> interior_field,
                    core::FieldRef<f32> boundary_field) const;
 
+  /// Builds the boundary stencils of all regions and the stencil lookup.
   NaResult resolve(core::Topology::Ptr topology);
 
   const core::Element &boundaryElement() const;
   const core::Element &interiorElement() const;
+  /// \return The stencil of the boundary element index. Global indices of a
+  ///         resolved boundary are found in constant time.
+  /// \note If regions overlap, the stencil of the first region is returned.
   const DiscreteOperator &stencil(const core::Index &index) const;
-  const std::vector<Region> regions() const;
+  const std::vector<Region> &regions() const;
 
 private:
+  /// Stencil location of a global boundary element index.
+  struct LookupEntry {
+    h_size key{invalid_key};
+    u32 region{0};
+    u32 index{0};
+
+    static constexpr h_size invalid_key = ~h_size(0);
+  };
+
+  /// Maps the global indices of all regions into their stencils.
+  void buildLookup();
+  /// \return The entry of the global index, or nullptr if it is not a
+  ///         boundary element.
+  const LookupEntry *findEntry(h_size global_index) const;
+
   core::Element boundary_element_type_{core::Element::Type::FACE};
   core::Element interior_element_type_{core::Element::Type::CELL};
   std::vector<Region> regions_;
+  // Stencil lookup, built at resolve(). Entries are either indexed directly by
+  // (global index - lookup_first_), or hashed into an open addressing table
+  // when boundary indices are too sparse (lookup_shift_ > 0).
+  std::vector<LookupEntry> lookup_;
+  h_size lookup_first_{0};
+  u32 lookup_shift_{0};
 
 #ifdef NAIADES_INCLUDE_DEBUG_TRAITS
   friend struct hermes::DebugTraits<Boundary>;
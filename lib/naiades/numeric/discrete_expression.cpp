@@ -26,26 +26,104 @@
 
 #include <naiades/numeric/discrete_expression.h>
 
+#include <naiades/base/parallel.h>
+
+#include <algorithm>
+
 namespace naiades::numeric {
 
-DiscreteExpression::iterator::iterator(
-    const DiscreteExpression &de,
-    std::unordered_map<h_index, DiscreteOperator>::const_iterator it)
-    : de_{de}, it_{it} {}
+namespace {
+
+/// Resizes the range [start, end) of v to count elements, shifting the
+/// elements after it once. New elements are left unspecified.
+template <typename T>
+void resizeRange(std::vector<T> &v, h_size start, h_size end, h_size count) {
+  const h_size old_count = end - start;
+  if (count < old_count) {
+    std::move(v.begin() + end, v.end(), v.begin() + start + count);
+    v.resize(v.size() - (old_count - count));
+  } else if (count > old_count) {
+    const h_size old_size = v.size();
+    v.resize(old_size + (count - old_count));
+    std::move_backward(v.begin() + end, v.begin() + old_size, v.end());
+  }
+}
+
+/// Segments are split at this size so large uniform ranges still spread over
+/// all threads.
+constexpr h_size max_segment_size = 4096;
+
+/// Evaluates rows [first, last) that all equal the uniform stencil. S is the
+/// stencil size (0 if only known at runtime).
+template <h_size S, bool Add>
+void applyUniform(std::span<const i64> offsets, std::span<const real_t> weights,
+                  real_t constant, h_size first, h_size last, real_t alpha,
+                  const core::FieldCRef<real_t> &in,
+                  core::FieldRef<real_t> &out) {
+  if constexpr (S == 0) {
+    for (h_index i = first; i < last; ++i) {
+      real_t s = constant;
+      for (h_size k = 0; k < offsets.size(); ++k)
+        s += weights[k] * in[static_cast<h_index>(static_cast<i64>(i) +
+                                                   offsets[k])];
+      if constexpr (Add)
+        out[i] += alpha * s;
+      else
+        out[i] = s;
+    }
+  } else {
+    // local copies, so they are not reloaded after every store to out
+    i64 o[S];
+    real_t w[S];
+    for (h_size k = 0; k < S; ++k) {
+      o[k] = offsets[k];
+      w[k] = weights[k];
+    }
+    for (h_index i = first; i < last; ++i) {
+      real_t s = constant;
+      for (h_size k = 0; k < S; ++k)
+        s += w[k] * in[static_cast<h_index>(static_cast<i64>(i) + o[k])];
+      if constexpr (Add)
+        out[i] += alpha * s;
+      else
+        out[i] = s;
+    }
+  }
+}
+
+} // namespace
+
+h_size DiscreteExpression::Row::centerIndex() const { return center_index_; }
+
+h_size DiscreteExpression::Row::size() const { return size_; }
+
+std::span<const h_size> DiscreteExpression::Row::columns() const & {
+  return {columns_ ? columns_ : &default_column_, size_};
+}
+
+std::span<const real_t> DiscreteExpression::Row::weights() const & {
+  return {columns_ ? weights_ : &default_weight_, size_};
+}
+
+real_t DiscreteExpression::Row::constant() const { return constant_; }
 
-const DiscreteOperator &DiscreteExpression::iterator::operator*() const {
-  return it_->second;
+DiscreteExpression::iterator::iterator(const DiscreteExpression &de,
+                                       h_size row)
+    : de_{de}, row_{row} {}
+
+DiscreteExpression::Row DiscreteExpression::iterator::operator*() const {
+  return de_[row_];
 }
 
 DiscreteExpression::iterator &DiscreteExpression::iterator::operator++() {
-  if (it_ != de_.entries_.end())
-    it_++;
+  if (row_ < de_.size())
+    row_++;
   return *this;
 }
 
 bool DiscreteExpression::iterator::operator==(
     const DiscreteExpression::iterator &rhs) const {
-  return it_ == rhs.it_;
+  return row_ == rhs.row_;
 }
 
 DiscreteExpression::DiscreteExpression(const core::DiscreteSymbol &sym) noexcept
@@ -54,9 +132,73 @@ DiscreteExpression::DiscreteExpression(const core::DiscreteSymbol &sym) noexcept
 DiscreteExpression::DiscreteExpression(real_t value) noexcept
     : default_coefficient_{1.0}, default_constant_{value} {}
 
+void DiscreteExpression::reserve(h_size row_count, h_size node_count) {
+  row_offsets_.reserve(row_count + 1);
+  constants_.reserve(row_count);
+  columns_.reserve(node_count);
+  weights_.reserve(node_count);
+}
+
+void DiscreteExpression::appendRow(const DiscreteOperator &e) {
+  if (row_offsets_.empty())
+    row_offsets_.emplace_back(0);
+  for (const auto &node : e.nodes()) {
+    columns_.emplace_back(node.first);
+    weights_.emplace_back(node.second);
+  }
+  constants_.emplace_back(e.constant());
+  row_offsets_.emplace_back(columns_.size());
+}
+
+void DiscreteExpression::appendDefaultRow(h_index index) {
+  if (row_offsets_.empty())
+    row_offsets_.emplace_back(0);
+  columns_.emplace_back(index);
+  weights_.emplace_back(default_coefficient_);
+  constants_.emplace_back(default_constant_);
+  row_offsets_.emplace_back(columns_.size());
+}
+
 void DiscreteExpression::addIndexEntry(h_index index, DiscreteOperator &&e) {
   HERMES_ASSERT(sym_.has_value());
-  entries_[index] = e;
+  segments_.clear();
+  // fill skipped rows with the mono-stencil
+  for (h_index i = size(); i < index; ++i)
+    appendDefaultRow(i);
+  if (index == size()) {
+    appendRow(e);
+    return;
+  }
+  // replace an existing row
+  const auto start = row_offsets_[index];
+  const auto end = row_offsets_[index + 1];
+  const auto &nodes = e.nodes();
+  const i64 delta = static_cast<i64>(nodes.size()) - static_cast<i64>(end - start);
+  // shift the following rows once and overwrite the row in place
+  resizeRange(columns_, start, end, nodes.size());
+  resizeRange(weights_, start, end, nodes.size());
+  for (h_size k = 0; k < nodes.size(); ++k) {
+    columns_[start + k] = nodes[k].first;
+    weights_[start + k] = nodes[k].second;
+  }
+  for (h_size r = index + 1; r < row_offsets_.size(); ++r)
+    row_offsets_[r] += delta;
+  constants_[index] = e.constant();
+}
+
+void DiscreteExpression::setRows(std::vector<h_size> &&row_offsets,
+                                 std::vector<h_size> &&columns,
+                                 std::vector<real_t> &&weights,
+                                 std::vector<real_t> &&constants) {
+  HERMES_ASSERT(sym_.has_value());
+  HERMES_ASSERT(row_offsets.size() == constants.size() + 1);
+  HERMES_ASSERT(columns.size() == weights.size() &&
+                columns.size() == row_offsets.back());
+  row_offsets_ = std::move(row_offsets);
+  columns_ = std::move(columns);
+  weights_ = std::move(weights);
+  constants_ = std::move(constants);
+  classifyRows();
 }
 
 const core::Symbol &DiscreteExpression::symbol() const {
@@ -69,40 +211,73 @@ const core::Symbol &DiscreteExpression::symbol() const {
 
 bool DiscreteExpression::isConstant() const { return !sym_.has_value(); }
 
-const DiscreteOperator &DiscreteExpression::operator[](h_index index) const {
-  static DiscreteOperator s_dop;
+DiscreteExpression::Row DiscreteExpression::operator[](h_index index) const {
+  Row row;
+  row.center_index_ = index;
   if (!sym_.has_value()) {
-    s_dop = DiscreteOperator();
-    s_dop.setConstant(default_constant_);
-    return s_dop;
+    row.constant_ = default_constant_;
+    return row;
+  }
+  if (index < size()) {
+    row.size_ = row_offsets_[index + 1] - row_offsets_[index];
+    row.columns_ = columns_.data() + row_offsets_[index];
+    row.weights_ = weights_.data() + row_offsets_[index];
+    row.constant_ = constants_[index];
+    return row;
   }
-  auto it = entries_.find(index);
-  if (it != entries_.end())
-    return it->second;
   // fallback to mono-stencil
-  s_dop = DiscreteOperator(index);
-  s_dop.add(index, default_coefficient_);
-  s_dop.setConstant(default_constant_);
-  return s_dop;
+  row.size_ = 1;
+  row.default_column_ = index;
+  row.default_weight_ = default_coefficient_;
+  row.constant_ = default_constant_;
+  return row;
 }
 
-h_size DiscreteExpression::size() const { return entries_.size(); }
+real_t DiscreteExpression::constant(h_index index) const {
+  if (sym_.has_value() && index < size())
+    return constants_[index];
+  return default_constant_;
+}
+
+h_size DiscreteExpression::size() const { return constants_.size(); }
+
+h_size DiscreteExpression::nodeCount() const { return columns_.size(); }
+
+std::span<const h_size> DiscreteExpression::rowOffsets() const {
+  return row_offsets_;
+}
+
+std::span<const h_size> DiscreteExpression::columns() const {
+  return columns_;
+}
+
+std::span<const real_t> DiscreteExpression::weights() const {
+  return weights_;
+}
+
+std::span<const real_t> DiscreteExpression::constants() const {
+  return constants_;
+}
 
 DiscreteExpression::iterator DiscreteExpression::begin() const {
-  return DiscreteExpression::iterator(*this, entries_.begin());
+  return DiscreteExpression::iterator(*this, 0);
 }
 
 DiscreteExpression::iterator DiscreteExpression::end() const {
-  return DiscreteExpression::iterator(*this, entries_.end());
+  return DiscreteExpression::iterator(*this, size());
 }
 
 DiscreteExpression DiscreteExpression::operator-() const {
-  DiscreteExpression r;
-  r.sym_ = sym_;
+  DiscreteExpression r = *this;
   r.default_coefficient_ = -default_coefficient_;
   r.default_constant_ = -default_constant_;
-  for (const auto &item : entries_)
-    r.entries_[item.first] = -item.second;
+  for (auto &w : r.weights_)
+    w = -w;
+  for (auto &c : r.constants_)
+    c = -c;
+  for (auto &w : r.uniform_weights_)
+    w = -w;
+  r.uniform_constant_ = -uniform_constant_;
   return r;
 }
 
@@ -111,38 +286,204 @@ DiscreteExpression::operator+(const DiscreteExpression &rhs) const {
   DiscreteExpression r;
   // sum default_constant values
   r.default_constant_ = default_constant_ + rhs.default_constant_;
-  r.default_coefficient_ = default_coefficient_ + rhs.default_coefficient_;
   // here we need to handle symbol cases
   if (sym_.has_value() && rhs.sym_.has_value()) {
     HERMES_ASSERT(*sym_ == *rhs.sym_);
     r.sym_ = sym_;
+    r.default_coefficient_ = default_coefficient_ + rhs.default_coefficient_;
 
-    // for all in lhs add the correspondent in rhs
-    // note that unexistent indices in rhs should return the mono-stencil
-    for (const auto &item : entries_) {
-      r.entries_[item.first] += rhs[item.first];
-    }
-
-    // for all in rhs (not caught by the loop above) add to new indices in lhs
-    for (const auto &item : rhs.entries_) {
-      if (!entries_.count(item.first)) {
-        r.entries_[item.first] = (*this)[item.first] + item.second;
+    // merge rows of both sides, note that rows missing in one of the sides
+    // are the mono-stencil
+    const h_size n = std::max(size(), rhs.size());
+    r.reserve(n, nodeCount() + rhs.nodeCount());
+    r.row_offsets_.emplace_back(0);
+    for (h_size row = 0; row < n; ++row) {
+      const h_size default_column = row;
+      const h_size *a_columns = &default_column;
+      const h_size *b_columns = &default_column;
+      const real_t *a_weights = &default_coefficient_;
+      const real_t *b_weights = &rhs.default_coefficient_;
+      h_size a_size = 1, b_size = 1;
+      real_t constant = 0;
+      if (row < size()) {
+        a_columns = columns_.data() + row_offsets_[row];
+        a_weights = weights_.data() + row_offsets_[row];
+        a_size = row_offsets_[row + 1] - row_offsets_[row];
+        constant += constants_[row];
+      } else
+        constant += default_constant_;
+      if (row < rhs.size()) {
+        b_columns = rhs.columns_.data() + rhs.row_offsets_[row];
+        b_weights = rhs.weights_.data() + rhs.row_offsets_[row];
+        b_size = rhs.row_offsets_[row + 1] - rhs.row_offsets_[row];
+        constant += rhs.constants_[row];
+      } else
+        constant += rhs.default_constant_;
+      // sorted merge of both rows
+      h_size a = 0, b = 0;
+      while (a < a_size || b < b_size) {
+        if (b == b_size || (a < a_size && a_columns[a] < b_columns[b])) {
+          r.columns_.emplace_back(a_columns[a]);
+          r.weights_.emplace_back(a_weights[a++]);
+        } else if (a == a_size || b_columns[b] < a_columns[a]) {
+          r.columns_.emplace_back(b_columns[b]);
+          r.weights_.emplace_back(b_weights[b++]);
+        } else {
+          r.columns_.emplace_back(a_columns[a]);
+          r.weights_.emplace_back(a_weights[a++] + b_weights[b++]);
+        }
       }
+      r.constants_.emplace_back(constant);
+      r.row_offsets_.emplace_back(r.columns_.size());
     }
+    r.classifyRows();
 
-  } else if (sym_.has_value() && !rhs.sym_.has_value()) {
-    r.sym_ = sym_;
-    for (const auto &item : entries_) {
-      r.entries_[item.first] += rhs[item.first];
+  } else if (sym_.has_value() || rhs.sym_.has_value()) {
+    // symbolic expression plus constant
+    const auto &symbolic = sym_.has_value() ? *this : rhs;
+    const real_t constant =
+        sym_.has_value() ? rhs.default_constant_ : default_constant_;
+    r = symbolic;
+    r.default_constant_ += constant;
+    r.uniform_constant_ += constant;
+    for (auto &c : r.constants_)
+      c += constant;
+  }
+
+  return r;
+}
+
+void DiscreteExpression::apply(core::FieldCRef<real_t> in,
+                               core::FieldRef<real_t> out) const {
+  evaluate<false>(1, in, out);
+}
+
+void DiscreteExpression::axpy(real_t alpha, core::FieldCRef<real_t> in,
+                              core::FieldRef<real_t> out) const {
+  evaluate<true>(alpha, in, out);
+}
+
+template <bool Add>
+void DiscreteExpression::evaluate(real_t alpha,
+                                  const core::FieldCRef<real_t> &in,
+                                  core::FieldRef<real_t> &out) const {
+  const auto store = [&](h_index i, real_t s) {
+    if constexpr (Add)
+      out[i] += alpha * s;
+    else
+      out[i] = s;
+  };
+  if (!sym_.has_value()) {
+    parallelFor(0, out.size(), [&](h_index i) { store(i, default_constant_); });
+    return;
+  }
+  const h_size n = std::min(size(), out.size());
+
+  // rows added one by one are not classified, read them all from the arrays
+  std::vector<Segment> general;
+  if (segments_.empty())
+    for (h_size first = 0; first < n; first += max_segment_size)
+      general.push_back({first, std::min(n, first + max_segment_size), false});
+  const auto &segments = segments_.empty() ? general : segments_;
+
+  parallelFor(
+      0, segments.size(),
+      [&](h_index k) {
+        const auto &segment = segments[k];
+        const h_size first = std::min(segment.first, n);
+        const h_size last = std::min(segment.last, n);
+        if (segment.uniform) {
+          const auto run = [&](auto width) {
+            applyUniform<decltype(width)::value, Add>(
+                uniform_offsets_, uniform_weights_, uniform_constant_, first,
+                last, alpha, in, out);
+          };
+          switch (uniform_offsets_.size()) {
+          case 3:
+            return run(std::integral_constant<h_size, 3>{});
+          case 5:
+            return run(std::integral_constant<h_size, 5>{});
+          default:
+            return run(std::integral_constant<h_size, 0>{});
+          }
+        }
+        for (h_index i = first; i < last; ++i) {
+          real_t s = constants_[i];
+          for (h_size j = row_offsets_[i]; j < row_offsets_[i + 1]; ++j)
+            s += weights_[j] * in[columns_[j]];
+          store(i, s);
+        }
+      },
+      1);
+
+  // past the stored rows
+  parallelFor(n, out.size(), [&](h_index i) {
+    store(i, default_coefficient_ * in[i] + default_constant_);
+  });
+}
+
+void DiscreteExpression::classifyRows() {
+  segments_.clear();
+  uniform_offsets_.clear();
+  uniform_weights_.clear();
+  uniform_constant_ = 0;
+  const h_size n = size();
+  if (!n)
+    return;
+  // rows equal to a reference row (same column offsets and coefficients)
+  const auto equalRows = [&](h_size a, h_size b) {
+    const h_size size = row_offsets_[a + 1] - row_offsets_[a];
+    if (row_offsets_[b + 1] - row_offsets_[b] != size ||
+        constants_[a] != constants_[b])
+      return false;
+    for (h_size k = 0; k < size; ++k) {
+      const h_size ka = row_offsets_[a] + k;
+      const h_size kb = row_offsets_[b] + k;
+      if (static_cast<i64>(columns_[ka]) - static_cast<i64>(a) !=
+              static_cast<i64>(columns_[kb]) - static_cast<i64>(b) ||
+          weights_[ka] != weights_[kb])
+        return false;
     }
-  } else if (!sym_.has_value() && rhs.sym_.has_value()) {
-    r.sym_ = rhs.sym_;
-    for (const auto &item : rhs.entries_) {
-      r.entries_[item.first] = (*this)[item.first] + item.second;
+    return true;
+  };
+  // the most frequent stencil among sampled rows (the interior of structured
+  // discretizations), samples are scattered so they do not align with grid
+  // rows
+  constexpr h_size sample_count = 16;
+  const auto sample = [&](h_size a) {
+    return static_cast<h_size>((a + 1) * 2654435761ull % n);
+  };
+  h_size reference = 0;
+  h_size reference_votes = 0;
+  for (h_size a = 0; a < sample_count; ++a) {
+    const h_size row = sample(a);
+    h_size votes = 0;
+    for (h_size b = 0; b < sample_count; ++b)
+      votes += equalRows(row, sample(b));
+    if (votes > reference_votes) {
+      reference = row;
+      reference_votes = votes;
     }
   }
+  for (h_size k = row_offsets_[reference]; k < row_offsets_[reference + 1];
+       ++k) {
+    uniform_offsets_.emplace_back(static_cast<i64>(columns_[k]) -
+                                  static_cast<i64>(reference));
+    uniform_weights_.emplace_back(weights_[k]);
+  }
+  uniform_constant_ = constants_[reference];
 
-  return r;
+  std::vector<u8> uniform(n);
+  parallelFor(0, n,
+              [&](h_index i) { uniform[i] = equalRows(i, reference); });
+  for (h_size first = 0; first < n;) {
+    h_size last = first + 1;
+    while (last < n && uniform[last] == uniform[first] &&
+           last - first < max_segment_size)
+      ++last;
+    segments_.push_back({first, last, uniform[first] != 0});
+    first = last;
+  }
 }
 
-} // namespace naiades::numeric
\ No newline at end of file
+} // namespace naiades::numeric
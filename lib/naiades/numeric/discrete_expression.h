@@ -27,10 +27,13 @@
 
 #pragma once
 
+#include <naiades/core/field.h>
 #include <naiades/core/symbol.h>
 #include <naiades/numeric/discrete_operator.h>
 
 #include <optional>
+#include <span>
+#include <vector>
 
 namespace naiades::numeric {
 
@@ -51,12 +54,63 @@ namespace naiades::numeric {
 /// The discrete expression can be an explicit expression as well, i.e. a
 /// constant. In this case, there is no symbol associated and discrete operators
 /// are the same for all indices.
+///
+/// \note Operators are stored in compressed sparse row (CSR) form, where row i
+///       holds the operator centered at element i. Rows are kept contiguous in
+///       flat arrays of column indices, weights and constants, so evaluation
+///       and assembly are streaming passes over memory. Columns are sorted
+///       within each row.
 class DiscreteExpression {
 public:
-  ///
+  /// Read-only view of the operator of a single row. Stored rows point into
+  /// the CSR arrays, mono-stencil and constant rows are held by the view
+  /// itself, so views are built without allocation and are safe to use from
+  /// many threads.
+  /// \note Views of stored rows are invalidated when the expression changes.
+  class Row {
+  public:
+    /// \return The index of the element this row is centered at.
+    h_size centerIndex() const;
+    /// \return Number of stencil nodes.
+    h_size size() const;
+    /// \return Element indices of the stencil nodes.
+    /// \note Spans of rows that are not stored point into this view, so they
+    ///       are not available from temporary rows.
+    std::span<const h_size> columns() const &;
+    std::span<const h_size> columns() const && = delete;
+    /// \return Weights of the stencil nodes.
+    std::span<const real_t> weights() const &;
+    std::span<const real_t> weights() const && = delete;
+    real_t constant() const;
+    /// Computes this row for the given field.
+    template <typename FieldType>
+    real_t operator()(const FieldType &field) const {
+      const auto *columns = columns_ ? columns_ : &default_column_;
+      const auto *weights = columns_ ? weights_ : &default_weight_;
+      real_t s = constant_;
+      for (h_size i = 0; i < size_; ++i)
+        s += field[core::Index::global(columns[i])] * weights[i];
+      return s;
+    }
+
+  private:
+    friend class DiscreteExpression;
+
+    h_size center_index_{0};
+    /// null if the row is not stored (see default_column_)
+    const h_size *columns_{nullptr};
+    const real_t *weights_{nullptr};
+    h_size size_{0};
+    real_t constant_{0};
+    /// mono-stencil node of rows that are not stored
+    h_size default_column_{0};
+    real_t default_weight_{0};
+  };
+
+  /// Iterates over the stored rows.
   class iterator {
   public:
-    const DiscreteOperator &operator*() const;
+    Row operator*() const;
     iterator &operator++();
 
     bool operator==(const iterator &rhs) const;
@@ -64,11 +118,10 @@ public:
   private:
     friend class DiscreteExpression;
 
-    iterator(const DiscreteExpression &de_,
-             std::unordered_map<h_index, DiscreteOperator>::const_iterator it);
+    iterator(const DiscreteExpression &de_, h_size row);
 
     const DiscreteExpression &de_;
-    std::unordered_map<h_index, DiscreteOperator>::const_iterator it_;
+    h_size row_;
   };
 
   DiscreteExpression() = default;
@@ -76,23 +129,75 @@ public:
   DiscreteExpression(real_t constant) noexcept;
   virtual ~DiscreteExpression() = default;
 
+  /// Pre-allocates storage for the given number of rows and stencil nodes.
+  /// \param row_count
+  /// \param node_count
+  void reserve(h_size row_count, h_size node_count = 0);
   /// Register an indexed entry to this expression.
+  /// \note Entries are cheaper when added in increasing index order, as rows
+  ///       are appended to the CSR arrays. Rows skipped by the given index
+  ///       are filled with the mono-stencil.
   /// \param index
   /// \param e
   void addIndexEntry(h_index index, DiscreteOperator &&e);
+  /// Replaces all stored rows by the given CSR arrays (see rowOffsets()).
+  /// \note Columns must be sorted within each row.
+  /// \param row_offsets Row offsets (constants.size() + 1 entries).
+  /// \param columns
+  /// \param weights
+  /// \param constants Constant term per row.
+  void setRows(std::vector<h_size> &&row_offsets,
+               std::vector<h_size> &&columns, std::vector<real_t> &&weights,
+               std::vector<real_t> &&constants);
 
   /// \brief
   /// \return
   const core::Symbol &symbol() const;
   bool isConstant() const;
 
-  ///
-  const DiscreteOperator &operator[](h_index index) const;
+  /// \return The operator at the given index. Indices past the stored rows
+  ///         hold the mono-stencil, and constant expressions hold rows
+  ///         without nodes.
+  Row operator[](h_index index) const;
+  /// \return The constant term of the operator at the given index.
+  real_t constant(h_index index) const;
+  /// \return The number of stored rows.
   h_size size() const;
+  /// \return The number of stored stencil nodes (non-zeros).
+  h_size nodeCount() const;
+
+  // CSR arrays
+
+  /// \return Row offsets (size() + 1 entries) into columns/weights.
+  std::span<const h_size> rowOffsets() const;
+  /// \return Column (element) indices of all stored rows.
+  std::span<const h_size> columns() const;
+  /// \return Weights of all stored rows.
+  std::span<const real_t> weights() const;
+  /// \return Constant terms of all stored rows.
+  std::span<const real_t> constants() const;
 
   iterator begin() const;
   iterator end() const;
 
+  // evaluation
+
+  /// Computes out[i] = (row i)(in) for every element of out, in parallel.
+  /// Elements past the stored rows use the mono-stencil, and constant
+  /// expressions write their constant.
+  /// \note Rows equal to the interior stencil of the expression (detected
+  ///       when rows are set in bulk, see setRows) are computed from the
+  ///       stencil alone, without reading the CSR arrays.
+  /// \param in Field of the expression symbol.
+  /// \param out
+  void apply(core::FieldCRef<real_t> in, core::FieldRef<real_t> out) const;
+  /// Computes out[i] += alpha * (row i)(in) in a single pass (see apply).
+  /// \param alpha
+  /// \param in Field of the expression symbol.
+  /// \param out
+  void axpy(real_t alpha, core::FieldCRef<real_t> in,
+            core::FieldRef<real_t> out) const;
+
   // arithmetic operators
 
   /// \brief
@@ -103,13 +208,45 @@ public:
   DiscreteExpression operator+(const DiscreteExpression &rhs) const;
 
 private:
+  /// Range of stored rows that either all equal the uniform stencil or are
+  /// read from the CSR arrays.
+  struct Segment {
+    h_size first{0};
+    h_size last{0};
+    bool uniform{false};
+  };
+
+  /// Finds the rows equal to the stencil of the middle row (the interior of
+  /// structured discretizations) and splits the stored rows into segments.
+  void classifyRows();
+  template <bool Add>
+  void evaluate(real_t alpha, const core::FieldCRef<real_t> &in,
+                core::FieldRef<real_t> &out) const;
+
+  /// Appends a row to the CSR arrays.
+  void appendRow(const DiscreteOperator &e);
+  /// Appends the mono-stencil row centered at the given index.
+  void appendDefaultRow(h_index index);
+
   /// if empty, this DE is a constant (stored at default_constant_)
   std::optional<core::DiscreteSymbol> sym_;
-  /// entries defined for indices
-  std::unordered_map<h_index, DiscreteOperator> entries_;
+  /// CSR row offsets (empty if no rows are stored)
+  std::vector<h_size> row_offsets_;
+  /// CSR column indices
+  std::vector<h_size> columns_;
+  /// CSR weights
+  std::vector<real_t> weights_;
+  /// constant term per row
+  std::vector<real_t> constants_;
   /// mono-stencil coefficient (operators are not explicitly stored)
   real_t default_coefficient_{1.0};
   real_t default_constant_{0.0};
+  /// uniform stencil, column offsets are relative to the row
+  std::vector<i64> uniform_offsets_;
+  std::vector<real_t> uniform_weights_;
+  real_t uniform_constant_{0};
+  /// partition of the stored rows (empty if rows were not classified)
+  std::vector<Segment> segments_;
 
 #ifdef NAIADES_INCLUDE_DEBUG_TRAITS
   friend struct hermes::DebugTraits<DiscreteExpression>;
@@ -118,6 +255,8 @@ private:
 
 } // namespace naiades::numeric
 
+#ifdef NAIADES_INCLUDE_DEBUG_TRAITS
+
 namespace hermes {
 
 template <> struct DebugTraits<naiades::numeric::DiscreteExpression> {
@@ -127,9 +266,15 @@ template <> struct DebugTraits<naiades::numeric::DiscreteExpression> {
     auto m = DebugMessage();
     m.addTitle("Discrete Expression");
     m.add("symbol", data.sym_.has_value() ? hermes::to_string(*data.sym_) : "");
-    m.addMap("entries", data.entries_);
+    m.add("rows", data.size());
+    m.add("nodes", data.nodeCount());
+    m.add("row offsets", hermes::cstr::join(data.row_offsets_, ", ", 10));
+    m.add("columns", hermes::cstr::join(data.columns_, ", ", 10));
+    m.add("weights", hermes::cstr::join(data.weights_, ", ", 10));
     return m;
   }
 };
 
-} // namespace hermes
\ No newline at end of file
+} // namespace hermes
+
+#endif
@@ -28,8 +28,40 @@
 
 #include <naiades/numeric/boundary.h>
 
+#include <algorithm>
+
 namespace naiades::numeric {
 
+namespace {
+
+DiscreteOperator::Nodes::iterator findNode(DiscreteOperator::Nodes &nodes,
+                                           h_size index) {
+  return std::lower_bound(
+      nodes.begin(), nodes.end(), index,
+      [](const DiscreteOperator::Node &node, h_size value) {
+        return node.first < value;
+      });
+}
+
+DiscreteOperator::Nodes::const_iterator
+findNode(const DiscreteOperator::Nodes &nodes, h_size index) {
+  return std::lower_bound(
+      nodes.begin(), nodes.end(), index,
+      [](const DiscreteOperator::Node &node, h_size value) {
+        return node.first < value;
+      });
+}
+
+void addNode(DiscreteOperator::Nodes &nodes, h_size index, real_t weight) {
+  auto it = findNode(nodes, index);
+  if (it != nodes.end() && it->first == index)
+    it->second += weight;
+  else
+    nodes.insert(it, {index, weight});
+}
+
+} // namespace
+
 DiscreteOperator::DiscreteOperator(h_size center_index)
     : center_index_{center_index} {}
 
@@ -38,28 +70,48 @@ DiscreteOperator::DiscreteOperator(h_size center_index,
                                    const std::vector<real_t> &weights)
     : center_index_{center_index} {
   HERMES_ASSERT(indices.size() == weights.size());
+  nodes_.reserve(indices.size());
   for (h_size i = 0; i < indices.size(); ++i)
-    nodes_[indices[i]] = weights[i];
+    addNode(nodes_, indices[i], weights[i]);
 }
 
 void DiscreteOperator::setCenterIndex(h_size index) { center_index_ = index; }
 
+void DiscreteOperator::clear(h_size center_index) {
+  nodes_.clear();
+  boundary_nodes_.clear();
+  constant_ = 0;
+  center_index_ = center_index;
+}
+
 void DiscreteOperator::add(h_size index, real_t weight) {
-  nodes_[index] += weight;
+  addNode(nodes_, index, weight);
 }
 
 void DiscreteOperator::addUnresolved(const core::ElementIndex &element,
                                      real_t weight) {
-  boundary_nodes_[*element.index] += weight;
+  addNode(boundary_nodes_, *element.index, weight);
+}
+
+void DiscreteOperator::addScaled(const DiscreteOperator &op, real_t s) {
+  for (const auto &node : op.nodes_)
+    addNode(nodes_, node.first, node.second * s);
+  for (const auto &node : op.boundary_nodes_)
+    addNode(boundary_nodes_, node.first, node.second * s);
+  constant_ += op.constant_ * s;
 }
 
 NaResult DiscreteOperator::resolve(const Boundary &boundary) {
-  for (const auto &item : boundary_nodes_) {
+  Nodes unresolved_nodes;
+  std::swap(unresolved_nodes, boundary_nodes_);
+  for (const auto &item : unresolved_nodes) {
     *this += boundary.stencil(core::Index::global(item.first)) * item.second;
   }
   return NaResult::noError();
 }
 
+bool DiscreteOperator::isUnresolved() const { return !boundary_nodes_.empty(); }
+
 void DiscreteOperator::setConstant(real_t s) { constant_ = s; }
 
 real_t DiscreteOperator::constant() const { return constant_; }
@@ -67,50 +119,39 @@ real_t DiscreteOperator::constant() const { return constant_; }
 h_size DiscreteOperator::centerIndex() const { return center_index_; }
 
 real_t DiscreteOperator::operator[](h_size index) const {
-  auto it = nodes_.find(index);
-  if (it == nodes_.end())
+  auto it = findNode(nodes_, index);
+  if (it == nodes_.end() || it->first != index)
     return 0;
   return it->second;
 }
 
 real_t &DiscreteOperator::operator[](h_size index) {
-  static real_t s_dummy = 0;
-  auto it = nodes_.find(index);
-  if (it == nodes_.end())
-    return s_dummy;
+  auto it = findNode(nodes_, index);
+  if (it == nodes_.end() || it->first != index)
+    it = nodes_.insert(it, {index, 0});
   return it->second;
 }
 
 DiscreteOperator
 DiscreteOperator::operator+(const DiscreteOperator &rhs) const {
-  HERMES_ASSERT(center_index_ == rhs.center_index_);
   DiscreteOperator op = *this;
-  for (const auto &node : rhs.nodes_) {
-    auto it = nodes_.find(node.first);
-    if (it != nodes_.end())
-      op[node.first] = it->second + node.second;
-    else
-      op[node.first] = node.second;
-  }
-  op.constant_ = constant_ + rhs.constant_;
-  op.center_index_ = center_index_;
-  return *this;
+  op += rhs;
+  return op;
 }
 
 DiscreteOperator &DiscreteOperator::operator+=(const DiscreteOperator &rhs) {
   HERMES_ASSERT(center_index_ == rhs.center_index_);
   for (const auto &node : rhs.nodes_)
-    nodes_[node.first] += node.second;
+    addNode(nodes_, node.first, node.second);
+  for (const auto &node : rhs.boundary_nodes_)
+    addNode(boundary_nodes_, node.first, node.second);
   constant_ += rhs.constant_;
   return *this;
 }
 
 DiscreteOperator DiscreteOperator::operator*(real_t s) const {
-  DiscreteOperator op;
-  op.center_index_ = center_index_;
-  op.constant_ = constant_ * s;
-  for (auto &node : nodes_)
-    op.nodes_[node.first] = node.second * s;
+  DiscreteOperator op = *this;
+  op *= s;
   return op;
 }
 
@@ -118,26 +159,20 @@ DiscreteOperator &DiscreteOperator::operator*=(real_t s) {
   constant_ *= s;
   for (auto &node : nodes_)
     node.second *= s;
+  for (auto &node : boundary_nodes_)
+    node.second *= s;
   return *this;
 }
 
-DiscreteOperator DiscreteOperator::operator-() const {
-  DiscreteOperator op;
-  op.center_index_ = center_index_;
-  op.constant_ = -constant_;
-  for (auto &node : nodes_)
-    op.nodes_[node.first] = -node.second;
-  return op;
-}
+DiscreteOperator DiscreteOperator::operator-() const { return *this * -1; }
 
 h_size DiscreteOperator::size() const { return nodes_.size(); }
 
-const std::unordered_map<h_size, real_t> &DiscreteOperator::nodes() const {
+const DiscreteOperator::Nodes &DiscreteOperator::nodes() const {
   return nodes_;
 }
 
-const std::unordered_map<h_size, real_t> &
-DiscreteOperator::boundaryNodes() const {
+const DiscreteOperator::Nodes &DiscreteOperator::boundaryNodes() const {
   return boundary_nodes_;
 }
 
@@ -29,6 +29,8 @@
 
 #include <naiades/core/element.h>
 
+#include <vector>
+
 namespace naiades::numeric {
 
 class Boundary;
@@ -36,20 +38,34 @@ class Boundary;
 /// A discrete operator represents the discretization of a linear operator that
 /// can be implicit or explicit. Implicit forms must be solved within linear
 /// systems, while explicit forms can be computed from fields.
+/// \note Stencil nodes are stored in a flat list sorted by element index.
 class DiscreteOperator {
 public:
+  /// Stencil node (element index, weight).
+  using Node = std::pair<h_size, real_t>;
+  using Nodes = std::vector<Node>;
+
   DiscreteOperator() = default;
   DiscreteOperator(h_size center_index);
   DiscreteOperator(h_size center_index, const std::vector<h_size> &indices,
                    const std::vector<real_t> &weights);
   /// Set central element index
   void setCenterIndex(h_size index);
+  /// Removes all nodes and the constant, keeping the allocated storage so the
+  /// operator can be reused for another element.
+  /// \param center_index
+  void clear(h_size center_index);
   /// Add element to this operator.
   /// \param index
   /// \param weight
   void add(h_size index, real_t weight);
   /// Add unresolved element to this operator.
   void addUnresolved(const core::ElementIndex &element, real_t weight);
+  /// Adds the terms of another operator scaled by s (op * s without the
+  /// temporary).
+  /// \param op
+  /// \param s
+  void addScaled(const DiscreteOperator &op, real_t s);
   /// Resolve boundary elements by expanding their terms in the operator.
   /// \note Once resolved, the original unresolved terms are lost.
   NaResult resolve(const Boundary &boundary);
@@ -68,14 +84,20 @@ public:
   real_t constant() const;
   h_size centerIndex() const;
 
+  /// \return The weight of the node at the given element index (zero if
+  ///         there is no such node).
   real_t operator[](h_size index) const;
+  /// \return The weight of the node at the given element index. A node with
+  ///         zero weight is inserted if there is none.
   real_t &operator[](h_size index);
 
   /// \return the diagonal size (element count).
   h_size size() const;
 
-  const std::unordered_map<h_size, real_t> &nodes() const;
-  const std::unordered_map<h_size, real_t> &boundaryNodes() const;
+  /// \return Stencil nodes sorted by element index.
+  const Nodes &nodes() const;
+  /// \return Unresolved boundary nodes sorted by element index.
+  const Nodes &boundaryNodes() const;
 
   // arithmetic operators
 
@@ -86,8 +108,8 @@ public:
   DiscreteOperator operator-() const;
 
 private:
-  std::unordered_map<h_size, real_t> nodes_;
-  std::unordered_map<h_size, real_t> boundary_nodes_;
+  Nodes nodes_;
+  Nodes boundary_nodes_;
   real_t constant_{0};
   h_size center_index_{0};
 
@@ -107,7 +129,8 @@ template <> struct DebugTraits<naiades::numeric::DiscreteOperator> {
   static DebugMessage message(const naiades::numeric::DiscreteOperator &data) {
     auto m = DebugMessage();
     m.add("center", data.center_index_);
-    m.addMap("nodes", data.nodes_);
+    m.addMap("nodes", std::unordered_map<h_size, real_t>(data.nodes_.begin(),
+                                                         data.nodes_.end()));
     m.add("constant", data.constant_);
     return m;
   }
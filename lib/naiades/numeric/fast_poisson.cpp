@@ -0,0 +1,303 @@
+/* Copyright (c) 2026, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/// \file   fast_poisson.cpp
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-16
+
+#include <naiades/numeric/fast_poisson.h>
+
+#include <naiades/base/parallel.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <optional>
+
+namespace naiades::numeric::solvers {
+
+FastPoisson::Config &
+FastPoisson::Config::setDiscretization(const Grid2FD &fd) {
+  fd_ = &fd;
+  return *this;
+}
+
+FastPoisson::Config &
+FastPoisson::Config::setSymbol(const core::DiscreteSymbol &sym) {
+  sym_ = sym;
+  return *this;
+}
+
+Result<FastPoisson> FastPoisson::Config::build() const {
+  if (!fd_ || !sym_.symbol.loc.is(core::element_primitive_bits::cell)) {
+    HERMES_ERROR("Fast Poisson solver requires a Grid2FD cell symbol.");
+    return NaResult::inputError();
+  }
+  if (!fd_->boundaries().count(sym_.boundary_symbol)) {
+    HERMES_ERROR("Missing boundary for symbol {}.", sym_.symbol.name);
+    return NaResult::notFound();
+  }
+
+  const auto &mesh = fd_->mesh();
+  const auto regions = fd_->boundary(sym_.boundary_symbol).regions();
+
+  FastPoisson fp;
+  fp.resolution_ = mesh.resolution(sym_.symbol.loc);
+
+  // detect the condition of each side from its resolved face stencils
+  const core::Element::Type sides[4] = {
+      core::Element::Type::LEFT_FACE, core::Element::Type::RIGHT_FACE,
+      core::Element::Type::DOWN_FACE, core::Element::Type::UP_FACE};
+  for (h_size s = 0; s < 4; ++s) {
+    std::optional<Condition> side_condition;
+    for (auto face : mesh.boundaryIndices(sides[s])) {
+      auto index = core::Index::global(face);
+      auto region = std::find_if(
+          regions.begin(), regions.end(),
+          [&](const Boundary::Region &r) { return r.contains(index); });
+      if (region == regions.end()) {
+        HERMES_ERROR("Boundary face {} of {} has no condition.", face,
+                     sym_.symbol.name);
+        return NaResult::inputError();
+      }
+      const auto &op = region->stencil(index);
+      Condition condition;
+      if (op.nodes().empty())
+        condition = Condition::DIRICHLET;
+      else if (op.nodes().size() == 1 && op.nodes()[0].second == 1 &&
+               op.constant() == 0)
+        condition = Condition::NEUMANN;
+      else {
+        HERMES_ERROR("Unsupported boundary condition at face {} of {}.", face,
+                     sym_.symbol.name);
+        return NaResult::inputError();
+      }
+      if (side_condition && *side_condition != condition) {
+        HERMES_ERROR("Side {} of {} mixes boundary conditions.",
+                     hermes::to_string(core::Element(sides[s])),
+                     sym_.symbol.name);
+        return NaResult::inputError();
+      }
+      side_condition = condition;
+    }
+    fp.conditions_[s] = side_condition.value_or(Condition::NEUMANN);
+  }
+
+  const auto d = mesh.cellSize();
+  fp.x_ = Axis(fp.resolution_.width, d.x, fp.conditions_[0],
+               fp.conditions_[1]);
+
+  // factorize the y systems (T_y + lambda_k I) of each x mode
+  const h_size w = fp.resolution_.width;
+  const h_size h = fp.resolution_.height;
+  const double ky = 1.0 / (static_cast<double>(d.y) * d.y);
+  const bool singular =
+      std::all_of(fp.conditions_.begin(), fp.conditions_.end(),
+                  [](Condition c) { return c == Condition::NEUMANN; });
+  fp.y_weight_ = ky;
+  fp.inverse_pivots_.resize(w * h);
+  for (h_size k = 0; k < w; ++k) {
+    double pivot = 0;
+    for (h_size j = 0; j < h; ++j) {
+      double diagonal = fp.x_.eigenvalues[k] - 2 * ky;
+      if (j == 0 && fp.conditions_[2] == Condition::NEUMANN)
+        diagonal += ky;
+      if (j + 1 == h && fp.conditions_[3] == Condition::NEUMANN)
+        diagonal += ky;
+      pivot = j ? diagonal - ky * ky / pivot : diagonal;
+      // the constant mode of pure Neumann is pinned at its last row
+      fp.inverse_pivots_[j * w + k] =
+          singular && k == 0 && j + 1 == h ? 0 : 1 / pivot;
+    }
+  }
+
+  // Dirichlet values end up as constants of the boundary cell rows
+  for (h_size j = 0; j < h; ++j)
+    for (h_size i = 0; i < w; ++i) {
+      if (i > 0 && j > 0 && i + 1 < w && j + 1 < h)
+        continue;
+      const h_size row = j * w + i;
+      auto constant = fd_->laplacian(row, sym_).constant();
+      if (constant != 0) {
+        fp.boundary_rows_.emplace_back(row);
+        fp.constants_.emplace_back(constant);
+      }
+    }
+
+  return Result<FastPoisson>(std::move(fp));
+}
+
+FastPoisson::Axis::Axis(h_size n, double h, Condition low, Condition high)
+    : n{n} {
+  h_size length = 0;
+  // sum_i phi_k(i)^2
+  double norm = 0;
+  if (low == Condition::DIRICHLET && high == Condition::DIRICHLET) {
+    // sin(2 pi (k + 1) (i + 1) / (2n + 2))
+    length = 2 * n + 2;
+    position_offset = 1;
+    frequency_offset = 1;
+    norm = 0.5 * (n + 1);
+  } else if (low == Condition::NEUMANN && high == Condition::NEUMANN) {
+    // cos(2 pi k (2i + 1) / 4n)
+    cosine = true;
+    length = 4 * n;
+    position_scale = 2;
+    position_offset = 1;
+    norm = 0.5 * n;
+  } else {
+    // sin(2 pi (2k + 1) (i + 1) / (4n + 2)), mirrored if high is Dirichlet
+    length = 4 * n + 2;
+    frequency_scale = 2;
+    frequency_offset = 1;
+    if (low == Condition::DIRICHLET)
+      position_offset = 1;
+    else {
+      position_scale = -1;
+      position_offset = n;
+    }
+    norm = 0.25 * (2 * n + 1);
+  }
+  fft = FFT(length);
+
+  eigenvalues.resize(n);
+  inverse_norms.resize(n);
+  for (h_size k = 0; k < n; ++k) {
+    // lambda_k = -(2 - 2 cos(theta_k)) / h^2
+    const double theta = 2 * std::numbers::pi *
+                         (frequency_scale * k + frequency_offset) *
+                         std::abs(position_scale) / length;
+    const double s = std::sin(0.5 * theta);
+    eigenvalues[k] = -4 * s * s / (h * h);
+    // the constant cosine mode is not halved
+    inverse_norms[k] = cosine && k == 0 ? 1.0 / n : 1 / norm;
+  }
+}
+
+void FastPoisson::Axis::transform(bool inverse, double *a, double *b,
+                                  h_size stride,
+                                  std::vector<FFT::Complex> &work) const {
+  // the modes are symmetric in (frequency, position)
+  auto position = [&](h_size i) {
+    return position_scale * static_cast<i64>(i) + position_offset;
+  };
+  auto frequency = [&](h_size k) {
+    return frequency_scale * static_cast<i64>(k) + frequency_offset;
+  };
+  const i64 length = fft.size();
+  work.assign(length, FFT::Complex(0));
+  for (h_size i = 0; i < n; ++i) {
+    const i64 m = inverse ? frequency(i) : position(i);
+    const FFT::Complex v(a[i * stride], b ? b[i * stride] : 0.0);
+    if (m == 0)
+      // self-symmetric (constant cosine mode)
+      work[0] = 2.0 * v;
+    else {
+      work[m] = v;
+      work[length - m] = cosine ? v : -v;
+    }
+  }
+  fft.forward(work.data());
+  // the extension doubles the sums
+  for (h_size k = 0; k < n; ++k) {
+    const auto &y = work[inverse ? position(k) : frequency(k)];
+    // sine: y = 2 (S(b) - i S(a)), cosine: y = 2 (C(a) + i C(b))
+    a[k * stride] = 0.5 * (cosine ? y.real() : -y.imag());
+    if (b)
+      b[k * stride] = 0.5 * (cosine ? y.imag() : y.real());
+  }
+}
+
+FastPoisson::Condition FastPoisson::condition(core::Element side) const {
+  if (side == core::Element::Type::LEFT_FACE)
+    return conditions_[0];
+  if (side == core::Element::Type::RIGHT_FACE)
+    return conditions_[1];
+  if (side == core::Element::Type::DOWN_FACE)
+    return conditions_[2];
+  HERMES_ASSERT(side == core::Element::Type::UP_FACE);
+  return conditions_[3];
+}
+
+void FastPoisson::solve(
+    core::FieldRef<real_t> &unknown_field,
+    const std::vector<core::FieldCRef<real_t>> &explicit_fields) const {
+  const h_size w = resolution_.width;
+  const h_size h = resolution_.height;
+  HERMES_ASSERT(unknown_field.size() == w * h);
+
+  // b = f - c
+  std::vector<double> u(w * h, 0.0);
+  if (!explicit_fields.empty()) {
+    HERMES_ASSERT(explicit_fields[0].size() == w * h);
+    for (h_index i = 0; i < u.size(); ++i)
+      u[i] = explicit_fields[0][i];
+  }
+  for (h_size k = 0; k < boundary_rows_.size(); ++k)
+    u[boundary_rows_[k]] -= constants_[k];
+
+  // rows are transformed in pairs
+  auto transformRows = [&](bool inverse) {
+    parallelFor(0, (h + 1) / 2, [&](h_index p) {
+      thread_local std::vector<FFT::Complex> work;
+      double *a = u.data() + 2 * p * w;
+      x_.transform(inverse, a, 2 * p + 1 < h ? a + w : nullptr, 1, work);
+    });
+  };
+
+  // project the rows onto the x modes
+  transformRows(false);
+  // solve the tridiagonal y system of each mode, in blocks of columns
+  const double ky = y_weight_;
+  const h_size block = 64;
+  parallelFor(0, (w + block - 1) / block, [&](h_index b) {
+    const h_size k0 = b * block;
+    const h_size k1 = std::min(w, k0 + block);
+    for (h_size k = k0; k < k1; ++k)
+      u[k] = u[k] * x_.inverse_norms[k] * inverse_pivots_[k];
+    for (h_size j = 1; j < h; ++j)
+      for (h_size k = k0; k < k1; ++k)
+        u[j * w + k] = (u[j * w + k] * x_.inverse_norms[k] -
+                        ky * u[(j - 1) * w + k]) *
+                       inverse_pivots_[j * w + k];
+    for (h_size j = h - 1; j-- > 0;)
+      for (h_size k = k0; k < k1; ++k)
+        u[j * w + k] -= ky * inverse_pivots_[j * w + k] * u[(j + 1) * w + k];
+  });
+  if (!inverse_pivots_.empty() && inverse_pivots_[(h - 1) * w] == 0) {
+    // zero-mean solution of the singular (pure Neumann) mode
+    double mean = 0;
+    for (h_size j = 0; j < h; ++j)
+      mean += u[j * w];
+    mean /= h;
+    for (h_size j = 0; j < h; ++j)
+      u[j * w] -= mean;
+  }
+  // back to grid values
+  transformRows(true);
+
+  for (h_index i = 0; i < u.size(); ++i)
+    unknown_field[i] = u[i];
+}
+
+} // namespace naiades::numeric::solvers
@@ -0,0 +1,138 @@
+/* Copyright (c) 2026, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/// \file   fast_poisson.h
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-16
+/// \brief  Spectral Poisson solver for uniform grids.
+
+#pragma once
+
+#include <naiades/geo/grid.h>
+#include <naiades/numeric/fft.h>
+
+#include <array>
+
+namespace naiades::numeric::solvers {
+
+/// \brief Direct Poisson solver for Grid2FD cell fields based on fast
+///        sine/cosine transforms.
+///
+/// When each side of the domain has a single condition type, the 5-point
+/// Laplacian of Grid2FD separates into one tridiagonal operator per axis.
+/// The eigenvectors of the x operator are discrete sine or cosine modes:
+///   - Dirichlet on both sides: sin(pi (k + 1) (i + 1) / (n + 1))
+///   - Neumann on both sides:   cos(pi k (i + 1/2) / n)
+///   - mixed:                   sin(pi (k + 1/2) (i + 1) / (n + 1/2))
+/// Transforming the grid rows onto these modes decouples the system into one
+/// tridiagonal system along y per mode, whose factorizations are computed
+/// at build. A solve is then two row transforms and a tridiagonal sweep, in
+/// O(N log N) without iterating.
+///
+/// Build detects the condition of each side (LEFT_FACE, RIGHT_FACE,
+/// DOWN_FACE and UP_FACE) from the resolved boundary stencils and fails for
+/// sides mixing conditions. Dirichlet values need not be zero, their
+/// constants are moved to the right hand side.
+///
+/// \note With Neumann conditions on all sides the operator is singular, the
+///       solver returns the zero-mean solution.
+///
+/// Example:
+///   auto poisson = solvers::FastPoisson::Config()
+///                      .setDiscretization(fd)
+///                      .setSymbol(p)
+///                      .build()
+///                      .value();
+///   poisson.solve(p_field, {div_field});
+class FastPoisson {
+public:
+  /// Boundary condition type of a domain side.
+  enum class Condition : u8 { DIRICHLET, NEUMANN };
+
+  struct Config {
+    Config &setDiscretization(const Grid2FD &fd);
+    Config &setSymbol(const core::DiscreteSymbol &sym);
+
+    /// \return The solver or an input error if the boundaries of the symbol
+    ///         can not be diagonalized.
+    Result<FastPoisson> build() const;
+
+  private:
+    const Grid2FD *fd_{nullptr};
+    core::DiscreteSymbol sym_;
+  };
+
+  /// \param side LEFT_FACE, RIGHT_FACE, DOWN_FACE or UP_FACE.
+  /// \return The condition detected at the given side of the domain.
+  Condition condition(core::Element side) const;
+
+  /// Solves L(u) = f, where f is the first explicit field (or zero).
+  void
+  solve(core::FieldRef<real_t> &unknown_field,
+        const std::vector<core::FieldCRef<real_t>> &explicit_fields = {}) const;
+
+private:
+  /// Sine/cosine transform diagonalizing the 1D operator of an axis.
+  /// Modes are phi_k(i) = trig(2 pi f(k) m(i) / M), with
+  /// m(i) = position_scale * i + position_offset and
+  /// f(k) = frequency_scale * k + frequency_offset, and are computed with a
+  /// complex FFT of length M over the odd (sine) or even (cosine) extension
+  /// of the values. Two real lines are transformed at once, one in each
+  /// component of the complex input.
+  struct Axis {
+    Axis() = default;
+    Axis(h_size n, double h, Condition low, Condition high);
+
+    /// Forward: c_k = sum_i x_i phi_k(i). Inverse: x_i = sum_k c_k phi_k(i).
+    /// \param a First line, transformed in place.
+    /// \param b Second line (or null), transformed in place.
+    /// \param stride Distance between consecutive line values.
+    void transform(bool inverse, double *a, double *b, h_size stride,
+                   std::vector<FFT::Complex> &work) const;
+
+    h_size n{0};
+    bool cosine{false};
+    i64 position_scale{1};
+    i64 position_offset{0};
+    i64 frequency_scale{1};
+    i64 frequency_offset{0};
+    FFT fft;
+    /// eigenvalues of the 1D operator
+    std::vector<double> eigenvalues;
+    /// 1 / sum_i phi_k(i)^2
+    std::vector<double> inverse_norms;
+  };
+
+  hermes::size2 resolution_;
+  /// left, right, down, up
+  std::array<Condition, 4> conditions_{};
+  Axis x_;
+  // LU factorization of the y systems, per row and x mode
+  double y_weight_{0};
+  std::vector<double> inverse_pivots_;
+  // Dirichlet constants of boundary cells
+  std::vector<h_size> boundary_rows_;
+  std::vector<double> constants_;
+};
+
+} // namespace naiades::numeric::solvers
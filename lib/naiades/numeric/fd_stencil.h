@@ -0,0 +1,175 @@
+/* Copyright (c) 2026, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/// \file   fd_stencil.h
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-16
+/// \brief  Compile-time finite difference stencils.
+
+#pragma once
+
+#include <naiades/numeric/spatial_discretization.h>
+
+#include <algorithm>
+#include <array>
+
+namespace naiades::numeric::fd {
+
+/// \brief Stencil term of the element at offset (i, j) from the center.
+///
+/// The weight of the term is c / (h_x^px * h_y^py), where (h_x, h_y) is the
+/// grid spacing.
+struct Tap {
+  i32 i{0};
+  i32 j{0};
+  real_t c{0};
+  u32 px{0};
+  u32 py{0};
+};
+
+/// \brief Constant-coefficient stencil of a uniform 2D grid.
+///
+/// Stencils are literal types, so they can be built at compile time and used
+/// as template arguments of evaluation kernels:
+///   constexpr auto L = fd::laplacianStencil<4>();
+///   const auto w = L.weights(h.x, h.y);
+/// \note Terms may share an offset (e.g. the center of the Laplacian), in
+///       which case their weights add up.
+template <h_size N> struct Stencil {
+  static constexpr h_size size = N;
+
+  /// \return The largest offset, in elements, along any axis.
+  constexpr i32 radius() const {
+    i32 r = 0;
+    for (const auto &tap : taps) {
+      r = std::max(r, tap.i < 0 ? -tap.i : tap.i);
+      r = std::max(r, tap.j < 0 ? -tap.j : tap.j);
+    }
+    return r;
+  }
+  /// \return The weights of the terms for the given grid spacing.
+  constexpr std::array<real_t, N> weights(real_t hx, real_t hy) const {
+    std::array<real_t, N> w{};
+    for (h_size k = 0; k < N; ++k) {
+      w[k] = taps[k].c;
+      for (u32 p = 0; p < taps[k].px; ++p)
+        w[k] /= hx;
+      for (u32 p = 0; p < taps[k].py; ++p)
+        w[k] /= hy;
+    }
+    return w;
+  }
+
+  std::array<Tap, N> taps;
+};
+
+/// \return The terms of both stencils.
+template <h_size N, h_size M>
+constexpr Stencil<N + M> operator+(const Stencil<N> &a, const Stencil<M> &b) {
+  Stencil<N + M> s{};
+  for (h_size k = 0; k < N; ++k)
+    s.taps[k] = a.taps[k];
+  for (h_size k = 0; k < M; ++k)
+    s.taps[N + k] = b.taps[k];
+  return s;
+}
+
+/// \return The stencil with x and y swapped.
+template <h_size N> constexpr Stencil<N> transpose(const Stencil<N> &a) {
+  Stencil<N> s{};
+  for (h_size k = 0; k < N; ++k)
+    s.taps[k] = {a.taps[k].j, a.taps[k].i, a.taps[k].c, a.taps[k].py,
+                 a.taps[k].px};
+  return s;
+}
+
+/// \return The stencil of applying b and then a (e.g. d/dx of d/dy).
+template <h_size N, h_size M>
+constexpr Stencil<N * M> compose(const Stencil<N> &a, const Stencil<M> &b) {
+  Stencil<N * M> s{};
+  for (h_size k = 0; k < N; ++k)
+    for (h_size l = 0; l < M; ++l)
+      s.taps[k * M + l] = {a.taps[k].i + b.taps[l].i,
+                           a.taps[k].j + b.taps[l].j,
+                           a.taps[k].c * b.taps[l].c,
+                           a.taps[k].px + b.taps[l].px,
+                           a.taps[k].py + b.taps[l].py};
+  return s;
+}
+
+/// Central difference of the first derivative along x.
+/// \tparam Order Accuracy order (2 or 4).
+template <u32 Order> constexpr auto firstDifference() {
+  static_assert(Order == 2 || Order == 4, "Unsupported order.");
+  if constexpr (Order == 2)
+    return Stencil<2>{{{{-1, 0, real_t(-1) / 2, 1, 0},
+                        {1, 0, real_t(1) / 2, 1, 0}}}};
+  else
+    return Stencil<4>{{{{-2, 0, real_t(1) / 12, 1, 0},
+                        {-1, 0, real_t(-8) / 12, 1, 0},
+                        {1, 0, real_t(8) / 12, 1, 0},
+                        {2, 0, real_t(-1) / 12, 1, 0}}}};
+}
+
+/// Central difference of the second derivative along x.
+/// \tparam Order Accuracy order (2 or 4).
+template <u32 Order> constexpr auto secondDifference() {
+  static_assert(Order == 2 || Order == 4, "Unsupported order.");
+  if constexpr (Order == 2)
+    return Stencil<3>{{{{-1, 0, 1, 2, 0}, {0, 0, -2, 2, 0}, {1, 0, 1, 2, 0}}}};
+  else
+    return Stencil<5>{{{{-2, 0, real_t(-1) / 12, 2, 0},
+                        {-1, 0, real_t(16) / 12, 2, 0},
+                        {0, 0, real_t(-30) / 12, 2, 0},
+                        {1, 0, real_t(16) / 12, 2, 0},
+                        {2, 0, real_t(-1) / 12, 2, 0}}}};
+}
+
+/// Central difference stencil of a derivative.
+/// \tparam D x, y (first derivatives), xx, yy (second derivatives), xy or yx
+///           (mixed derivative).
+/// \tparam Order Accuracy order (2 or 4).
+template <derivative_bits D, u32 Order> constexpr auto derivativeStencil() {
+  if constexpr (D == derivative_bits::x)
+    return firstDifference<Order>();
+  else if constexpr (D == derivative_bits::y)
+    return transpose(firstDifference<Order>());
+  else if constexpr (D == derivative_bits::xx)
+    return secondDifference<Order>();
+  else if constexpr (D == derivative_bits::yy)
+    return transpose(secondDifference<Order>());
+  else {
+    static_assert(D == derivative_bits::xy || D == derivative_bits::yx,
+                  "Unsupported derivative.");
+    return compose(firstDifference<Order>(),
+                   transpose(firstDifference<Order>()));
+  }
+}
+
+/// Central difference stencil of the Laplacian (dxx + dyy).
+/// \tparam Order Accuracy order (2 or 4).
+template <u32 Order> constexpr auto laplacianStencil() {
+  return derivativeStencil<derivative_bits::xx, Order>() +
+         derivativeStencil<derivative_bits::yy, Order>();
+}
+
+} // namespace naiades::numeric::fd
@@ -0,0 +1,123 @@
+/* Copyright (c) 2026, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/// \file   fft.cpp
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-16
+
+#include <naiades/numeric/fft.h>
+
+#include <bit>
+#include <numbers>
+
+namespace naiades::numeric {
+
+namespace {
+
+// std::complex products check for inf/nan (falling back to a slow library
+// call), which dominates the butterflies.
+inline FFT::Complex mul(const FFT::Complex &a, const FFT::Complex &b) {
+  return {a.real() * b.real() - a.imag() * b.imag(),
+          a.real() * b.imag() + a.imag() * b.real()};
+}
+
+} // namespace
+
+FFT::FFT(h_size n) : n_{n} {
+  if (n_ == 0)
+    return;
+  m_ = std::has_single_bit(n_) ? n_ : std::bit_ceil(2 * n_ - 1);
+  twiddles_.resize(m_ / 2);
+  for (h_size k = 0; k < twiddles_.size(); ++k)
+    twiddles_[k] = std::polar(1.0, -2 * std::numbers::pi * k /
+                                        static_cast<double>(m_));
+  if (m_ == n_)
+    return;
+  // w_k = exp(-i pi k^2 / n), with k^2 reduced modulo 2n to keep precision
+  chirp_.resize(n_);
+  for (h_size k = 0; k < n_; ++k)
+    chirp_[k] = std::polar(1.0, -std::numbers::pi *
+                                    static_cast<double>(k * k % (2 * n_)) /
+                                    static_cast<double>(n_));
+  chirp_spectrum_.assign(m_, Complex(0));
+  chirp_spectrum_[0] = std::conj(chirp_[0]);
+  for (h_size k = 1; k < n_; ++k)
+    chirp_spectrum_[k] = chirp_spectrum_[m_ - k] = std::conj(chirp_[k]);
+  radix2(chirp_spectrum_.data());
+}
+
+h_size FFT::size() const { return n_; }
+
+void FFT::radix2(Complex *data) const {
+  // bit reversal permutation
+  for (h_size i = 1, j = 0; i < m_; ++i) {
+    h_size bit = m_ >> 1;
+    for (; j & bit; bit >>= 1)
+      j ^= bit;
+    j ^= bit;
+    if (i < j)
+      std::swap(data[i], data[j]);
+  }
+  // butterflies
+  for (h_size len = 2; len <= m_; len <<= 1) {
+    const h_size half = len / 2;
+    const h_size step = m_ / len;
+    for (h_size s = 0; s < m_; s += len)
+      for (h_size k = 0; k < half; ++k) {
+        Complex t = mul(data[s + k + half], twiddles_[k * step]);
+        data[s + k + half] = data[s + k] - t;
+        data[s + k] += t;
+      }
+  }
+}
+
+void FFT::forward(Complex *data) const {
+  if (m_ == n_) {
+    if (n_ > 1)
+      radix2(data);
+    return;
+  }
+  // Bluestein: X_k = w_k sum_m (x_m w_m) conj(w_{k - m})
+  thread_local std::vector<Complex> a;
+  a.assign(m_, Complex(0));
+  for (h_size k = 0; k < n_; ++k)
+    a[k] = mul(data[k], chirp_[k]);
+  radix2(a.data());
+  // inverse transform through conjugation
+  for (h_size k = 0; k < m_; ++k)
+    a[k] = std::conj(mul(a[k], chirp_spectrum_[k]));
+  radix2(a.data());
+  const double scale = 1.0 / static_cast<double>(m_);
+  for (h_size k = 0; k < n_; ++k)
+    data[k] = mul(std::conj(a[k]) * scale, chirp_[k]);
+}
+
+void FFT::inverse(Complex *data) const {
+  for (h_size k = 0; k < n_; ++k)
+    data[k] = std::conj(data[k]);
+  forward(data);
+  for (h_size k = 0; k < n_; ++k)
+    data[k] = std::conj(data[k]);
+}
+
+} // namespace naiades::numeric
@@ -0,0 +1,74 @@
+/* Copyright (c) 2026, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/// \file   fft.h
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-16
+/// \brief  Self-contained fast Fourier transforms.
+
+#pragma once
+
+#include <naiades/base/result.h>
+
+#include <complex>
+#include <vector>
+
+namespace naiades::numeric {
+
+/// \brief Complex discrete Fourier transform of arbitrary length.
+///
+/// Computes X_k = sum_m x_m exp(-2 pi i k m / n) in O(n log n). Lengths that
+/// are powers of two use an iterative radix-2 transform; other lengths are
+/// mapped to a power of two transform with Bluestein's chirp-z algorithm.
+class FFT {
+public:
+  using Complex = std::complex<double>;
+
+  FFT() = default;
+  /// \param n Transform length.
+  explicit FFT(h_size n);
+
+  /// \return The transform length.
+  h_size size() const;
+  /// Computes the forward transform in place.
+  /// \param data Array of size() values.
+  void forward(Complex *data) const;
+  /// Computes the (unnormalized) inverse transform in place.
+  /// \note The result is scaled by size().
+  /// \param data Array of size() values.
+  void inverse(Complex *data) const;
+
+private:
+  /// Radix-2 transform of length twiddles_.size() * 2.
+  void radix2(Complex *data) const;
+
+  h_size n_{0};
+  // power of two transform
+  h_size m_{0};
+  std::vector<Complex> twiddles_;
+  // Bluestein chirp (only if n_ is not a power of two)
+  std::vector<Complex> chirp_;
+  std::vector<Complex> chirp_spectrum_;
+};
+
+} // namespace naiades::numeric
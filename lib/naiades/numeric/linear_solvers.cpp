@@ -26,62 +26,345 @@
 
 #include <naiades/numeric/linear_solvers.h>
 
-#include <Eigen/IterativeLinearSolvers>
+#include <naiades/base/parallel.h>
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
 
 namespace naiades::numeric::solvers {
 
-void CG::buildSystem() {
-  h_size n = implicit_.size();
+bool assemble(const DiscreteExpression &expression, SparseMatrix &A,
+              bool keep_pattern) {
+  h_size n = expression.size();
+  const auto row_offsets = expression.rowOffsets();
+  const auto columns = expression.columns();
+  const auto weights = expression.weights();
 
-  // Declare a sparse matrix type with double precision
-  A_ = Eigen::SparseMatrix<double>(n, n);
+  if (keep_pattern && A.isCompressed() &&
+      A.rows() == static_cast<Eigen::Index>(n) &&
+      A.nonZeros() == static_cast<Eigen::Index>(columns.size()) &&
+      std::equal(row_offsets.begin(), row_offsets.end(), A.outerIndexPtr()) &&
+      std::equal(columns.begin(), columns.end(), A.innerIndexPtr())) {
+    // same structure, refill values only
+    std::copy(weights.begin(), weights.end(), A.valuePtr());
+    return true;
+  }
+
+  // copy the CSR arrays directly into the compressed matrix storage
+  A.resize(n, n);
+  A.resizeNonZeros(columns.size());
+  if (n)
+    std::copy(row_offsets.begin(), row_offsets.end(), A.outerIndexPtr());
+  std::copy(columns.begin(), columns.end(), A.innerIndexPtr());
+  std::copy(weights.begin(), weights.end(), A.valuePtr());
+  return false;
+}
 
-  // Reserve space for 1 non-zero element per row
-  A_.reserve(Eigen::VectorXi::Constant(n, 1));
+namespace {
 
-  // Build matrix rows
-  for (auto dop : implicit_) {
-    for (auto item : dop.nodes())
-      A_.insert(dop.centerIndex(), item.first) = item.second;
+/// Calls f(std::integral_constant<h_size, M>) with M == m for small block
+/// widths, so kernels can keep per-column accumulators in registers, and
+/// with M == 0 (runtime width) otherwise.
+template <typename F> void dispatchWidth(h_size m, F &&f) {
+  switch (m) {
+  case 1:
+    return f(std::integral_constant<h_size, 1>{});
+  case 2:
+    return f(std::integral_constant<h_size, 2>{});
+  case 3:
+    return f(std::integral_constant<h_size, 3>{});
+  case 4:
+    return f(std::integral_constant<h_size, 4>{});
+  default:
+    return f(std::integral_constant<h_size, 0>{});
   }
-  A_.makeCompressed();
 }
 
-void CG::solveFor(core::FieldRef<real_t> &unknown_field,
-                  const Scalar &rhs) const {
-  h_size n = implicit_.size();
+constexpr h_size max_static_width = 4;
+constexpr h_size min_row_chunk = 1024;
+
+/// Calls f(first, last, partial) over chunks of rows in parallel, where
+/// partial holds one accumulator per column, and sums the partials into
+/// result in chunk order (so results do not depend on scheduling).
+template <typename F>
+void reduceRows(h_size n, std::span<double> result, F &&f) {
+  const h_size m = result.size();
+  const h_size chunk = ThreadPool::chunkSize(n, min_row_chunk);
+  const h_size chunk_count = (n + chunk - 1) / chunk;
+  std::vector<double> partials(chunk_count * m, 0.0);
+  parallelFor(
+      0, chunk_count,
+      [&](h_index c) {
+        f(c * chunk, std::min(n, (c + 1) * chunk), partials.data() + c * m);
+      },
+      1);
+  std::fill(result.begin(), result.end(), 0.0);
+  for (h_index c = 0; c < chunk_count; ++c)
+    for (h_index k = 0; k < m; ++k)
+      result[k] += partials[c * m + k];
+}
 
-  // Declare vectors for the solution (x) and the right-hand side (b)
-  Eigen::VectorXd x(n), b(n);
+} // namespace
 
-  for (h_index i = 0; i < n; ++i) {
-    b(i) = rhs[i];
-  }
+void multiply(const SparseMatrix &A, const MultiVector &X, MultiVector &Y,
+              std::span<double> dots) {
+  HERMES_ASSERT(A.isCompressed() && A.cols() == X.rows());
+  HERMES_ASSERT(dots.empty() || dots.size() == static_cast<h_size>(X.cols()));
+  Y.resize(A.rows(), X.cols());
+  const h_size m = X.cols();
+  const auto *offsets = A.outerIndexPtr();
+  const auto *columns = A.innerIndexPtr();
+  const auto *values = A.valuePtr();
+  const double *x = X.data();
+  double *y = Y.data();
+  const bool with_dots = !dots.empty();
+  std::vector<double> no_dots(m);
+  dispatchWidth(m, [&](auto M) {
+    const h_size width = M ? M : m;
+    reduceRows(A.rows(), with_dots ? dots : no_dots,
+               [&](h_size first, h_size last, double *partial) {
+                 double acc[max_static_width];
+                 double dot[max_static_width] = {};
+                 for (h_index i = first; i < last; ++i) {
+                   double *y_i = y + i * width;
+                   double *out = M ? acc : y_i;
+                   for (h_index c = 0; c < width; ++c)
+                     out[c] = 0;
+                   for (auto k = offsets[i]; k < offsets[i + 1]; ++k) {
+                     const double *x_j =
+                         x + static_cast<h_size>(columns[k]) * width;
+                     const double v = values[k];
+                     for (h_index c = 0; c < width; ++c)
+                       out[c] += v * x_j[c];
+                   }
+                   if constexpr (M != 0) {
+                     for (h_index c = 0; c < width; ++c) {
+                       y_i[c] = acc[c];
+                       dot[c] += acc[c] * x[i * width + c];
+                     }
+                   } else if (with_dots)
+                     for (h_index c = 0; c < width; ++c)
+                       partial[c] += y_i[c] * x[i * width + c];
+                 }
+                 if constexpr (M != 0)
+                   std::copy(dot, dot + width, partial);
+               });
+  });
+}
 
-  // --- Set up and use the Conjugate Gradient solver ---
-  // Using Lower|Upper for better performance
-  Eigen::ConjugateGradient<Eigen::SparseMatrix<double>,
-                           Eigen::Lower | Eigen::Upper>
-      cg;
+void columnDot(const MultiVector &X, const MultiVector &Y,
+               std::span<double> result) {
+  HERMES_ASSERT(X.rows() == Y.rows() && X.cols() == Y.cols());
+  HERMES_ASSERT(result.size() == static_cast<h_size>(X.cols()));
+  const h_size m = X.cols();
+  const double *x = X.data();
+  const double *y = Y.data();
+  dispatchWidth(m, [&](auto M) {
+    const h_size width = M ? M : m;
+    reduceRows(X.rows(), result, [&](h_size first, h_size last, double *dot) {
+      double acc[max_static_width] = {};
+      double *out = M ? acc : dot;
+      for (h_index i = first * width; i < last * width; i += width)
+        for (h_index c = 0; c < width; ++c)
+          out[c] += x[i + c] * y[i + c];
+      if constexpr (M != 0)
+        std::copy(acc, acc + width, dot);
+    });
+  });
+}
 
-  // 1. Compute the factorization/preconditioner
-  cg.compute(A_);
+void columnXpay(const MultiVector &X, std::span<const double> beta,
+                MultiVector &Y) {
+  HERMES_ASSERT(X.rows() == Y.rows() && X.cols() == Y.cols());
+  HERMES_ASSERT(beta.size() == static_cast<h_size>(X.cols()));
+  const h_size n = X.rows();
+  const h_size m = X.cols();
+  const double *x = X.data();
+  double *y = Y.data();
+  dispatchWidth(m, [&](auto M) {
+    const h_size width = M ? M : m;
+    const h_size chunk = ThreadPool::chunkSize(n, min_row_chunk);
+    parallelFor(
+        0, (n + chunk - 1) / chunk,
+        [&](h_index c) {
+          double b[max_static_width];
+          const double *coefficients = beta.data();
+          if constexpr (M != 0) {
+            std::copy(beta.begin(), beta.end(), b);
+            coefficients = b;
+          }
+          const h_size last = std::min(n, (c + 1) * chunk) * width;
+          for (h_index i = c * chunk * width; i < last; i += width)
+            for (h_index k = 0; k < width; ++k)
+              y[i + k] = x[i + k] + coefficients[k] * y[i + k];
+        },
+        1);
+  });
+}
 
-  // 2. Solve the linear system
-  x = cg.solve(b);
+namespace {
+
+/// Fused CG update (see cgUpdate). With Jacobi, the preconditioned residual
+/// and its dot products are produced in the same pass.
+template <bool Jacobi>
+void cgUpdateRows(std::span<const double> alpha, const MultiVector &P,
+                  const MultiVector &Q, MultiVector &X, MultiVector &R,
+                  std::span<double> r_dot_r, const double *inverse_diagonal,
+                  double *z, std::span<double> r_dot_z) {
+  const h_size m = P.cols();
+  HERMES_ASSERT(alpha.size() == m && r_dot_r.size() == m);
+  HERMES_ASSERT(Q.rows() == P.rows() && X.rows() == P.rows() &&
+                R.rows() == P.rows());
+  const double *p = P.data();
+  const double *q = Q.data();
+  double *x = X.data();
+  double *r = R.data();
+  // both reductions share one pass, packed as [r.r | r.z]
+  std::vector<double> dots(Jacobi ? 2 * m : m);
+  dispatchWidth(m, [&](auto M) {
+    const h_size width = M ? M : m;
+    reduceRows(P.rows(), dots, [&](h_size first, h_size last, double *dot) {
+      double a[max_static_width];
+      const double *coefficients = alpha.data();
+      if constexpr (M != 0) {
+        std::copy(alpha.begin(), alpha.end(), a);
+        coefficients = a;
+      }
+      double rr[max_static_width] = {}, rz[max_static_width] = {};
+      double *rr_out = M ? rr : dot;
+      double *rz_out = M ? rz : dot + width;
+      for (h_index i = first; i < last; ++i) {
+        // the row is updated from locals so the compiler does not have to
+        // assume x, r and z overlap
+        double r_i[max_static_width];
+        for (h_index c = 0; c < (M ? width : 1); ++c)
+          r_i[c] = r[i * width + c];
+        for (h_index c = 0; c < width; ++c) {
+          const h_index j = i * width + c;
+          const double r_j = (M ? r_i[c] : r[j]) - coefficients[c] * q[j];
+          x[j] += coefficients[c] * p[j];
+          if constexpr (M != 0)
+            r_i[c] = r_j;
+          else
+            r[j] = r_j;
+          rr_out[c] += r_j * r_j;
+          if constexpr (Jacobi)
+            rz_out[c] += inverse_diagonal[i] * r_j * r_j;
+        }
+        if constexpr (M != 0)
+          for (h_index c = 0; c < width; ++c) {
+            r[i * width + c] = r_i[c];
+            if constexpr (Jacobi)
+              z[i * width + c] = inverse_diagonal[i] * r_i[c];
+          }
+        else if constexpr (Jacobi)
+          for (h_index c = 0; c < width; ++c)
+            z[i * width + c] = inverse_diagonal[i] * r[i * width + c];
+      }
+      if constexpr (M != 0) {
+        std::copy(rr, rr + width, dot);
+        if constexpr (Jacobi)
+          std::copy(rz, rz + width, dot + width);
+      }
+    });
+  });
+  std::copy(dots.begin(), dots.begin() + m, r_dot_r.begin());
+  if constexpr (Jacobi)
+    std::copy(dots.begin() + m, dots.end(), r_dot_z.begin());
+}
 
-  // --- Output results and convergence information ---
-  std::cout << "Solver info:" << std::endl;
-  std::cout << "#iterations: " << cg.iterations() << std::endl;
-  std::cout << "Estimated error: " << cg.error() << std::endl;
+} // namespace
+
+void cgUpdate(std::span<const double> alpha, const MultiVector &P,
+              const MultiVector &Q, MultiVector &X, MultiVector &R,
+              std::span<double> r_dot_r) {
+  cgUpdateRows<false>(alpha, P, Q, X, R, r_dot_r, nullptr, nullptr, {});
+}
+
+void cgUpdate(std::span<const double> alpha, const MultiVector &P,
+              const MultiVector &Q, MultiVector &X, MultiVector &R,
+              std::span<double> r_dot_r,
+              const Eigen::VectorXd &inverse_diagonal, MultiVector &Z,
+              std::span<double> r_dot_z) {
+  HERMES_ASSERT(inverse_diagonal.size() == P.rows());
+  HERMES_ASSERT(Z.rows() == P.rows() && Z.cols() == P.cols());
+  HERMES_ASSERT(r_dot_z.size() == static_cast<h_size>(P.cols()));
+  cgUpdateRows<true>(alpha, P, Q, X, R, r_dot_r, inverse_diagonal.data(),
+                     Z.data(), r_dot_z);
+}
 
-  // You can also control the max iterations and tolerance if needed
-  cg.setMaxIterations(100);
-  cg.setTolerance(1e-6);
+LDLT::LDLT() { keep_pattern_ = true; }
 
-  //
+h_size LDLT::factorNonZeros() const {
+  if (!analyzed_)
+    return 0;
+  return ldlt_.matrixL().nestedExpression().nonZeros();
+}
+
+void LDLT::buildSystem() {
+  if (!assemble(implicit_, A_, keep_pattern_) || !analyzed_) {
+    // new structure, redo the symbolic analysis
+    ldlt_.analyzePattern(A_);
+    analyzed_ = true;
+  }
+  ldlt_.factorize(A_);
+  if (ldlt_.info() != Eigen::Success)
+    HERMES_WARN("LDLT factorization failed (zero pivot).");
+}
+
+SolveReport LDLT::solveFor(core::FieldRef<real_t> &unknown_field,
+                           const Scalar &rhs) const {
+  h_size n = implicit_.size();
+
+  MultiVector b(n, 1);
+  for (h_index i = 0; i < n; ++i)
+    b(i, 0) = rhs[i];
+
+  auto reports = solveBlock(b);
   for (h_index i = 0; i < n; ++i)
-    unknown_field[i] = x[i];
+    unknown_field[i] = b(i, 0);
+  return std::move(reports[0]);
+}
+
+std::vector<SolveReport>
+LDLT::solveBlockFor(std::vector<core::FieldRef<real_t>> &unknown_fields,
+                    const MultiVector &rhs) const {
+  MultiVector X = rhs;
+  auto reports = solveBlock(X);
+  const h_size n = X.rows();
+  for (h_index k = 0; k < unknown_fields.size(); ++k)
+    for (h_index i = 0; i < n; ++i)
+      unknown_fields[k][i] = X(i, k);
+  return reports;
+}
+
+std::vector<SolveReport> LDLT::solveBlock(MultiVector &X) const {
+  const h_size m = X.cols();
+  std::vector<double> b_norm(m), r_norm(m);
+  columnDot(X, X, b_norm);
+  MultiVector R = X;
+
+  // the factor is traversed once per column, but the analysis and the
+  // numeric factorization are shared by all of them
+  X = ldlt_.solve(Eigen::MatrixXd(X));
+  const bool success = ldlt_.info() == Eigen::Success;
+
+  MultiVector AX;
+  multiply(A_, X, AX);
+  R -= AX;
+  columnDot(R, R, r_norm);
+
+  std::vector<SolveReport> reports(m);
+  for (h_index k = 0; k < m; ++k) {
+    auto &report = reports[k];
+    b_norm[k] = std::sqrt(b_norm[k]);
+    report.converged = success;
+    report.initial_residual = b_norm[k];
+    report.residual = std::sqrt(r_norm[k]);
+    report.error = b_norm[k] > 0 ? report.residual / b_norm[k] : 0;
+  }
+  return reports;
 }
 
-} // namespace naiades::numeric::solvers
\ No newline at end of file
+} // namespace naiades::numeric::solvers
@@ -29,30 +29,115 @@
 #include <naiades/core/field.h>
 #include <naiades/numeric/discrete_expression.h>
 
+#include <Eigen/IterativeLinearSolvers>
 #include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
 
 namespace naiades::numeric::solvers {
 
+/// Dense block of vectors (one column per right-hand side). Rows are stored
+/// contiguously so a sparse product reads each matrix row once for all
+/// columns.
+using MultiVector =
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+/// Convergence settings of iterative solvers.
+struct SolverOptions {
+  /// Relative tolerance, the solve stops when |b - A x| <= tolerance |b|.
+  real_t tolerance{1e-6};
+  /// Absolute tolerance, the solve also stops when
+  /// |b - A x| <= absolute_tolerance.
+  real_t absolute_tolerance{0};
+  /// Iteration limit (0 lets the solver choose).
+  h_size max_iterations{0};
+  /// If true, the current contents of the unknown field are used as the
+  /// initial guess (e.g. the previous time step), otherwise the solve starts
+  /// from zero.
+  bool warm_start{false};
+};
+
+/// Outcome of a solve.
+struct SolveReport {
+  bool converged{false};
+  /// Iterations (or cycles) performed, 0 for direct solvers.
+  h_size iterations{0};
+  /// Residual norm |b - A x0| of the initial guess.
+  real_t initial_residual{0};
+  /// Residual norm |b - A x| of the solution.
+  real_t residual{0};
+  /// Relative residual |b - A x| / |b|.
+  real_t error{0};
+  /// Residual norm after each iteration.
+  std::vector<real_t> residual_history;
+  /// Wall time in seconds of the last build (assembly and factorization).
+  f64 build_time{0};
+  /// Wall time in seconds of the solve (of the whole batch for batched
+  /// solves).
+  f64 solve_time{0};
+};
+
 /// Interface for linear solvers
 /// \tparam Derived
 template <typename Derived> class LinearSystemSolver {
 public:
   Derived &setUnknown(const core::DiscreteSymbol &unknown);
+  Derived &setOptions(const SolverOptions &options);
+  /// \param tolerance Relative residual tolerance for iterative solvers.
+  Derived &setTolerance(real_t tolerance);
+  /// \param max_iterations Iteration limit for iterative solvers (0 lets the
+  ///                       solver choose).
+  Derived &setMaxIterations(h_size max_iterations);
+  /// \param warm_start Start iterative solves from the current unknown field.
+  Derived &setWarmStart(bool warm_start);
+  /// When enabled, the sparsity pattern (and any symbolic analysis) of the
+  /// system is kept between builds and only values are refilled, as long as
+  /// the pattern of the implicit expression does not change.
+  Derived &setKeepPattern(bool keep_pattern);
+
+  const SolverOptions &options() const;
 
   Derived &build(const DiscreteExpression &lhs, const DiscreteExpression &rhs);
 
-  void
+  SolveReport
   solve(core::FieldRef<real_t> &unknown_field,
         const std::vector<core::FieldCRef<real_t>> &explicit_fields = {}) const;
+  /// Solves the same system for several right-hand sides at once.
+  /// \param unknown_fields One unknown field per system.
+  /// \param explicit_fields explicit_fields[k] is the explicit field of
+  ///                        unknown_fields[k] (empty for constant rhs).
+  /// \return One report per unknown field.
+  std::vector<SolveReport>
+  solve(std::vector<core::FieldRef<real_t>> &unknown_fields,
+        const std::vector<core::FieldCRef<real_t>> &explicit_fields = {}) const;
 
 protected:
   virtual void buildSystem() = 0;
-  virtual void solveFor(core::FieldRef<real_t> &unknown_field,
-                        const Scalar &rhs) const = 0;
+  /// Solves into unknown_field, which holds the initial guess if the warm
+  /// start option is set. Timings are filled by the caller.
+  virtual SolveReport solveFor(core::FieldRef<real_t> &unknown_field,
+                               const Scalar &rhs) const = 0;
+  /// Solves for each column of rhs. The default solves them one by one.
+  virtual std::vector<SolveReport>
+  solveBlockFor(std::vector<core::FieldRef<real_t>> &unknown_fields,
+                const MultiVector &rhs) const;
+  /// \return The residual norm below which a system with right-hand side
+  ///         norm b_norm is converged.
+  real_t residualThreshold(real_t b_norm) const;
 
   core::DiscreteSymbol unknown_;
   DiscreteExpression implicit_;
   DiscreteExpression explicit_;
+  SolverOptions options_;
+  bool keep_pattern_{false};
+  f64 build_time_{0};
 };
 
 template <typename Derived>
@@ -62,43 +147,410 @@ LinearSystemSolver<Derived>::setUnknown(const core::DiscreteSymbol &sym) {
   return *reinterpret_cast<Derived *>(this);
 }
 
+template <typename Derived>
+Derived &
+LinearSystemSolver<Derived>::setOptions(const SolverOptions &options) {
+  options_ = options;
+  return *reinterpret_cast<Derived *>(this);
+}
+
+template <typename Derived>
+Derived &LinearSystemSolver<Derived>::setTolerance(real_t tolerance) {
+  options_.tolerance = tolerance;
+  return *reinterpret_cast<Derived *>(this);
+}
+
+template <typename Derived>
+Derived &LinearSystemSolver<Derived>::setMaxIterations(h_size max_iterations) {
+  options_.max_iterations = max_iterations;
+  return *reinterpret_cast<Derived *>(this);
+}
+
+template <typename Derived>
+Derived &LinearSystemSolver<Derived>::setWarmStart(bool warm_start) {
+  options_.warm_start = warm_start;
+  return *reinterpret_cast<Derived *>(this);
+}
+
+template <typename Derived>
+Derived &LinearSystemSolver<Derived>::setKeepPattern(bool keep_pattern) {
+  keep_pattern_ = keep_pattern;
+  return *reinterpret_cast<Derived *>(this);
+}
+
+template <typename Derived>
+const SolverOptions &LinearSystemSolver<Derived>::options() const {
+  return options_;
+}
+
 template <typename Derived>
 Derived &LinearSystemSolver<Derived>::build(const DiscreteExpression &lhs,
                                             const DiscreteExpression &rhs) {
+  const auto start = std::chrono::steady_clock::now();
   // separate implicit and explicit parts
   implicit_ = lhs;
   explicit_ = rhs;
   buildSystem();
+  build_time_ = std::chrono::duration<f64>(std::chrono::steady_clock::now() -
+                                           start)
+                    .count();
   return *reinterpret_cast<Derived *>(this);
 }
 
 template <typename Derived>
-void LinearSystemSolver<Derived>::solve(
+SolveReport LinearSystemSolver<Derived>::solve(
     core::FieldRef<real_t> &unknown_field,
     const std::vector<core::FieldCRef<real_t>> &explicit_fields) const {
+  const auto start = std::chrono::steady_clock::now();
   // compute explicit side
   Scalar rhs(unknown_field.size());
   if (!explicit_fields.empty()) {
     HERMES_ASSERT(unknown_field.size() == explicit_fields[0].size());
     for (h_index i = 0; i < rhs.size(); ++i) {
-      rhs[i] = explicit_fields[0][i] - implicit_[i].constant();
+      rhs[i] = explicit_fields[0][i] - implicit_.constant(i);
     }
   } else {
     HERMES_ASSERT(explicit_.isConstant());
     for (h_index i = 0; i < rhs.size(); ++i) {
-      rhs[i] = -implicit_[i].constant();
+      rhs[i] = -implicit_.constant(i);
     }
   }
-  solveFor(unknown_field, rhs);
+  auto report = solveFor(unknown_field, rhs);
+  report.build_time = build_time_;
+  report.solve_time =
+      std::chrono::duration<f64>(std::chrono::steady_clock::now() - start)
+          .count();
+  return report;
+}
+
+template <typename Derived>
+std::vector<SolveReport> LinearSystemSolver<Derived>::solve(
+    std::vector<core::FieldRef<real_t>> &unknown_fields,
+    const std::vector<core::FieldCRef<real_t>> &explicit_fields) const {
+  if (unknown_fields.empty())
+    return {};
+  const auto start = std::chrono::steady_clock::now();
+  const h_size n = unknown_fields[0].size();
+  const h_size m = unknown_fields.size();
+  HERMES_ASSERT(explicit_fields.empty() || explicit_fields.size() == m);
+  if (explicit_fields.empty())
+    HERMES_ASSERT(explicit_.isConstant());
+  MultiVector rhs(n, m);
+  for (h_index i = 0; i < n; ++i) {
+    const real_t c = implicit_.constant(i);
+    for (h_index k = 0; k < m; ++k)
+      rhs(i, k) = (explicit_fields.empty() ? 0 : explicit_fields[k][i]) - c;
+  }
+  auto reports = solveBlockFor(unknown_fields, rhs);
+  const f64 solve_time =
+      std::chrono::duration<f64>(std::chrono::steady_clock::now() - start)
+          .count();
+  for (auto &report : reports) {
+    report.build_time = build_time_;
+    report.solve_time = solve_time;
+  }
+  return reports;
 }
 
-class CG : public LinearSystemSolver<CG> {
+template <typename Derived>
+std::vector<SolveReport> LinearSystemSolver<Derived>::solveBlockFor(
+    std::vector<core::FieldRef<real_t>> &unknown_fields,
+    const MultiVector &rhs) const {
+  std::vector<SolveReport> reports;
+  reports.reserve(unknown_fields.size());
+  Scalar b(rhs.rows());
+  for (h_index k = 0; k < unknown_fields.size(); ++k) {
+    for (h_index i = 0; i < b.size(); ++i)
+      b[i] = rhs(i, k);
+    reports.emplace_back(solveFor(unknown_fields[k], b));
+  }
+  return reports;
+}
+
+template <typename Derived>
+real_t LinearSystemSolver<Derived>::residualThreshold(real_t b_norm) const {
+  return std::max(options_.tolerance * b_norm, options_.absolute_tolerance);
+}
+
+/// Row-major sparse matrix sharing the CSR layout of discrete expressions.
+using SparseMatrix = Eigen::SparseMatrix<double, Eigen::RowMajor>;
+
+/// Fills a sparse matrix with the coefficients of a discrete expression.
+/// \param expression
+/// \param A
+/// \param keep_pattern If true and A already has the sparsity pattern of the
+///                     expression, only values are copied.
+/// \return true if the pattern of A was kept.
+bool assemble(const DiscreteExpression &expression, SparseMatrix &A,
+              bool keep_pattern);
+
+// Block kernels. Columns are independent vectors; every kernel makes a
+// single pass over the rows, so the cost of reading the matrix (or the
+// rows) is shared by all columns.
+
+/// Computes Y = A X for all columns of X in a single pass over A.
+/// \param dots If not empty, receives X.col(k) . Y.col(k) (A square).
+void multiply(const SparseMatrix &A, const MultiVector &X, MultiVector &Y,
+              std::span<double> dots = {});
+/// result[k] = X.col(k) . Y.col(k)
+void columnDot(const MultiVector &X, const MultiVector &Y,
+               std::span<double> result);
+/// Y.col(k) = X.col(k) + beta[k] * Y.col(k)
+void columnXpay(const MultiVector &X, std::span<const double> beta,
+                MultiVector &Y);
+/// CG step X += alpha P, R -= alpha Q (per column) that also returns the
+/// squared residual norms.
+void cgUpdate(std::span<const double> alpha, const MultiVector &P,
+              const MultiVector &Q, MultiVector &X, MultiVector &R,
+              std::span<double> r_dot_r);
+/// Same as above, also applying the Jacobi preconditioner
+/// Z = diag(inverse_diagonal) R and returning R.col(k) . Z.col(k).
+void cgUpdate(std::span<const double> alpha, const MultiVector &P,
+              const MultiVector &Q, MultiVector &X, MultiVector &R,
+              std::span<double> r_dot_r,
+              const Eigen::VectorXd &inverse_diagonal, MultiVector &Z,
+              std::span<double> r_dot_z);
+
+/// Preconditioned conjugate gradient.
+/// \tparam Preconditioner Eigen compatible preconditioner.
+template <typename Preconditioner>
+class PCG : public LinearSystemSolver<PCG<Preconditioner>> {
+public:
+  using Matrix = SparseMatrix;
+
+  /// Preconditioners that need extra setup (e.g. the grid resolution) must be
+  /// configured before build.
+  Preconditioner &preconditioner() { return preconditioner_; }
+  /// \return The name of the preconditioner (for reports).
+  static constexpr std::string_view preconditionerName();
+  /// \return Iterations of the last solve (the largest over all columns of a
+  ///         batched solve).
+  h_size iterations() const { return iterations_; }
+  /// \return Relative residual of the last solve (the largest over all
+  ///         columns of a batched solve).
+  real_t error() const { return error_; }
+
+private:
+  void buildSystem() override;
+  SolveReport solveFor(core::FieldRef<real_t> &unknown_field,
+                       const Scalar &rhs) const override;
+  std::vector<SolveReport>
+  solveBlockFor(std::vector<core::FieldRef<real_t>> &unknown_fields,
+                const MultiVector &rhs) const override;
+  /// Runs one CG recurrence per column in lockstep so every iteration does a
+  /// single sparse product for all right-hand sides.
+  /// \param rhs
+  /// \param X Initial guesses (used if warm start is set), receives the
+  ///          solutions.
+  std::vector<SolveReport> iterate(const MultiVector &rhs,
+                                   MultiVector &X) const;
+
+  Matrix A_;
+  mutable Preconditioner preconditioner_;
+  mutable h_size iterations_{0};
+  mutable real_t error_{0};
+};
+
+template <typename Preconditioner>
+constexpr std::string_view PCG<Preconditioner>::preconditionerName() {
+  if constexpr (requires { Preconditioner::name; })
+    return Preconditioner::name;
+  else if constexpr (std::is_same_v<Preconditioner,
+                                    Eigen::DiagonalPreconditioner<double>>)
+    return "jacobi";
+  else if constexpr (std::is_same_v<Preconditioner,
+                                    Eigen::IdentityPreconditioner>)
+    return "identity";
+  else
+    return "custom";
+}
+
+template <typename Preconditioner> void PCG<Preconditioner>::buildSystem() {
+  // the symbolic setup is kept while the structure does not change
+  if (!assemble(this->implicit_, A_, this->keep_pattern_))
+    preconditioner_.analyzePattern(A_);
+  preconditioner_.factorize(A_);
+}
+
+template <typename Preconditioner>
+SolveReport
+PCG<Preconditioner>::solveFor(core::FieldRef<real_t> &unknown_field,
+                              const Scalar &rhs) const {
+  const h_size n = this->implicit_.size();
+  MultiVector b(n, 1), X(n, 1);
+  for (h_index i = 0; i < n; ++i) {
+    b(i, 0) = rhs[i];
+    X(i, 0) = this->options_.warm_start ? unknown_field[i] : 0;
+  }
+  auto reports = iterate(b, X);
+  for (h_index i = 0; i < n; ++i)
+    unknown_field[i] = X(i, 0);
+  return std::move(reports[0]);
+}
+
+template <typename Preconditioner>
+std::vector<SolveReport> PCG<Preconditioner>::solveBlockFor(
+    std::vector<core::FieldRef<real_t>> &unknown_fields,
+    const MultiVector &rhs) const {
+  const h_size n = rhs.rows();
+  const h_size m = rhs.cols();
+  MultiVector X(n, m);
+  for (h_index i = 0; i < n; ++i)
+    for (h_index k = 0; k < m; ++k)
+      X(i, k) = this->options_.warm_start ? unknown_fields[k][i] : 0;
+  auto reports = iterate(rhs, X);
+  for (h_index k = 0; k < m; ++k)
+    for (h_index i = 0; i < n; ++i)
+      unknown_fields[k][i] = X(i, k);
+  return reports;
+}
+
+template <typename Preconditioner>
+std::vector<SolveReport>
+PCG<Preconditioner>::iterate(const MultiVector &rhs, MultiVector &X) const {
+  const h_size n = rhs.rows();
+  const h_size m = rhs.cols();
+  constexpr bool jacobi =
+      std::is_same_v<Preconditioner, Eigen::DiagonalPreconditioner<double>>;
+  Eigen::VectorXd inverse_diagonal;
+  if constexpr (jacobi) {
+    // same as Eigen's diagonal preconditioner, fused into the update
+    inverse_diagonal = A_.diagonal();
+    for (h_index i = 0; i < n; ++i)
+      inverse_diagonal[i] =
+          inverse_diagonal[i] == 0 ? 1 : 1 / inverse_diagonal[i];
+  }
+
+  MultiVector R = rhs;
+  MultiVector Z = MultiVector::Zero(n, m);
+  MultiVector P(n, m), Q(n, m);
+  std::vector<double> b_norm(m), r_norm(m), rz(m), rz_new(m), pq(m), alpha(m),
+      beta(m), threshold(m);
+  std::vector<bool> active(m);
+  std::vector<SolveReport> reports(m);
+
+  // Z = M^-1 R, converged columns are skipped
+  const auto precondition = [&]() {
+    Eigen::VectorXd r(n);
+    for (h_index k = 0; k < m; ++k)
+      if (active[k]) {
+        r = R.col(k);
+        Z.col(k) = preconditioner_.solve(r);
+      }
+  };
+
+  columnDot(rhs, rhs, b_norm);
+  if (this->options_.warm_start) {
+    multiply(A_, X, Q);
+    R -= Q;
+  } else
+    X.setZero();
+  for (h_index k = 0; k < m; ++k) {
+    b_norm[k] = std::sqrt(b_norm[k]);
+    // the solution of a zero system is zero, whatever the guess
+    if (b_norm[k] == 0) {
+      X.col(k).setZero();
+      R.col(k).setZero();
+    }
+  }
+  columnDot(R, R, r_norm);
+  for (h_index k = 0; k < m; ++k) {
+    r_norm[k] = std::sqrt(r_norm[k]);
+    threshold[k] = this->residualThreshold(b_norm[k]);
+    active[k] = r_norm[k] > threshold[k];
+    reports[k].initial_residual = r_norm[k];
+  }
+  if constexpr (jacobi) {
+    for (h_index i = 0; i < n; ++i)
+      Z.row(i) = inverse_diagonal[i] * R.row(i);
+  } else
+    precondition();
+  columnDot(R, Z, rz);
+  P = Z;
+
+  const h_size max_iterations =
+      this->options_.max_iterations ? this->options_.max_iterations : 2 * n;
+  h_size iteration = 0;
+  while (iteration < max_iterations &&
+         std::find(active.begin(), active.end(), true) != active.end()) {
+    // a single pass over A for all right-hand sides
+    multiply(A_, P, Q, pq);
+    // converged columns are frozen with a zero step
+    for (h_index k = 0; k < m; ++k)
+      alpha[k] = active[k] ? rz[k] / pq[k] : 0;
+    if constexpr (jacobi)
+      cgUpdate(alpha, P, Q, X, R, r_norm, inverse_diagonal, Z, rz_new);
+    else
+      cgUpdate(alpha, P, Q, X, R, r_norm);
+    ++iteration;
+
+    for (h_index k = 0; k < m; ++k) {
+      r_norm[k] = std::sqrt(r_norm[k]);
+      if (!active[k])
+        continue;
+      ++reports[k].iterations;
+      reports[k].residual_history.emplace_back(r_norm[k]);
+      if (r_norm[k] <= threshold[k])
+        active[k] = false;
+    }
+    if constexpr (!jacobi) {
+      precondition();
+      columnDot(R, Z, rz_new);
+    }
+    for (h_index k = 0; k < m; ++k) {
+      beta[k] = active[k] ? rz_new[k] / rz[k] : 0;
+      rz[k] = rz_new[k];
+    }
+    columnXpay(Z, beta, P);
+  }
+
+  iterations_ = 0;
+  error_ = 0;
+  for (h_index k = 0; k < m; ++k) {
+    auto &report = reports[k];
+    report.converged = !active[k];
+    report.residual = r_norm[k];
+    report.error = b_norm[k] > 0 ? r_norm[k] / b_norm[k] : 0;
+    iterations_ = std::max(iterations_, report.iterations);
+    error_ = std::max(error_, report.error);
+  }
+  return reports;
+}
+
+/// Conjugate gradient with diagonal (Jacobi) preconditioning.
+using CG = PCG<Eigen::DiagonalPreconditioner<double>>;
+
+/// Direct solver based on a sparse LDL^T (Cholesky) factorization of the
+/// implicit system.
+/// \note The system must be symmetric (only its lower part is read). The
+///       fill-reducing (AMD) ordering and the elimination tree are computed
+///       once; while the sparsity pattern is kept (see setKeepPattern,
+///       enabled by default) rebuilding only refactors numerically, and
+///       each solve costs two triangular sweeps over the factor.
+/// \note Solver options are ignored. Reports hold the residual of the
+///       solution, which costs one extra product with the matrix.
+class LDLT : public LinearSystemSolver<LDLT> {
 public:
+  using Matrix = SparseMatrix;
+
+  LDLT();
+
+  /// \return The number of non-zeros of the factor L.
+  h_size factorNonZeros() const;
+
 private:
   void buildSystem() override;
-  void solveFor(core::FieldRef<real_t> &unknown_field,
-                const Scalar &rhs) const override;
-  Eigen::SparseMatrix<double> A_;
+  SolveReport solveFor(core::FieldRef<real_t> &unknown_field,
+                       const Scalar &rhs) const override;
+  std::vector<SolveReport>
+  solveBlockFor(std::vector<core::FieldRef<real_t>> &unknown_fields,
+                const MultiVector &rhs) const override;
+  /// Solves for the columns of X in place.
+  std::vector<SolveReport> solveBlock(MultiVector &X) const;
+
+  Matrix A_;
+  Eigen::SimplicialLDLT<Matrix, Eigen::Lower, Eigen::AMDOrdering<int>> ldlt_;
+  bool analyzed_{false};
 };
 
-} // namespace naiades::numeric::solvers
\ No newline at end of file
+} // namespace naiades::numeric::solvers
@@ -0,0 +1,161 @@
+/* Copyright (c) 2026, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/// \file   matrix_free.cpp
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-16
+
+#include <naiades/numeric/matrix_free.h>
+
+namespace naiades::numeric {
+
+Grid2Laplacian::Config &
+Grid2Laplacian::Config::setDiscretization(const Grid2FD &fd) {
+  fd_ = &fd;
+  return *this;
+}
+
+Grid2Laplacian::Config &
+Grid2Laplacian::Config::setSymbol(const core::DiscreteSymbol &sym) {
+  sym_ = sym;
+  return *this;
+}
+
+Result<Grid2Laplacian> Grid2Laplacian::Config::build() const {
+  if (!fd_ || !sym_.symbol.loc.is(core::element_primitive_bits::cell)) {
+    HERMES_ERROR("Matrix-free Laplacian requires a Grid2FD cell symbol.");
+    return NaResult::inputError();
+  }
+  if (!fd_->boundaries().count(sym_.boundary_symbol)) {
+    HERMES_ERROR("Missing boundary for symbol {}.", sym_.symbol.name);
+    return NaResult::notFound();
+  }
+
+  const auto &mesh = fd_->mesh();
+  const auto d = mesh.cellSize();
+
+  Grid2Laplacian L;
+  L.resolution_ = mesh.resolution(sym_.symbol.loc);
+  // same weights as Grid2FD::derivative
+  L.kx_ = 1.0 / (d.x * d.x);
+  L.ky_ = 1.0 / (d.y * d.y);
+  L.center_ = -2 * L.kx_ - 2 * L.ky_;
+
+  const h_size w = L.resolution_.width;
+  const h_size h = L.resolution_.height;
+  const h_size boundary_count = w < 3 || h < 3 ? w * h : 2 * (w + h) - 4;
+  L.boundary_rows_.reserve(boundary_count);
+  L.boundary_offsets_.reserve(boundary_count + 1);
+  L.columns_.reserve(5 * boundary_count);
+  L.weights_.reserve(5 * boundary_count);
+  L.constants_.reserve(boundary_count);
+  L.boundary_offsets_.emplace_back(0);
+  for (h_size j = 0; j < h; ++j)
+    for (h_size i = 0; i < w; ++i) {
+      if (i > 0 && j > 0 && i + 1 < w && j + 1 < h)
+        continue;
+      const h_size row = j * w + i;
+      auto op = fd_->laplacian(row, sym_);
+      for (const auto &node : op.nodes()) {
+        L.columns_.emplace_back(node.first);
+        L.weights_.emplace_back(node.second);
+      }
+      L.boundary_rows_.emplace_back(row);
+      L.boundary_offsets_.emplace_back(L.columns_.size());
+      L.constants_.emplace_back(op.constant());
+    }
+
+  return Result<Grid2Laplacian>(std::move(L));
+}
+
+Eigen::Index Grid2Laplacian::rows() const { return resolution_.total(); }
+
+Eigen::Index Grid2Laplacian::cols() const { return resolution_.total(); }
+
+void Grid2Laplacian::evaluate(const core::FieldCRef<real_t> &u,
+                              core::FieldRef<real_t> &out) const {
+  HERMES_ASSERT(u.size() == resolution_.total() &&
+                out.size() == resolution_.total());
+  for (h_index i = 0; i < out.size(); ++i)
+    out[i] = 0;
+  multiplyAdd(u, out, 1.0);
+  addConstants(out, 1.0);
+}
+
+const hermes::size2 &Grid2Laplacian::resolution() const { return resolution_; }
+
+h_size Grid2Laplacian::boundaryRowCount() const {
+  return boundary_rows_.size();
+}
+
+} // namespace naiades::numeric
+
+namespace naiades::numeric::solvers {
+
+MatrixFreeCG &MatrixFreeCG::setTolerance(real_t tolerance) {
+  tolerance_ = tolerance;
+  return *this;
+}
+
+MatrixFreeCG &MatrixFreeCG::setMaxIterations(h_size max_iterations) {
+  max_iterations_ = max_iterations;
+  return *this;
+}
+
+MatrixFreeCG &MatrixFreeCG::build(const Grid2Laplacian &A) {
+  A_ = A;
+  return *this;
+}
+
+void MatrixFreeCG::solve(
+    core::FieldRef<real_t> &unknown_field,
+    const std::vector<core::FieldCRef<real_t>> &explicit_fields) const {
+  const h_size n = A_.rows();
+  HERMES_ASSERT(unknown_field.size() == n);
+
+  Eigen::VectorXd x(n), b(n);
+  if (!explicit_fields.empty()) {
+    HERMES_ASSERT(explicit_fields[0].size() == n);
+    for (h_index i = 0; i < n; ++i)
+      b[i] = explicit_fields[0][i];
+  } else
+    b.setZero();
+  A_.addConstants(b, -1.0);
+
+  Eigen::ConjugateGradient<Grid2Laplacian, Eigen::Lower | Eigen::Upper,
+                           Eigen::IdentityPreconditioner>
+      cg;
+  cg.setTolerance(tolerance_);
+  if (max_iterations_)
+    cg.setMaxIterations(max_iterations_);
+  cg.compute(A_);
+  x = cg.solve(b);
+
+  if (cg.info() != Eigen::Success)
+    HERMES_WARN("CG did not converge after {} iterations (error {}).",
+                cg.iterations(), cg.error());
+
+  for (h_index i = 0; i < n; ++i)
+    unknown_field[i] = x[i];
+}
+
+} // namespace naiades::numeric::solvers
@@ -0,0 +1,208 @@
+/* Copyright (c) 2026, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/// \file   matrix_free.h
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-16
+/// \brief  Matrix-free discrete operators.
+
+#pragma once
+
+#include <naiades/geo/grid.h>
+
+#include <Eigen/IterativeLinearSolvers>
+#include <Eigen/Sparse>
+
+namespace naiades::numeric {
+class Grid2Laplacian;
+} // namespace naiades::numeric
+
+namespace Eigen::internal {
+
+template <>
+struct traits<naiades::numeric::Grid2Laplacian>
+    : public Eigen::internal::traits<Eigen::SparseMatrix<double>> {};
+
+} // namespace Eigen::internal
+
+namespace naiades::numeric {
+
+/// \brief Matrix-free discrete Laplacian of a Grid2FD cell field.
+///
+/// Interior cells apply the uniform 5-point stencil of Grid2FD::laplacian,
+/// with weights computed from the cell size, so no per-cell storage is
+/// needed. Only cells touching the domain boundary keep explicit stencils
+/// (with their boundary conditions resolved), stored as compressed rows.
+///
+/// The operator models an Eigen sparse matrix, so it can be used directly as
+/// the matrix of Eigen's iterative solvers.
+///
+/// \note Boundaries of the symbol must be resolved before building.
+class Grid2Laplacian : public Eigen::EigenBase<Grid2Laplacian> {
+public:
+  struct Config {
+    Config &setDiscretization(const Grid2FD &fd);
+    Config &setSymbol(const core::DiscreteSymbol &sym);
+
+    Result<Grid2Laplacian> build() const;
+
+  private:
+    const Grid2FD *fd_{nullptr};
+    core::DiscreteSymbol sym_;
+  };
+
+  // Eigen interface
+
+  using Scalar = double;
+  using RealScalar = double;
+  using StorageIndex = int;
+  enum {
+    ColsAtCompileTime = Eigen::Dynamic,
+    MaxColsAtCompileTime = Eigen::Dynamic,
+    IsRowMajor = false
+  };
+
+  Eigen::Index rows() const;
+  Eigen::Index cols() const;
+
+  template <typename Rhs>
+  Eigen::Product<Grid2Laplacian, Rhs, Eigen::AliasFreeProduct>
+  operator*(const Eigen::MatrixBase<Rhs> &x) const {
+    return Eigen::Product<Grid2Laplacian, Rhs, Eigen::AliasFreeProduct>(
+        *this, x.derived());
+  }
+
+  /// Computes y += alpha * A x, where A is the implicit part of the operator.
+  /// \note Boundary constants are not included.
+  template <typename X, typename Y>
+  void multiplyAdd(const X &x, Y &y, double alpha) const;
+  /// Computes y += alpha * c, where c holds the boundary constants.
+  template <typename Y> void addConstants(Y &y, double alpha) const;
+  /// Evaluates the full operator L(u) = A u + c.
+  void evaluate(const core::FieldCRef<real_t> &u,
+                core::FieldRef<real_t> &out) const;
+
+  /// Cell resolution.
+  const hermes::size2 &resolution() const;
+  /// Number of cells with explicit (boundary) stencils.
+  h_size boundaryRowCount() const;
+
+private:
+  hermes::size2 resolution_;
+  // interior stencil weights
+  double center_{0};
+  double kx_{0};
+  double ky_{0};
+  // boundary rows, in row-major cell order
+  std::vector<h_size> boundary_rows_;
+  std::vector<h_size> boundary_offsets_;
+  std::vector<h_size> columns_;
+  std::vector<double> weights_;
+  std::vector<double> constants_;
+};
+
+template <typename X, typename Y>
+void Grid2Laplacian::multiplyAdd(const X &x, Y &y, double alpha) const {
+  const h_size w = resolution_.width;
+  const h_size h = resolution_.height;
+  h_size k = 0;
+  auto boundaryRow = [&]() {
+    double ax = 0;
+    for (h_size o = boundary_offsets_[k]; o < boundary_offsets_[k + 1]; ++o)
+      ax += weights_[o] * x[columns_[o]];
+    y[boundary_rows_[k++]] += alpha * ax;
+  };
+  for (h_size j = 0; j < h; ++j) {
+    if (j == 0 || j + 1 == h || w < 3) {
+      for (h_size i = 0; i < w; ++i)
+        boundaryRow();
+      continue;
+    }
+    boundaryRow();
+    for (h_size f = j * w + 1; f < (j + 1) * w - 1; ++f)
+      y[f] += alpha * (center_ * x[f] + kx_ * (x[f - 1] + x[f + 1]) +
+                       ky_ * (x[f - w] + x[f + w]));
+    boundaryRow();
+  }
+}
+
+template <typename Y>
+void Grid2Laplacian::addConstants(Y &y, double alpha) const {
+  for (h_size k = 0; k < boundary_rows_.size(); ++k)
+    y[boundary_rows_[k]] += alpha * constants_[k];
+}
+
+} // namespace naiades::numeric
+
+namespace Eigen::internal {
+
+template <typename Rhs>
+struct generic_product_impl<naiades::numeric::Grid2Laplacian, Rhs, SparseShape,
+                            DenseShape, GemvProduct>
+    : generic_product_impl_base<
+          naiades::numeric::Grid2Laplacian, Rhs,
+          generic_product_impl<naiades::numeric::Grid2Laplacian, Rhs>> {
+  using Scalar =
+      typename Product<naiades::numeric::Grid2Laplacian, Rhs>::Scalar;
+
+  template <typename Dest>
+  static void scaleAndAddTo(Dest &dst,
+                            const naiades::numeric::Grid2Laplacian &lhs,
+                            const Rhs &rhs, const Scalar &alpha) {
+    typename nested_eval<Rhs, 1>::type x(rhs);
+    lhs.multiplyAdd(x, dst, alpha);
+  }
+};
+
+} // namespace Eigen::internal
+
+namespace naiades::numeric::solvers {
+
+/// \brief Conjugate gradient over a matrix-free Grid2 Laplacian.
+///
+/// Example:
+///   auto L = Grid2Laplacian::Config()
+///                .setDiscretization(fd)
+///                .setSymbol(p)
+///                .build()
+///                .value();
+///   solvers::MatrixFreeCG cg;
+///   cg.setTolerance(1e-6).build(L);
+///   cg.solve(p_field, {div_field});
+class MatrixFreeCG {
+public:
+  MatrixFreeCG &setTolerance(real_t tolerance);
+  MatrixFreeCG &setMaxIterations(h_size max_iterations);
+  MatrixFreeCG &build(const Grid2Laplacian &A);
+
+  /// Solves A u = f - c, where f is the first explicit field (or zero).
+  void
+  solve(core::FieldRef<real_t> &unknown_field,
+        const std::vector<core::FieldCRef<real_t>> &explicit_fields = {}) const;
+
+private:
+  Grid2Laplacian A_;
+  real_t tolerance_{1e-6};
+  h_size max_iterations_{0};
+};
+
+} // namespace naiades::numeric::solvers
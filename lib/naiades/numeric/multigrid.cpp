@@ -0,0 +1,370 @@
+/* Copyright (c) 2026, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/// \file   multigrid.cpp
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-16
+
+#include <naiades/numeric/multigrid.h>
+
+#include <cmath>
+#include <numeric>
+
+namespace naiades::numeric::solvers {
+
+MultigridHierarchy &MultigridHierarchy::setSmoothingSteps(h_size pre_steps,
+                                                          h_size post_steps) {
+  pre_steps_ = pre_steps;
+  post_steps_ = post_steps;
+  return *this;
+}
+
+MultigridHierarchy &MultigridHierarchy::setMaxLevels(h_size max_levels) {
+  max_levels_ = std::max<h_size>(max_levels, 1);
+  return *this;
+}
+
+NaResult MultigridHierarchy::build(const hermes::size2 &resolution,
+                                   const DiscreteExpression &A) {
+  if (A.size() != resolution.total())
+    return NaResult::inputError();
+  NAIADES_RETURN_BAD_RESULT(buildFinest(resolution, A.rowOffsets().data(),
+                                        A.columns().data(),
+                                        A.weights().data()));
+  buildCoarseLevels();
+  return NaResult::noError();
+}
+
+NaResult MultigridHierarchy::build(const hermes::size2 &resolution,
+                                   std::span<const int> offsets,
+                                   std::span<const int> columns,
+                                   std::span<const double> values) {
+  if (offsets.size() != resolution.total() + 1 ||
+      values.size() != columns.size())
+    return NaResult::inputError();
+  NAIADES_RETURN_BAD_RESULT(buildFinest(resolution, offsets.data(),
+                                        columns.data(), values.data()));
+  buildCoarseLevels();
+  return NaResult::noError();
+}
+
+template <typename I, typename W>
+NaResult MultigridHierarchy::buildFinest(const hermes::size2 &resolution,
+                                         const I *offsets, const I *columns,
+                                         const W *values) {
+  const h_size w = resolution.width;
+  const h_size h = resolution.height;
+  const h_size n = w * h;
+  if (!n)
+    return NaResult::inputError();
+
+  levels_.clear();
+  levels_.resize(1);
+  auto &level = levels_[0];
+  level.resolution = resolution;
+
+  std::vector<Eigen::Triplet<double>> entries;
+  entries.reserve(offsets[n]);
+  singular_ = true;
+  for (h_size row = 0; row < n; ++row) {
+    double row_sum = 0;
+    double diagonal = 0;
+    for (auto k = offsets[row]; k < offsets[row + 1]; ++k) {
+      const h_size column = columns[k];
+      const double value = values[k];
+      if (column >= n) {
+        HERMES_ERROR("Multigrid expects one column per cell, but row {} "
+                     "references column {}.",
+                     row, column);
+        levels_.clear();
+        return NaResult::checkError();
+      }
+      row_sum += value;
+      if (column == row)
+        diagonal += value;
+      entries.emplace_back(row, column, value);
+    }
+    if (std::abs(row_sum) > 1e-8 * std::abs(diagonal))
+      singular_ = false;
+  }
+  level.A.resize(n, n);
+  level.A.setFromTriplets(entries.begin(), entries.end());
+  return NaResult::noError();
+}
+
+void MultigridHierarchy::buildCoarseLevels() {
+  while (levels_.size() < max_levels_) {
+    auto &fine = levels_.back();
+    const h_size w = fine.resolution.width;
+    const h_size h = fine.resolution.height;
+    if (w < 4 || h < 4)
+      break;
+
+    Level coarse;
+    coarse.resolution = hermes::size2((w + 1) / 2, (h + 1) / 2);
+    fine.P = prolongation(fine.resolution, coarse.resolution);
+    // Galerkin product, restriction is the transpose of the prolongation
+    SparseMatrix AP = fine.A * fine.P;
+    coarse.A = SparseMatrix(fine.P.transpose()) * AP;
+    coarse.A.prune(0.0);
+    levels_.emplace_back(std::move(coarse));
+  }
+
+  for (auto &level : levels_) {
+    const h_size n = level.resolution.total();
+    level.x.assign(n, 0);
+    level.b.assign(n, 0);
+    level.r.assign(n, 0);
+    level.e.assign(n, 0);
+  }
+}
+
+SparseMatrix
+MultigridHierarchy::prolongation(const hermes::size2 &fine,
+                                 const hermes::size2 &coarse) {
+  const h_size w = fine.width;
+  const h_size h = fine.height;
+  const h_size cw = coarse.width;
+  const h_size ch = coarse.height;
+  std::vector<Eigen::Triplet<double>> entries;
+  entries.reserve(4 * w * h);
+  for (h_size j = 0; j < h; ++j)
+    for (h_size i = 0; i < w; ++i) {
+      // each fine cell center lies a quarter of a coarse cell away from its
+      // parent center, towards the neighbour (ni, nj). Missing neighbours fold
+      // their weight into the parent (constant extrapolation).
+      const h_size pi = i / 2;
+      const h_size pj = j / 2;
+      const h_size ni = i % 2 ? pi + 1 : pi - 1;
+      const h_size nj = j % 2 ? pj + 1 : pj - 1;
+      const bool has_ni = i % 2 ? ni < cw : pi > 0;
+      const bool has_nj = j % 2 ? nj < ch : pj > 0;
+      const h_size c[4] = {pj * cw + pi, pj * cw + (has_ni ? ni : pi),
+                           (has_nj ? nj : pj) * cw + pi,
+                           (has_nj ? nj : pj) * cw + (has_ni ? ni : pi)};
+      constexpr double weights[4] = {9. / 16., 3. / 16., 3. / 16., 1. / 16.};
+      for (h_size k = 0; k < 4; ++k)
+        entries.emplace_back(j * w + i, c[k], weights[k]);
+    }
+  SparseMatrix P(w * h, cw * ch);
+  P.setFromTriplets(entries.begin(), entries.end());
+  return P;
+}
+
+void MultigridHierarchy::smooth(Level &level, h_size sweeps,
+                                bool reverse) const {
+  const h_size w = level.resolution.width;
+  const h_size n = level.resolution.total();
+  const auto &A = level.A;
+  auto &x = level.x;
+  auto relax = [&](h_size f) {
+    double sigma = level.b[f];
+    double diagonal = 0;
+    for (SparseMatrix::InnerIterator it(A, f); it; ++it)
+      if (static_cast<h_size>(it.col()) == f)
+        diagonal += it.value();
+      else
+        sigma -= it.value() * x[it.col()];
+    if (diagonal != 0)
+      x[f] = sigma / diagonal;
+  };
+  // red-black Gauss-Seidel. On the 5-point finest level cells of one color
+  // only depend on the other, wider coarse stencils also couple cells of the
+  // same color. The reverse sweep visits cells in the exact opposite order,
+  // which keeps pre and post smoothing adjoint.
+  for (h_size sweep = 0; sweep < sweeps; ++sweep)
+    for (h_size pass = 0; pass < 2; ++pass) {
+      const h_size color = reverse ? 1 - pass : pass;
+      for (h_size k = 0; k < n; ++k) {
+        const h_size f = reverse ? n - 1 - k : k;
+        if ((f % w + f / w) % 2 == color)
+          relax(f);
+      }
+    }
+}
+
+void MultigridHierarchy::computeResidual(Level &level) const {
+  using Vector = Eigen::Map<Eigen::VectorXd>;
+  const h_size n = level.resolution.total();
+  Vector r(level.r.data(), n);
+  r = Vector(level.b.data(), n) - level.A * Vector(level.x.data(), n);
+}
+
+void MultigridHierarchy::cycle(h_size level_index) {
+  auto &level = levels_[level_index];
+  if (level_index + 1 == levels_.size()) {
+    // coarsest level, symmetric sweeps keep the cycle symmetric
+    for (h_size s = 0; s < coarse_steps_; ++s)
+      smooth(level, 1, s % 2);
+    if (singular_)
+      removeMean(level.x);
+    return;
+  }
+
+  smooth(level, pre_steps_, false);
+  computeResidual(level);
+
+  using Vector = Eigen::Map<Eigen::VectorXd>;
+  auto &coarse = levels_[level_index + 1];
+  const h_size n = level.resolution.total();
+  const h_size cn = coarse.resolution.total();
+  // restriction (transpose of the prolongation)
+  Vector(coarse.b.data(), cn) =
+      level.P.transpose() * Vector(level.r.data(), n);
+  std::fill(coarse.x.begin(), coarse.x.end(), 0);
+
+  cycle(level_index + 1);
+
+  // prolongation (bilinear interpolation)
+  Vector e(level.e.data(), n);
+  e = level.P * Vector(coarse.x.data(), cn);
+  Vector(level.x.data(), n) += e;
+
+  smooth(level, post_steps_, true);
+}
+
+std::vector<double> &MultigridHierarchy::rhs() { return levels_[0].b; }
+
+std::vector<double> &MultigridHierarchy::solution() { return levels_[0].x; }
+
+void MultigridHierarchy::vcycle() {
+  if (!levels_.empty())
+    cycle(0);
+}
+
+double MultigridHierarchy::residualNorm() {
+  if (levels_.empty())
+    return 0;
+  computeResidual(levels_[0]);
+  const auto &r = levels_[0].r;
+  return std::sqrt(std::inner_product(r.begin(), r.end(), r.begin(), 0.0));
+}
+
+void MultigridHierarchy::removeMean(std::vector<double> &v) const {
+  if (v.empty())
+    return;
+  const double mean =
+      std::accumulate(v.begin(), v.end(), 0.0) / static_cast<double>(v.size());
+  for (auto &value : v)
+    value -= mean;
+}
+
+h_size MultigridHierarchy::levelCount() const { return levels_.size(); }
+
+bool MultigridHierarchy::isSingular() const { return singular_; }
+
+Multigrid &Multigrid::setGrid(const geo::Grid2 &grid) {
+  resolution_ = grid.resolution(core::Element::Type::CELL);
+  return *this;
+}
+
+Multigrid &Multigrid::setResolution(const hermes::size2 &resolution) {
+  resolution_ = resolution;
+  return *this;
+}
+
+MultigridHierarchy &Multigrid::hierarchy() { return hierarchy_; }
+
+void Multigrid::buildSystem() {
+  auto result = hierarchy_.build(resolution_, implicit_);
+  if (!result)
+    HERMES_ERROR("Failed to build multigrid hierarchy: {}",
+                 hermes::to_string(result));
+}
+
+SolveReport Multigrid::solveFor(core::FieldRef<real_t> &unknown_field,
+                                const Scalar &rhs) const {
+  SolveReport report;
+  if (!hierarchy_.levelCount())
+    return report;
+  auto &b = hierarchy_.rhs();
+  auto &x = hierarchy_.solution();
+  HERMES_ASSERT(b.size() == rhs.size());
+  for (h_index i = 0; i < b.size(); ++i)
+    b[i] = rhs[i];
+  if (options_.warm_start)
+    for (h_index i = 0; i < x.size(); ++i)
+      x[i] = unknown_field[i];
+  else
+    std::fill(x.begin(), x.end(), 0);
+  // pure Neumann systems are only solvable for zero-mean right-hand sides
+  if (hierarchy_.isSingular())
+    hierarchy_.removeMean(b);
+
+  const double b_norm =
+      std::sqrt(std::inner_product(b.begin(), b.end(), b.begin(), 0.0));
+  const double threshold = residualThreshold(b_norm);
+  const h_size max_iterations =
+      options_.max_iterations ? options_.max_iterations : 100;
+  double r_norm = options_.warm_start ? hierarchy_.residualNorm() : b_norm;
+  report.initial_residual = r_norm;
+  while (r_norm > threshold && report.iterations < max_iterations) {
+    hierarchy_.vcycle();
+    r_norm = hierarchy_.residualNorm();
+    report.residual_history.emplace_back(r_norm);
+    ++report.iterations;
+  }
+  report.converged = r_norm <= threshold;
+  report.residual = r_norm;
+  report.error = b_norm > 0 ? r_norm / b_norm : 0;
+
+  if (hierarchy_.isSingular())
+    hierarchy_.removeMean(x);
+  for (h_index i = 0; i < x.size(); ++i)
+    unknown_field[i] = x[i];
+  return report;
+}
+
+MultigridPreconditioner &
+MultigridPreconditioner::setGrid(const geo::Grid2 &grid) {
+  resolution_ = grid.resolution(core::Element::Type::CELL);
+  return *this;
+}
+
+MultigridPreconditioner &
+MultigridPreconditioner::setResolution(const hermes::size2 &resolution) {
+  resolution_ = resolution;
+  return *this;
+}
+
+MultigridHierarchy &MultigridPreconditioner::hierarchy() { return hierarchy_; }
+
+Eigen::VectorXd
+MultigridPreconditioner::solve(const Eigen::VectorXd &b) const {
+  if (info_ != Eigen::Success || !hierarchy_.levelCount())
+    return b;
+  auto &rhs = hierarchy_.rhs();
+  auto &x = hierarchy_.solution();
+  for (h_index i = 0; i < rhs.size(); ++i)
+    rhs[i] = b[i];
+  if (hierarchy_.isSingular())
+    hierarchy_.removeMean(rhs);
+  std::fill(x.begin(), x.end(), 0);
+  hierarchy_.vcycle();
+  if (hierarchy_.isSingular())
+    hierarchy_.removeMean(x);
+  return Eigen::Map<const Eigen::VectorXd>(x.data(), x.size());
+}
+
+Eigen::ComputationInfo MultigridPreconditioner::info() const { return info_; }
+
+} // namespace naiades::numeric::solvers
@@ -0,0 +1,393 @@
+/* Copyright (c) 2026, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/// \file   preconditioners.cpp
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-16
+
+#include <naiades/numeric/preconditioners.h>
+
+#include <naiades/base/parallel.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace naiades::numeric::solvers {
+
+namespace {
+
+/// Calls row(i) for every row in dependency order, either serially or level
+/// by level with the rows of each level in parallel.
+template <typename F>
+void sweep(const LevelSchedule &schedule, bool parallel, bool lower, h_size n,
+           F &&row) {
+  if (!parallel) {
+    if (lower)
+      for (h_index i = 0; i < n; ++i)
+        row(i);
+    else
+      for (h_index i = n; i-- > 0;)
+        row(i);
+    return;
+  }
+  for (h_index l = 0; l < schedule.levelCount(); ++l) {
+    const auto rows = schedule.level(l);
+    parallelFor(
+        0, rows.size(), [&](h_index k) { row(rows[k]); },
+        ThreadPool::chunkSize(rows.size(), 256));
+  }
+}
+
+/// \return Position of the diagonal entry of row i, or -1.
+int diagonalPosition(std::span<const int> offsets,
+                     std::span<const int> columns, h_index i) {
+  for (auto k = offsets[i]; k < offsets[i + 1]; ++k)
+    if (static_cast<h_index>(columns[k]) == i)
+      return k;
+  return -1;
+}
+
+} // namespace
+
+void LevelSchedule::build(std::span<const int> offsets,
+                          std::span<const int> columns, bool lower) {
+  const h_size n = offsets.empty() ? 0 : offsets.size() - 1;
+  std::vector<int> levels(n, 0);
+  int level_count = 0;
+  const auto visit = [&](h_index i) {
+    int level = 0;
+    for (auto k = offsets[i]; k < offsets[i + 1]; ++k) {
+      const auto j = static_cast<h_index>(columns[k]);
+      if (lower ? j < i : j > i)
+        level = std::max(level, levels[j] + 1);
+    }
+    levels[i] = level;
+    level_count = std::max(level_count, level + 1);
+  };
+  if (lower)
+    for (h_index i = 0; i < n; ++i)
+      visit(i);
+  else
+    for (h_index i = n; i-- > 0;)
+      visit(i);
+
+  // bucket rows by level, keeping them sorted within each level
+  level_offsets_.assign(level_count + 1, 0);
+  for (h_index i = 0; i < n; ++i)
+    ++level_offsets_[levels[i] + 1];
+  for (h_index l = 0; l < static_cast<h_size>(level_count); ++l)
+    level_offsets_[l + 1] += level_offsets_[l];
+  rows_.resize(n);
+  std::vector<int> cursor(level_offsets_.begin(), level_offsets_.end() - 1);
+  for (h_index i = 0; i < n; ++i)
+    rows_[cursor[levels[i]]++] = static_cast<int>(i);
+}
+
+h_size LevelSchedule::levelCount() const {
+  return level_offsets_.empty() ? 0 : level_offsets_.size() - 1;
+}
+
+std::span<const int> LevelSchedule::level(h_size index) const {
+  return {rows_.data() + level_offsets_[index],
+          static_cast<h_size>(level_offsets_[index + 1] -
+                              level_offsets_[index])};
+}
+
+void TriangularPart::extract(std::span<const int> offsets,
+                             std::span<const int> columns, bool lower) {
+  const h_size n = offsets.empty() ? 0 : offsets.size() - 1;
+  this->lower = lower;
+  this->offsets.assign(1, 0);
+  this->columns.clear();
+  sources.clear();
+  std::vector<std::pair<int, int>> row;
+  for (h_index i = 0; i < n; ++i) {
+    row.clear();
+    for (auto k = offsets[i]; k < offsets[i + 1]; ++k) {
+      const auto j = static_cast<h_index>(columns[k]);
+      if (lower ? j < i : j > i)
+        row.emplace_back(columns[k], k);
+    }
+    std::sort(row.begin(), row.end());
+    for (const auto &entry : row) {
+      this->columns.emplace_back(entry.first);
+      sources.emplace_back(entry.second);
+    }
+    this->offsets.emplace_back(static_cast<int>(this->columns.size()));
+  }
+  values.resize(this->columns.size());
+  schedule.build(this->offsets, this->columns, lower);
+}
+
+void TriangularPart::transpose(const TriangularPart &part) {
+  const h_size n = part.offsets.size() - 1;
+  offsets.assign(n + 1, 0);
+  for (auto j : part.columns)
+    ++offsets[j + 1];
+  for (h_index i = 0; i < n; ++i)
+    offsets[i + 1] += offsets[i];
+  columns.resize(part.columns.size());
+  sources.resize(part.columns.size());
+  // rows of part are visited in order, so transposed rows come out sorted
+  std::vector<int> cursor(offsets.begin(), offsets.end() - 1);
+  for (h_index i = 0; i < n; ++i)
+    for (auto k = part.offsets[i]; k < part.offsets[i + 1]; ++k) {
+      const auto position = cursor[part.columns[k]]++;
+      columns[position] = static_cast<int>(i);
+      sources[position] = k;
+    }
+  values.resize(columns.size());
+  lower = !part.lower;
+  schedule.build(offsets, columns, lower);
+}
+
+void TriangularPart::gather(std::span<const double> source) {
+  for (h_index k = 0; k < values.size(); ++k)
+    values[k] = source[sources[k]];
+}
+
+// IC0Preconditioner
+
+IC0Preconditioner &IC0Preconditioner::setParallel(bool parallel) {
+  parallel_ = parallel;
+  return *this;
+}
+
+NaResult IC0Preconditioner::analyzeCsr(std::span<const int> offsets,
+                                       std::span<const int> columns) {
+  if (offsets.empty())
+    return NaResult::inputError();
+  const h_size n = offsets.size() - 1;
+  lower_.extract(offsets, columns, true);
+  upper_.transpose(lower_);
+  diagonal_sources_.resize(n);
+  for (h_index i = 0; i < n; ++i)
+    diagonal_sources_[i] = diagonalPosition(offsets, columns, i);
+  diagonal_.resize(n);
+  inverse_diagonal_.resize(n);
+  return NaResult::noError();
+}
+
+NaResult IC0Preconditioner::factorizeCsr(std::span<const int> offsets,
+                                         std::span<const int> columns,
+                                         std::span<const double> values) {
+  if (offsets.size() != diagonal_.size() + 1)
+    return NaResult::inputError();
+  HERMES_UNUSED_VARIABLE(columns);
+  const h_size n = diagonal_.size();
+  const auto &l_offsets = lower_.offsets;
+  const auto &l_columns = lower_.columns;
+  auto &l_values = lower_.values;
+  lower_.gather(values);
+
+  for (h_index i = 0; i < n; ++i) {
+    const auto begin = l_offsets[i];
+    const auto end = l_offsets[i + 1];
+    for (auto k = begin; k < end; ++k) {
+      // L(i, j) = (A(i, j) - L(i, :j) . L(j, :j)) / L(j, j) on the pattern
+      const auto j = l_columns[k];
+      double sum = 0;
+      for (auto a = begin, b = l_offsets[j]; a < k && b < l_offsets[j + 1];) {
+        if (l_columns[a] == l_columns[b])
+          sum += l_values[a++] * l_values[b++];
+        else if (l_columns[a] < l_columns[b])
+          ++a;
+        else
+          ++b;
+      }
+      l_values[k] = (l_values[k] - sum) * inverse_diagonal_[j];
+    }
+    const double a_ii =
+        diagonal_sources_[i] < 0 ? 0 : values[diagonal_sources_[i]];
+    double pivot = a_ii;
+    for (auto k = begin; k < end; ++k)
+      pivot -= l_values[k] * l_values[k];
+    if (pivot <= std::numeric_limits<double>::epsilon() * std::abs(a_ii))
+      pivot = a_ii > 0 ? a_ii : 1;
+    diagonal_[i] = std::sqrt(pivot);
+    inverse_diagonal_[i] = 1 / diagonal_[i];
+  }
+
+  upper_.gather(l_values);
+  return NaResult::noError();
+}
+
+void IC0Preconditioner::apply(const Eigen::VectorXd &b,
+                              Eigen::VectorXd &x) const {
+  const h_size n = diagonal_.size();
+  // L y = b
+  sweep(lower_.schedule, parallel_, true, n, [&](h_index i) {
+    double value = b[i];
+    for (auto k = lower_.offsets[i]; k < lower_.offsets[i + 1]; ++k)
+      value -= lower_.values[k] * x[lower_.columns[k]];
+    x[i] = value * inverse_diagonal_[i];
+  });
+  // L^T x = y
+  sweep(upper_.schedule, parallel_, false, n, [&](h_index i) {
+    double value = x[i];
+    for (auto k = upper_.offsets[i]; k < upper_.offsets[i + 1]; ++k)
+      value -= upper_.values[k] * x[upper_.columns[k]];
+    x[i] = value * inverse_diagonal_[i];
+  });
+}
+
+// SSORPreconditioner
+
+SSORPreconditioner &SSORPreconditioner::setRelaxation(real_t omega) {
+  omega_ = std::clamp<double>(omega, 1e-3, 2 - 1e-3);
+  return *this;
+}
+
+SSORPreconditioner &SSORPreconditioner::setParallel(bool parallel) {
+  parallel_ = parallel;
+  return *this;
+}
+
+NaResult SSORPreconditioner::analyzeCsr(std::span<const int> offsets,
+                                        std::span<const int> columns) {
+  if (offsets.empty())
+    return NaResult::inputError();
+  const h_size n = offsets.size() - 1;
+  lower_.extract(offsets, columns, true);
+  upper_.extract(offsets, columns, false);
+  diagonal_sources_.resize(n);
+  for (h_index i = 0; i < n; ++i)
+    diagonal_sources_[i] = diagonalPosition(offsets, columns, i);
+  inverse_diagonal_.resize(n);
+  scaled_diagonal_.resize(n);
+  return NaResult::noError();
+}
+
+NaResult SSORPreconditioner::factorizeCsr(std::span<const int> offsets,
+                                          std::span<const int> columns,
+                                          std::span<const double> values) {
+  if (offsets.size() != inverse_diagonal_.size() + 1)
+    return NaResult::inputError();
+  HERMES_UNUSED_VARIABLE(columns);
+  lower_.gather(values);
+  upper_.gather(values);
+  const double scale = (2 - omega_) / (omega_ * omega_);
+  for (h_index i = 0; i < inverse_diagonal_.size(); ++i) {
+    const int k = diagonal_sources_[i];
+    const double d = k < 0 || values[k] == 0 ? 1 : values[k];
+    inverse_diagonal_[i] = omega_ / d;
+    scaled_diagonal_[i] = scale * d;
+  }
+  return NaResult::noError();
+}
+
+void SSORPreconditioner::apply(const Eigen::VectorXd &b,
+                               Eigen::VectorXd &x) const {
+  const h_size n = inverse_diagonal_.size();
+  // (D / w + L) y = b
+  sweep(lower_.schedule, parallel_, true, n, [&](h_index i) {
+    double value = b[i];
+    for (auto k = lower_.offsets[i]; k < lower_.offsets[i + 1]; ++k)
+      value -= lower_.values[k] * x[lower_.columns[k]];
+    x[i] = value * inverse_diagonal_[i];
+  });
+  // (D / w + U) x = (2 - w) / w D / w y
+  sweep(upper_.schedule, parallel_, false, n, [&](h_index i) {
+    double value = x[i] * scaled_diagonal_[i];
+    for (auto k = upper_.offsets[i]; k < upper_.offsets[i + 1]; ++k)
+      value -= upper_.values[k] * x[upper_.columns[k]];
+    x[i] = value * inverse_diagonal_[i];
+  });
+}
+
+// BlockJacobiPreconditioner
+
+BlockJacobiPreconditioner &
+BlockJacobiPreconditioner::setBlockSize(h_size block_size) {
+  block_size_ = std::max<h_size>(block_size, 1);
+  return *this;
+}
+
+NaResult BlockJacobiPreconditioner::analyzeCsr(std::span<const int> offsets,
+                                               std::span<const int> columns) {
+  if (offsets.empty())
+    return NaResult::inputError();
+  size_ = offsets.size() - 1;
+  const h_size block_count = (size_ + block_size_ - 1) / block_size_;
+  block_matrices_.resize(block_count);
+  block_sources_.resize(block_count);
+  blocks_ = std::vector<BlockSolver>(block_count);
+  parallelFor(0, block_count, [&](h_index block) {
+    const h_size first = block * block_size_;
+    const h_size size = std::min(block_size_, size_ - first);
+    auto &M = block_matrices_[block];
+    auto &sources = block_sources_[block];
+    sources.clear();
+    M.resize(size, size);
+    M.resizeNonZeros(0);
+    auto *block_offsets = M.outerIndexPtr();
+    block_offsets[0] = 0;
+    for (h_index r = 0; r < size; ++r) {
+      for (auto k = offsets[first + r]; k < offsets[first + r + 1]; ++k) {
+        const auto c = static_cast<h_index>(columns[k]);
+        if (c >= first && c < first + size)
+          sources.emplace_back(k);
+      }
+      block_offsets[r + 1] = static_cast<int>(sources.size());
+    }
+    M.resizeNonZeros(sources.size());
+    for (h_index e = 0; e < sources.size(); ++e) {
+      M.innerIndexPtr()[e] = columns[sources[e]] - static_cast<int>(first);
+      M.valuePtr()[e] = 0;
+    }
+    blocks_[block].analyzePattern(M);
+  });
+  return NaResult::noError();
+}
+
+NaResult
+BlockJacobiPreconditioner::factorizeCsr(std::span<const int> offsets,
+                                        std::span<const int> columns,
+                                        std::span<const double> values) {
+  if (offsets.size() != size_ + 1)
+    return NaResult::inputError();
+  HERMES_UNUSED_VARIABLE(columns);
+  std::vector<u8> failed(blocks_.size(), 0);
+  parallelFor(0, blocks_.size(), [&](h_index block) {
+    auto &M = block_matrices_[block];
+    const auto &sources = block_sources_[block];
+    for (h_index e = 0; e < sources.size(); ++e)
+      M.valuePtr()[e] = values[sources[e]];
+    blocks_[block].factorize(M);
+    failed[block] = blocks_[block].info() != Eigen::Success;
+  });
+  if (std::find(failed.begin(), failed.end(), 1) != failed.end())
+    return NaResult::checkError();
+  return NaResult::noError();
+}
+
+void BlockJacobiPreconditioner::apply(const Eigen::VectorXd &b,
+                                      Eigen::VectorXd &x) const {
+  parallelFor(0, blocks_.size(), [&](h_index block) {
+    const h_size first = block * block_size_;
+    const h_size size = std::min(block_size_, size_ - first);
+    x.segment(first, size) = blocks_[block].solve(b.segment(first, size));
+  });
+}
+
+} // namespace naiades::numeric::solvers
@@ -0,0 +1,270 @@
+/* Copyright (c) 2026, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/// \file   preconditioners.h
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-16
+/// \brief  Algebraic preconditioners for PCG.
+
+#pragma once
+
+#include <naiades/numeric/linear_solvers.h>
+
+#include <span>
+#include <string_view>
+
+namespace naiades::numeric::solvers {
+
+/// \brief Rows of a triangular sweep grouped in levels, such that rows of a
+///        level only depend on rows of previous levels and can be processed
+///        concurrently.
+class LevelSchedule {
+public:
+  /// \param offsets CSR row offsets.
+  /// \param columns CSR columns.
+  /// \param lower If true, row i depends on columns j < i (forward sweep),
+  ///              otherwise on columns j > i (backward sweep).
+  void build(std::span<const int> offsets, std::span<const int> columns,
+             bool lower);
+  h_size levelCount() const;
+  /// \return Rows of the given level.
+  std::span<const int> level(h_size index) const;
+
+private:
+  std::vector<int> level_offsets_;
+  std::vector<int> rows_;
+};
+
+/// \brief Strictly lower or upper part of a compressed row matrix, with
+///        sorted rows, the position of each entry in its source arrays and
+///        the level schedule of the triangular sweep.
+struct TriangularPart {
+  /// Extracts the strictly lower (or upper) part of a matrix.
+  void extract(std::span<const int> offsets, std::span<const int> columns,
+               bool lower);
+  /// Builds the transpose of another part. Sources index the entries of
+  /// part.
+  void transpose(const TriangularPart &part);
+  /// Copies values from the source arrays.
+  void gather(std::span<const double> source);
+
+  std::vector<int> offsets;
+  std::vector<int> columns;
+  std::vector<int> sources;
+  std::vector<double> values;
+  LevelSchedule schedule;
+  bool lower{true};
+};
+
+/// \brief Adapts a preconditioner working on compressed row storage to the
+///        interface expected by Eigen iterative solvers.
+/// \tparam Derived Implements analyzeCsr(offsets, columns) and
+///                 factorizeCsr(offsets, columns, values), both returning
+///                 NaResult, and apply(b, x).
+template <typename Derived> class SparsePreconditioner {
+public:
+  template <typename MatType> Derived &analyzePattern(const MatType &A) {
+    return forward(A, [&](auto offsets, auto columns, auto) {
+      analyzed_ = static_cast<bool>(derived().analyzeCsr(offsets, columns));
+      info_ = analyzed_ ? Eigen::Success : Eigen::InvalidInput;
+    });
+  }
+  template <typename MatType> Derived &factorize(const MatType &A) {
+    return forward(A, [&](auto offsets, auto columns, auto values) {
+      if (!analyzed_) {
+        info_ = Eigen::InvalidInput;
+        return;
+      }
+      info_ = derived().factorizeCsr(offsets, columns, values)
+                  ? Eigen::Success
+                  : Eigen::NumericalIssue;
+    });
+  }
+  template <typename MatType> Derived &compute(const MatType &A) {
+    analyzePattern(A);
+    return factorize(A);
+  }
+  /// \return M^-1 b, or b itself if the preconditioner is not ready.
+  Eigen::VectorXd solve(const Eigen::VectorXd &b) const {
+    if (info_ != Eigen::Success)
+      return b;
+    Eigen::VectorXd x(b.size());
+    derived().apply(b, x);
+    return x;
+  }
+  Eigen::ComputationInfo info() const { return info_; }
+
+private:
+  Derived &derived() { return *static_cast<Derived *>(this); }
+  const Derived &derived() const { return *static_cast<const Derived *>(this); }
+  /// Calls f(offsets, columns, values) with the compressed arrays of A.
+  /// \note Column-major storage is read as its transpose, which is the same
+  ///       matrix for symmetric systems.
+  template <typename MatType, typename F>
+  Derived &forward(const MatType &A, const F &f) {
+    if (!A.isCompressed()) {
+      SparseMatrix copy = A;
+      copy.makeCompressed();
+      return forward(copy, f);
+    }
+    const auto n = static_cast<h_size>(A.outerSize());
+    const auto nnz = static_cast<h_size>(A.nonZeros());
+    f(std::span<const int>(A.outerIndexPtr(), n + 1),
+      std::span<const int>(A.innerIndexPtr(), nnz),
+      std::span<const double>(A.valuePtr(), nnz));
+    return derived();
+  }
+
+  Eigen::ComputationInfo info_{Eigen::InvalidInput};
+  bool analyzed_{false};
+};
+
+/// \brief Zero fill-in incomplete Cholesky factorization, M = L L^T with L
+///        restricted to the lower pattern of A.
+///
+/// The symbolic part (pattern of L, its transpose and the sweep schedules)
+/// is computed by analyzePattern and kept while the matrix pattern does not
+/// change, so PCG rebuilds only refactor numerically.
+///
+/// \note Non-positive pivots (e.g. the last row of a pure Neumann system)
+///       are replaced by the diagonal of A.
+///
+/// Example:
+///   solvers::PCG<solvers::IC0Preconditioner> cg;
+///   cg.preconditioner().setParallel(true);
+///   cg.build(fd.L(p), 0);
+class IC0Preconditioner : public SparsePreconditioner<IC0Preconditioner> {
+public:
+  static constexpr std::string_view name = "ic0";
+
+  IC0Preconditioner() = default;
+  template <typename MatType> explicit IC0Preconditioner(const MatType &A) {
+    compute(A);
+  }
+
+  /// Enables level-scheduled parallel triangular solves.
+  IC0Preconditioner &setParallel(bool parallel);
+
+private:
+  friend class SparsePreconditioner<IC0Preconditioner>;
+
+  NaResult analyzeCsr(std::span<const int> offsets,
+                      std::span<const int> columns);
+  NaResult factorizeCsr(std::span<const int> offsets,
+                        std::span<const int> columns,
+                        std::span<const double> values);
+  void apply(const Eigen::VectorXd &b, Eigen::VectorXd &x) const;
+
+  // strictly lower part of L, its transpose and the diagonal of L
+  TriangularPart lower_, upper_;
+  std::vector<double> diagonal_, inverse_diagonal_;
+  // position of the diagonal entries in A (-1 if missing)
+  std::vector<int> diagonal_sources_;
+  bool parallel_{false};
+};
+
+/// \brief Symmetric successive over-relaxation preconditioner,
+///        M = w / (2 - w) (D / w + L) (D / w)^-1 (D / w + L^T).
+///
+/// With w = 1 this is a symmetric Gauss-Seidel sweep. No factorization is
+/// needed, only a copy of the matrix.
+class SSORPreconditioner : public SparsePreconditioner<SSORPreconditioner> {
+public:
+  static constexpr std::string_view name = "ssor";
+
+  SSORPreconditioner() = default;
+  template <typename MatType> explicit SSORPreconditioner(const MatType &A) {
+    compute(A);
+  }
+
+  /// \param omega Relaxation factor in (0, 2).
+  SSORPreconditioner &setRelaxation(real_t omega);
+  /// Enables level-scheduled parallel sweeps.
+  SSORPreconditioner &setParallel(bool parallel);
+
+private:
+  friend class SparsePreconditioner<SSORPreconditioner>;
+
+  NaResult analyzeCsr(std::span<const int> offsets,
+                      std::span<const int> columns);
+  NaResult factorizeCsr(std::span<const int> offsets,
+                        std::span<const int> columns,
+                        std::span<const double> values);
+  void apply(const Eigen::VectorXd &b, Eigen::VectorXd &x) const;
+
+  TriangularPart lower_, upper_;
+  // w / D and (2 - w) / w^2 D
+  std::vector<double> inverse_diagonal_, scaled_diagonal_;
+  std::vector<int> diagonal_sources_;
+  double omega_{1};
+  bool parallel_{false};
+};
+
+/// \brief Block Jacobi preconditioner over contiguous row blocks, each one
+///        factorized by a sparse LDL^T.
+///
+/// For grid systems with rows ordered as j * width + i, a block size equal
+/// to the grid width solves each grid line exactly (line relaxation), which
+/// handles strong coupling along x.
+class BlockJacobiPreconditioner
+    : public SparsePreconditioner<BlockJacobiPreconditioner> {
+public:
+  static constexpr std::string_view name = "block-jacobi";
+
+  BlockJacobiPreconditioner() = default;
+  template <typename MatType>
+  explicit BlockJacobiPreconditioner(const MatType &A) {
+    compute(A);
+  }
+
+  /// \param block_size Number of consecutive rows per block.
+  BlockJacobiPreconditioner &setBlockSize(h_size block_size);
+
+private:
+  friend class SparsePreconditioner<BlockJacobiPreconditioner>;
+
+  NaResult analyzeCsr(std::span<const int> offsets,
+                      std::span<const int> columns);
+  NaResult factorizeCsr(std::span<const int> offsets,
+                        std::span<const int> columns,
+                        std::span<const double> values);
+  void apply(const Eigen::VectorXd &b, Eigen::VectorXd &x) const;
+
+  using BlockSolver = Eigen::SimplicialLDLT<SparseMatrix, Eigen::Lower,
+                                            Eigen::AMDOrdering<int>>;
+
+  h_size block_size_{32};
+  h_size size_{0};
+  // diagonal blocks and the position of their entries in A
+  std::vector<SparseMatrix> block_matrices_;
+  std::vector<std::vector<int>> block_sources_;
+  std::vector<BlockSolver> blocks_;
+};
+
+/// Conjugate gradient with incomplete Cholesky preconditioning.
+using ICCG = PCG<IC0Preconditioner>;
+/// Conjugate gradient with SSOR preconditioning.
+using SSORCG = PCG<SSORPreconditioner>;
+/// Conjugate gradient with block Jacobi preconditioning.
+using BlockJacobiCG = PCG<BlockJacobiPreconditioner>;
+
+} // namespace naiades::numeric::solvers
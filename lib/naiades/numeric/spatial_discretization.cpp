@@ -83,32 +83,30 @@ SpatialDiscretization::boundaries() const {
 
 DiscreteExpression
 SpatialDiscretization::dx(const core::DiscreteSymbol &ds) const {
-  DiscreteExpression de(ds);
-  auto n = topology_->elementCount(ds.symbol.loc);
-  for (h_index i = 0; i < n; ++i) {
-    de.addIndexEntry(i, derivative(derivative_bits::x, i, ds));
-  }
-  return de;
+  return derivativeExpression(derivative_bits::x, ds);
 }
 
 DiscreteExpression
 SpatialDiscretization::dy(const core::DiscreteSymbol &ds) const {
-  DiscreteExpression de(ds);
-  auto n = topology_->elementCount(ds.symbol.loc);
-  for (h_index i = 0; i < n; ++i) {
-    de.addIndexEntry(i, derivative(derivative_bits::y, i, ds));
-  }
-  return de;
+  return derivativeExpression(derivative_bits::y, ds);
 }
 
 DiscreteExpression
 SpatialDiscretization::L(const core::DiscreteSymbol &ds) const {
-  DiscreteExpression de(ds);
-  auto n = topology_->elementCount(ds.symbol.loc);
-  for (h_index i = 0; i < n; ++i) {
-    de.addIndexEntry(i, laplacian(i, ds));
-  }
-  return de;
+  return laplacianExpression(ds);
+}
+
+DiscreteExpression SpatialDiscretization::derivativeExpression(
+    derivative_bits d, const core::DiscreteSymbol &ds) const {
+  return assembleRows(ds, [&](h_index i, DiscreteOperator &op) {
+    op = derivative(d, i, ds);
+  });
+}
+
+DiscreteExpression SpatialDiscretization::laplacianExpression(
+    const core::DiscreteSymbol &ds) const {
+  return assembleRows(
+      ds, [&](h_index i, DiscreteOperator &op) { op = laplacian(i, ds); });
 }
 
 } // namespace naiades::numeric
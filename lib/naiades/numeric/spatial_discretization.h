@@ -27,6 +27,7 @@
 
 #pragma once
 
+#include <naiades/base/parallel.h>
 #include <naiades/core/symbol.h>
 #include <naiades/numeric/boundary.h>
 #include <naiades/numeric/discrete_expression.h>
@@ -34,6 +35,8 @@
 #include <hermes/core/ref.h>
 #include <hermes/geometry/point.h>
 
+#include <algorithm>
+
 namespace naiades::numeric {
 
 enum class derivative_bits : u32 {
@@ -202,6 +205,30 @@ protected:
   virtual DiscreteOperator divergence(const core::Element &loc, h_size index,
                                       const core::Element &vector_loc,
                                       bool staggered) const = 0;
+  /// Compute the derivative operator at every element of the symbol.
+  /// \note The default calls derivative() for each element. Discretizations
+  ///       can override it to look up the mesh and the boundary once and
+  ///       build rows without virtual calls (see assembleRows).
+  /// \param d Derivative direction.
+  /// \param sym
+  virtual DiscreteExpression
+  derivativeExpression(derivative_bits d,
+                       const core::DiscreteSymbol &sym) const;
+  /// Compute the discrete Laplacian operator at every element of the symbol.
+  /// \note The default calls laplacian() for each element.
+  /// \param sym
+  virtual DiscreteExpression
+  laplacianExpression(const core::DiscreteSymbol &sym) const;
+  /// Builds an expression row by row in a single parallel pass. Every chunk
+  /// of elements writes its rows into chunk-local CSR buffers, which are then
+  /// concatenated at the prefix-summed row offsets.
+  /// \param sym
+  /// \param row Called as row(index, op), must add the operator centered at
+  ///            the element index to op. It is called once per element,
+  ///            concurrently, and op is reused by consecutive elements.
+  template <typename F>
+  DiscreteExpression assembleRows(const core::DiscreteSymbol &sym,
+                                  const F &row) const;
 
 protected:
   std::unordered_map<core::Symbol, Boundary> boundaries_;
@@ -209,4 +236,61 @@ protected:
   core::Topology::Ptr topology_;
 };
 
+template <typename F>
+DiscreteExpression
+SpatialDiscretization::assembleRows(const core::DiscreteSymbol &sym,
+                                    const F &row) const {
+  const h_size n = topology_->elementCount(sym.symbol.loc);
+  const h_size chunk = ThreadPool::chunkSize(n, 256);
+  const h_size chunk_count = (n + chunk - 1) / chunk;
+
+  // every chunk builds its rows in a single scratch operator and appends them
+  // to its own buffers
+  struct ChunkRows {
+    std::vector<h_size> columns;
+    std::vector<real_t> weights;
+  };
+  std::vector<ChunkRows> chunk_rows(chunk_count);
+  std::vector<h_size> row_offsets(n + 1, 0);
+  std::vector<real_t> constants(n);
+  parallelFor(
+      0, chunk_count,
+      [&](h_index c) {
+        auto &buffers = chunk_rows[c];
+        DiscreteOperator op;
+        const h_size last = std::min(n, (c + 1) * chunk);
+        for (h_index i = c * chunk; i < last; ++i) {
+          op.clear(i);
+          row(i, op);
+          for (const auto &node : op.nodes()) {
+            buffers.columns.emplace_back(node.first);
+            buffers.weights.emplace_back(node.second);
+          }
+          row_offsets[i + 1] = op.size();
+          constants[i] = op.constant();
+        }
+      },
+      1);
+  for (h_index i = 0; i < n; ++i)
+    row_offsets[i + 1] += row_offsets[i];
+
+  std::vector<h_size> columns(row_offsets[n]);
+  std::vector<real_t> weights(row_offsets[n]);
+  parallelFor(
+      0, chunk_count,
+      [&](h_index c) {
+        const h_size offset = row_offsets[c * chunk];
+        std::copy(chunk_rows[c].columns.begin(), chunk_rows[c].columns.end(),
+                  columns.begin() + offset);
+        std::copy(chunk_rows[c].weights.begin(), chunk_rows[c].weights.end(),
+                  weights.begin() + offset);
+      },
+      1);
+
+  DiscreteExpression de(sym);
+  de.setRows(std::move(row_offsets), std::move(columns), std::move(weights),
+             std::move(constants));
+  return de;
+}
+
 } // namespace naiades::numeric
@@ -0,0 +1,155 @@
+/* Copyright (c) 2026, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/// \file   grid_sampler.h
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-16
+/// \brief  Allocation-free interpolation of grid fields.
+
+#pragma once
+
+#include <naiades/core/field.h>
+#include <naiades/geo/grid.h>
+
+#include <algorithm>
+#include <cmath>
+#include <span>
+#include <type_traits>
+
+namespace naiades::sampling {
+
+/// \brief Values of a field stored over one Grid2 element type.
+///
+/// The grid geometry is resolved at construction so lookups only do index
+/// arithmetic. Indices outside of the grid are clamped to the closest element.
+///
+/// \tparam T Field value type.
+/// \tparam Field Random access storage of the values (ex: core::FieldCRef<T>
+///         or std::span<const T>), indexed by local flat indices of the
+///         storage layout.
+template <typename T, typename Field = core::FieldCRef<T>> class GridFieldView {
+public:
+  /// \param grid
+  /// \param loc Element type of the field values.
+  /// \param field Values indexed by local (row-major) flat element indices.
+  GridFieldView(const geo::Grid2 &grid, core::Element loc, const Field &field)
+      : GridFieldView(grid, loc, field, grid.layout(loc)) {}
+  /// \param grid
+  /// \param loc Element type of the field values.
+  /// \param field Values stored in the given layout.
+  /// \param layout Storage layout of the loc elements.
+  GridFieldView(const geo::Grid2 &grid, core::Element loc, const Field &field,
+                const geo::GridLayout &layout)
+      : field_{field}, layout_{layout}, origin_{grid.origin(loc)},
+        cell_size_{grid.cellSize()} {
+    auto res = grid.resolution(loc);
+    width_ = static_cast<i32>(res.width);
+    height_ = static_cast<i32>(res.height);
+    inv_cell_size_ = {1.f / cell_size_.x, 1.f / cell_size_.y};
+  }
+
+  i32 width() const { return width_; }
+  i32 height() const { return height_; }
+  const geo::GridLayout &layout() const { return layout_; }
+  /// \return Value at the element (i, j), clamped to the grid.
+  const T &at(i32 i, i32 j) const {
+    i = std::clamp(i, 0, width_ - 1);
+    j = std::clamp(j, 0, height_ - 1);
+    return field_[layout_.flatIndex(i, j)];
+  }
+  /// \return Position in index space of a world position.
+  hermes::geo::point2 gridPosition(const hermes::geo::point2 &wp) const {
+    return {(wp.x - origin_.x) * inv_cell_size_.x,
+            (wp.y - origin_.y) * inv_cell_size_.y};
+  }
+  /// \return World position of the element (i, j).
+  hermes::geo::point2 worldPosition(i32 i, i32 j) const {
+    return {origin_.x + i * cell_size_.x, origin_.y + j * cell_size_.y};
+  }
+
+private:
+  Field field_;
+  geo::GridLayout layout_;
+  hermes::geo::point2 origin_;
+  hermes::geo::vec2 cell_size_;
+  hermes::geo::vec2 inv_cell_size_;
+  i32 width_{0};
+  i32 height_{0};
+};
+
+/// Bilinear interpolation.
+struct LinearSampler {
+  template <typename T, typename F>
+  static T sample(const GridFieldView<T, F> &view,
+                  const hermes::geo::point2 &wp) {
+    auto gp = view.gridPosition(wp);
+    const f32 fx = std::floor(gp.x);
+    const f32 fy = std::floor(gp.y);
+    const i32 i = static_cast<i32>(fx);
+    const i32 j = static_cast<i32>(fy);
+    const f32 x = gp.x - fx;
+    const f32 y = gp.y - fy;
+    return (view.at(i, j) * (1.f - x) + view.at(i + 1, j) * x) * (1.f - y) +
+           (view.at(i, j + 1) * (1.f - x) + view.at(i + 1, j + 1) * x) * y;
+  }
+};
+
+/// Bicubic (Catmull-Rom) interpolation.
+/// \note Scalar values are clamped to the range of the four closest values,
+///       which prevents the overshoots of the cubic around discontinuities.
+struct CubicSampler {
+  template <typename T, typename F>
+  static T sample(const GridFieldView<T, F> &view,
+                  const hermes::geo::point2 &wp) {
+    auto gp = view.gridPosition(wp);
+    const f32 fx = std::floor(gp.x);
+    const f32 fy = std::floor(gp.y);
+    const i32 i = static_cast<i32>(fx);
+    const i32 j = static_cast<i32>(fy);
+    const f32 x = gp.x - fx;
+    const f32 y = gp.y - fy;
+    T rows[4];
+    for (i32 r = 0; r < 4; ++r)
+      rows[r] = cubic(view.at(i - 1, j + r - 1), view.at(i, j + r - 1),
+                      view.at(i + 1, j + r - 1), view.at(i + 2, j + r - 1), x);
+    T value = cubic(rows[0], rows[1], rows[2], rows[3], y);
+    if constexpr (std::is_arithmetic_v<T>) {
+      auto range = std::minmax({view.at(i, j), view.at(i + 1, j),
+                                view.at(i, j + 1), view.at(i + 1, j + 1)});
+      value = std::clamp(value, range.first, range.second);
+    }
+    return value;
+  }
+
+private:
+  template <typename T>
+  static T cubic(const T &p0, const T &p1, const T &p2, const T &p3, f32 t) {
+    return p1 + (p2 - p0 +
+                 (p0 * 2.f - p1 * 5.f + p2 * 4.f - p3 +
+                  ((p1 - p2) * 3.f + p3 - p0) * t) *
+                     t) *
+                    (0.5f * t);
+  }
+};
+
+} // namespace naiades::sampling
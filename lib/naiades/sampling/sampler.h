@@ -27,108 +27,129 @@
 
 #pragma once
 
+#include <naiades/base/parallel.h>
 #include <naiades/sampling/stencil.h>
 
 #include <hermes/math/space_filling.h>
 
 namespace naiades::sampling {
 
+/// Interpolates a component of a field into the elements of sample_field.
+/// \param field_layout Storage layout of the field elements.
+/// \param sample_layout Storage layout of the sample_field elements.
 template <typename T>
 void sample(const geo::Grid2 &grid, const core::FieldCRef<T> &field,
-            h_size component, core::FieldRef<f32> &sample_field) {
+            h_size component, core::FieldRef<f32> &sample_field,
+            const geo::GridLayout &field_layout,
+            const geo::GridLayout &sample_layout) {
   auto field_element = field.element();
   auto sample_element = sample_field.element();
-  auto sample_resolution = grid.resolution(sample_element);
+  HERMES_ASSERT(field_layout.resolution() == grid.resolution(field_element));
+  HERMES_ASSERT(sample_layout.resolution() ==
+                grid.resolution(sample_element));
+  // destinations are visited in storage order
+  auto forEachSample = [&](const auto &f) {
+    sample_layout.forEach(
+        [&](h_index, i32 i, i32 j) { f(hermes::index2(i, j)); });
+  };
 
 #define SRC(IJ)                                                                \
-  field[grid.safeFlatIndex(field_element, IJ) -                                \
-        grid.elementIndexOffset(field_element)][component]
+  field[field_layout.flatIndex(grid.safeIndex(field_element, IJ))][component]
 
-#define DST(IJ)                                                                \
-  sample_field[grid.flatIndex(sample_element, IJ) -                            \
-               grid.elementIndexOffset(sample_element)]
+#define DST(IJ) sample_field[sample_layout.flatIndex(IJ)]
 
   if (field.element() == sample_element) {
     // copy
-    for (h_size i = 0; i < field.size(); ++i)
-      sample_field[i] = field[i][component];
+    forEachSample([&](auto ij) { DST(ij) = SRC(ij); });
   } else if (field.element().is(core::element_primitive_bits::face)) {
     if (field.element().alignments().contain(core::element_alignment_bits::x)) {
       // x face is source
       if (sample_element.is(core::element_primitive_bits::cell)) {
         // cell is destination
-        for (auto ij : hermes::range2(sample_resolution))
+        forEachSample([&](auto ij) {
           DST(ij) = (SRC(ij.plus(0, 0)) + SRC(ij.plus(0, 1))) * 0.5;
+        });
       } else if (sample_element.is(core::element_primitive_bits::vertex)) {
         // vertex is destination
-        for (auto ij : hermes::range2(sample_resolution))
+        forEachSample([&](auto ij) {
           DST(ij) = (SRC(ij.plus(-1, 0)) + SRC(ij.plus(0, 0))) * 0.5;
+        });
       } else {
         // y face is destination
-        for (auto ij : hermes::range2(sample_resolution))
+        forEachSample([&](auto ij) {
           DST(ij) = (SRC(ij.plus(-1, 0)) + SRC(ij.plus(0, 0)) +
                      SRC(ij.plus(0, 1)) + SRC(ij.plus(-1, 1))) *
                     0.25;
+        });
       }
     } else if (field.element().alignments().contain(
                    core::element_alignment_bits::y)) {
       // y face is source
       if (sample_element.is(core::element_primitive_bits::cell)) {
         // cell is destination
-        for (auto ij : hermes::range2(sample_resolution))
+        forEachSample([&](auto ij) {
           DST(ij) = (SRC(ij.plus(0, 0)) + SRC(ij.plus(1, 0))) * 0.5;
+        });
       } else if (sample_element.is(core::element_primitive_bits::vertex)) {
         // vertex is destination
-        for (auto ij : hermes::range2(sample_resolution))
+        forEachSample([&](auto ij) {
           DST(ij) = (SRC(ij.plus(0, -1)) + SRC(ij.plus(0, 0))) * 0.5;
+        });
       } else {
         // x face is destination
-        for (auto ij : hermes::range2(sample_resolution))
+        forEachSample([&](auto ij) {
           DST(ij) = (SRC(ij.plus(0, -1)) + SRC(ij.plus(1, -1)) +
                      SRC(ij.plus(1, 0)) + SRC(ij.plus(0, 0))) *
                     0.25;
+        });
       }
     }
   } else if (field.element().is(core::element_primitive_bits::cell)) {
     // cell is source
     if (sample_element.is(core::element_primitive_bits::vertex)) {
       // vertex is destination
-      for (auto ij : hermes::range2(sample_resolution))
+      forEachSample([&](auto ij) {
         DST(ij) = (SRC(ij.plus(-1, -1)) + SRC(ij.plus(-1, 0)) +
                    SRC(ij.plus(0, -1)) + SRC(ij.plus(0, 0))) *
                   0.25;
+      });
     } else if (sample_element.is(core::element_primitive_bits::face)) {
       if (sample_element.alignments().contain(
               core::element_alignment_bits::x)) {
         // x faces are the destination
-        for (auto ij : hermes::range2(sample_resolution))
+        forEachSample([&](auto ij) {
           DST(ij) = (SRC(ij.plus(0, -1)) + SRC(ij.plus(0, 0))) * 0.5;
+        });
       } else if (sample_element.alignments().contain(
                      core::element_alignment_bits::y)) {
         // y faces are the destination
-        for (auto ij : hermes::range2(sample_resolution))
+        forEachSample([&](auto ij) {
           DST(ij) = (SRC(ij.plus(-1, 0)) + SRC(ij.plus(0, 0))) * 0.5;
+        });
       }
     }
   } else if (field.element().is(core::element_primitive_bits::vertex)) {
     // vertex is source
     if (sample_element.is(core::element_primitive_bits::cell)) {
       // cell is destination
-      for (auto ij : hermes::range2(sample_resolution))
+      forEachSample([&](auto ij) {
         DST(ij) = (SRC(ij.plus(0, 0)) + SRC(ij.plus(0, 1)) +
                    SRC(ij.plus(1, 0)) + SRC(ij.plus(1, 1))) *
                   0.25;
+      });
     } else if (sample_element.is(core::element_primitive_bits::face)) {
       if (sample_element.alignments().contain(
               core::element_alignment_bits::x)) {
         // x faces are the destination
-        for (auto ij : hermes::range2(sample_resolution))
+        forEachSample([&](auto ij) {
           DST(ij) = (SRC(ij.plus(0, 0)) + SRC(ij.plus(1, 0))) * 0.5;
+        });
       } else if (sample_element.alignments().contain(
                      core::element_alignment_bits::y)) {
         // y faces are the destination
-        for (auto ij : hermes::range2(sample_resolution))
+        forEachSample([&](auto ij) {
           DST(ij) = (SRC(ij.plus(0, 0)) + SRC(ij.plus(0, 1))) * 0.5;
+        });
       }
     }
   }
@@ -136,102 +157,131 @@ void sample(const geo::Grid2 &grid, const core::FieldCRef<T> &field,
 #undef DST
 }
 
+/// Interpolates a component of a row-major field into the row-major elements
+/// of sample_field.
 template <typename T>
 void sample(const geo::Grid2 &grid, const core::FieldCRef<T> &field,
-            core::FieldRef<T> &sample_field) {
+            h_size component, core::FieldRef<f32> &sample_field) {
+  sample(grid, field, component, sample_field, grid.layout(field.element()),
+         grid.layout(sample_field.element()));
+}
+
+/// Interpolates a field into the elements of sample_field.
+/// \param field_layout Storage layout of the field elements.
+/// \param sample_layout Storage layout of the sample_field elements.
+template <typename T>
+void sample(const geo::Grid2 &grid, const core::FieldCRef<T> &field,
+            core::FieldRef<T> &sample_field,
+            const geo::GridLayout &field_layout,
+            const geo::GridLayout &sample_layout) {
   auto field_element = field.element();
   auto sample_element = sample_field.element();
-  auto sample_resolution = grid.resolution(sample_element);
+  HERMES_ASSERT(field_layout.resolution() == grid.resolution(field_element));
+  HERMES_ASSERT(sample_layout.resolution() ==
+                grid.resolution(sample_element));
+  // destinations are visited in storage order
+  auto forEachSample = [&](const auto &f) {
+    sample_layout.forEach(
+        [&](h_index, i32 i, i32 j) { f(hermes::index2(i, j)); });
+  };
 
 #define SRC(IJ)                                                                \
-  field[grid.safeFlatIndex(field_element, IJ) -                                \
-        grid.elementIndexOffset(field_element)]
+  field[field_layout.flatIndex(grid.safeIndex(field_element, IJ))]
 
-#define DST(IJ)                                                                \
-  sample_field[grid.flatIndex(sample_element, IJ) -                            \
-               grid.elementIndexOffset(sample_element)]
+#define DST(IJ) sample_field[sample_layout.flatIndex(IJ)]
 
   if (field.element() == sample_element) {
     // copy
-    for (h_size i = 0; i < field.size(); ++i)
-      sample_field[i] = field[i];
+    forEachSample([&](auto ij) { DST(ij) = SRC(ij); });
   } else if (field.element().is(core::element_primitive_bits::face)) {
     if (field.element().alignments().contain(core::element_alignment_bits::x)) {
       // x face is source
       if (sample_element.is(core::element_primitive_bits::cell)) {
         // cell is destination
-        for (auto ij : hermes::range2(sample_resolution))
+        forEachSample([&](auto ij) {
           DST(ij) = (SRC(ij.plus(0, 0)) + SRC(ij.plus(0, 1))) * 0.5;
+        });
       } else if (sample_element.is(core::element_primitive_bits::vertex)) {
         // vertex is destination
-        for (auto ij : hermes::range2(sample_resolution))
+        forEachSample([&](auto ij) {
           DST(ij) = (SRC(ij.plus(-1, 0)) + SRC(ij.plus(0, 0))) * 0.5;
+        });
       } else {
         // y face is destination
-        for (auto ij : hermes::range2(sample_resolution))
+        forEachSample([&](auto ij) {
           DST(ij) = (SRC(ij.plus(-1, 0)) + SRC(ij.plus(0, 0)) +
                      SRC(ij.plus(0, 1)) + SRC(ij.plus(-1, 1))) *
                     0.25;
+        });
       }
     } else if (field.element().alignments().contain(
                    core::element_alignment_bits::y)) {
       // y face is source
       if (sample_element.is(core::element_primitive_bits::cell)) {
         // cell is destination
-        for (auto ij : hermes::range2(sample_resolution))
+        forEachSample([&](auto ij) {
           DST(ij) = (SRC(ij.plus(0, 0)) + SRC(ij.plus(1, 0))) * 0.5;
+        });
       } else if (sample_element.is(core::element_primitive_bits::vertex)) {
         // vertex is destination
-        for (auto ij : hermes::range2(sample_resolution))
+        forEachSample([&](auto ij) {
           DST(ij) = (SRC(ij.plus(0, -1)) + SRC(ij.plus(0, 0))) * 0.5;
+        });
       } else {
         // x face is destination
-        for (auto ij : hermes::range2(sample_resolution))
+        forEachSample([&](auto ij) {
           DST(ij) = (SRC(ij.plus(0, -1)) + SRC(ij.plus(1, -1)) +
                      SRC(ij.plus(1, 0)) + SRC(ij.plus(0, 0))) *
                     0.25;
+        });
       }
     }
   } else if (field.element().is(core::element_primitive_bits::cell)) {
     // cell is source
     if (sample_element.is(core::element_primitive_bits::vertex)) {
       // vertex is destination
-      for (auto ij : hermes::range2(sample_resolution))
+      forEachSample([&](auto ij) {
         DST(ij) = (SRC(ij.plus(-1, -1)) + SRC(ij.plus(-1, 0)) +
                    SRC(ij.plus(0, -1)) + SRC(ij.plus(0, 0))) *
                   0.25;
+      });
     } else if (sample_element.is(core::element_primitive_bits::face)) {
       if (sample_element.alignments().contain(
               core::element_alignment_bits::x)) {
         // x faces are the destination
-        for (auto ij : hermes::range2(sample_resolution))
+        forEachSample([&](auto ij) {
           DST(ij) = (SRC(ij.plus(0, -1)) + SRC(ij.plus(0, 0))) * 0.5;
+        });
       } else if (sample_element.alignments().contain(
                      core::element_alignment_bits::y)) {
         // y faces are the destination
-        for (auto ij : hermes::range2(sample_resolution))
+        forEachSample([&](auto ij) {
           DST(ij) = (SRC(ij.plus(-1, 0)) + SRC(ij.plus(0, 0))) * 0.5;
+        });
       }
     }
   } else if (field.element().is(core::element_primitive_bits::vertex)) {
     // vertex is source
     if (sample_element.is(core::element_primitive_bits::cell)) {
       // cell is destination
-      for (auto ij : hermes::range2(sample_resolution))
+      forEachSample([&](auto ij) {
         DST(ij) = (SRC(ij.plus(0, 0)) + SRC(ij.plus(0, 1)) +
                    SRC(ij.plus(1, 0)) + SRC(ij.plus(1, 1))) *
                   0.25;
+      });
     } else if (sample_element.is(core::element_primitive_bits::face)) {
       if (sample_element.alignments().contain(
               core::element_alignment_bits::x)) {
         // x faces are the destination
-        for (auto ij : hermes::range2(sample_resolution))
+        forEachSample([&](auto ij) {
           DST(ij) = (SRC(ij.plus(0, 0)) + SRC(ij.plus(1, 0))) * 0.5;
+        });
       } else if (sample_element.alignments().contain(
                      core::element_alignment_bits::y)) {
         // y faces are the destination
-        for (auto ij : hermes::range2(sample_resolution))
+        forEachSample([&](auto ij) {
           DST(ij) = (SRC(ij.plus(0, 0)) + SRC(ij.plus(0, 1))) * 0.5;
+        });
       }
     }
   }
@@ -239,44 +289,98 @@ void sample(const geo::Grid2 &grid, const core::FieldCRef<T> &field,
 #undef DST
 }
 
+/// Interpolates a row-major field into the row-major elements of
+/// sample_field.
 template <typename T>
-Result<core::FieldGroup> sample(const geo::Grid2 &grid,
-                                const core::FieldCRef<T> &field,
-                                core::Element sample_element) {
+void sample(const geo::Grid2 &grid, const core::FieldCRef<T> &field,
+            core::FieldRef<T> &sample_field) {
+  sample(grid, field, sample_field, grid.layout(field.element()),
+         grid.layout(sample_field.element()));
+}
+
+/// Interpolates a field into the elements of the given type.
+/// \param layout Storage layout of the field elements. Samples are stored in
+///               the same storage order (and tile size).
+template <typename T>
+Result<core::FieldGroup>
+sample(const geo::Grid2 &grid, const core::FieldCRef<T> &field,
+       core::Element sample_element, const geo::GridLayout &layout) {
   core::FieldGroup samples;
   samples.pushField<T>();
   samples.setElement(sample_element);
   NAIADES_HE_RETURN_BAD_RESULT(
       samples.resize(grid.resolution(sample_element).total()));
-  if (field.size() != samples.size()) {
+  if (field.size() != layout.size()) {
     HERMES_ERROR("Sampling field size mismatch element count {} != {}",
-                 field.size(), samples.size());
+                 field.size(), layout.size());
     return NaResult::checkError();
   }
   auto acc = samples.get<T>(0);
-  if (field.element() == sample_element)
-    for (h_size i = 0; i < samples.size(); ++i)
-      acc[i] = field[i];
-  else
-    sample(grid, field, acc);
+  sample(grid, field, acc, layout,
+         grid.layout(sample_element, layout.storage(), layout.tileSize()));
   return Result<core::FieldGroup>(std::move(samples));
 }
 
+/// Interpolates a row-major field into row-major elements of the given type.
+template <typename T>
+Result<core::FieldGroup> sample(const geo::Grid2 &grid,
+                                const core::FieldCRef<T> &field,
+                                core::Element sample_element) {
+  return sample(grid, field, sample_element, grid.layout(field.element()));
+}
+
+/// Samples a field stored with the given layout at world positions.
+/// \param layout Storage layout of the field elements.
 template <typename T>
 Result<core::FieldGroup>
 sample(const geo::Grid2 &grid, const core::FieldCRef<T> &field,
-       const std::vector<hermes::geo::point2> &positions) {
+       const std::vector<hermes::geo::point2> &positions,
+       const geo::GridLayout &layout) {
   core::FieldGroup samples;
   samples.pushField<T>();
   samples.setElement(core::Element::Type::VERTEX);
   NAIADES_HE_RETURN_BAD_RESULT(samples.resize(positions.size()));
 
-  auto acc = samples.get<T>(0);
+  std::vector<f32> xs(positions.size()), ys(positions.size());
   for (h_size i = 0; i < positions.size(); ++i) {
-    acc[i] =
-        Stencil::bilinear(grid, field.element(), positions[i]).evaluate(field);
+    xs[i] = positions[i].x;
+    ys[i] = positions[i].y;
   }
+  BilinearStencils stencils;
+  bilinear(grid, field.element(), xs, ys, layout, stencils);
+
+  auto acc = samples.get<T>(0);
+  if (field.contiguous()) {
+    std::span<const T> values(field.data(), field.size());
+    parallelFor(0, positions.size(),
+                [&](h_index i) { acc[i] = stencils.evaluate(values, i); });
+  } else
+    parallelFor(0, positions.size(),
+                [&](h_index i) { acc[i] = stencils.evaluate(field, i); });
 
   return Result<core::FieldGroup>(std::move(samples));
 }
+
+template <typename T>
+Result<core::FieldGroup>
+sample(const geo::Grid2 &grid, const core::FieldCRef<T> &field,
+       const std::vector<hermes::geo::point2> &positions) {
+  return sample(grid, field, positions, grid.layout(field.element()));
+}
+
+/// Samples a single sub-field of a field group at world positions.
+/// \note Sub-fields of SOA field groups (see core::FieldStorage) are read
+///       from contiguous memory.
+/// \param component Index of the sub-field within the field group.
+template <typename T>
+Result<core::FieldGroup>
+sample(const geo::Grid2 &grid, const core::FieldGroup &group, h_size component,
+       const std::vector<hermes::geo::point2> &positions) {
+  if (component >= group.fieldCount()) {
+    HERMES_ERROR("Sub-field {} out of range ({} sub-fields)", component,
+                 group.fieldCount());
+    return NaResult::inputError();
+  }
+  return sample(grid, group.get<T>(component), positions);
+}
 }; // namespace naiades::sampling
@@ -24,41 +24,111 @@
 /// \author FilipeCN (filipedecn@gmail.com)
 /// \date   2025-06-07
 
-#include <hermes/numeric/numeric.h>
 #include <naiades/sampling/stencil.h>
 
+#include <algorithm>
+#include <cmath>
+
 namespace naiades::sampling {
 
-Stencil Stencil::nearest(const geo::Grid2 &grid, core::Element loc,
-                         const hermes::geo::point2 &wp) {
-  // transform wp into index space
-  auto gp = grid.gridPosition(loc, wp);
-  // consider the unit square
-  auto x = hermes::numbers::fract(gp.x);
-  auto y = hermes::numbers::fract(gp.y);
+namespace {
 
-  Stencil stencil;
+/// Catmull-Rom weights of the nodes -1, 0, 1, 2 at t in [0,1].
+std::array<f32, 4> catmullRomWeights(f32 t) {
+  const f32 t2 = t * t;
+  const f32 t3 = t2 * t;
+  return {0.5f * (-t3 + 2.f * t2 - t), 0.5f * (3.f * t3 - 5.f * t2 + 2.f),
+          0.5f * (-3.f * t3 + 4.f * t2 + t), 0.5f * (t3 - t2)};
+}
 
-  stencil.add(
-      grid.safeFlatIndex(
-          loc, hermes::index2(static_cast<i32>(gp.x), static_cast<i32>(gp.y))
-                   .plus(x > 0.5f ? 1 : 0, y > 0.5f ? 1 : 0)),
-      1.f);
+/// Index space of a grid element.
+struct GridFrame {
+  f32 ox, oy;
+  f32 inv_dx, inv_dy;
+  i32 w, h;
+};
+
+/// Bilinear nodes of n points, node k of point p goes to k * n + p.
+/// \note Inputs and outputs are distinct allocations. Restrict-qualifying
+///       them and splitting indices from weights keeps the alias checks of
+///       each branch-free loop few enough to be vectorized.
+void bilinearRows(const GridFrame &frame, h_size n,
+                  const f32 *__restrict xs, const f32 *__restrict ys,
+                  h_size *__restrict indices, f32 *__restrict weights) {
+  const f32 ox = frame.ox;
+  const f32 oy = frame.oy;
+  const f32 inv_dx = frame.inv_dx;
+  const f32 inv_dy = frame.inv_dy;
+  const i32 w = frame.w;
+  const i32 h = frame.h;
+  const f32 fw = static_cast<f32>(w);
+  const f32 fh = static_cast<f32>(h);
+  // grid positions are clamped to [-1, res] so the integer conversion cannot
+  // overflow and truncating the shifted position floors it (std::floor does
+  // not vectorize under strict floating point semantics)
+  auto gridX = [&](h_size p) {
+    f32 g = (xs[p] - ox) * inv_dx;
+    g = g < -1.f ? -1.f : g;
+    return g > fw ? fw : g;
+  };
+  auto gridY = [&](h_size p) {
+    f32 g = (ys[p] - oy) * inv_dy;
+    g = g < -1.f ? -1.f : g;
+    return g > fh ? fh : g;
+  };
+  auto cell = [](f32 g) { return static_cast<i32>(g + 1.f) - 1; };
+  for (h_size p = 0; p < n; ++p) {
+    const i32 i = cell(gridX(p));
+    const i32 j = cell(gridY(p));
+    const i32 i0 = std::clamp(i, 0, w - 1);
+    const i32 i1 = std::clamp(i + 1, 0, w - 1);
+    const i32 j0 = std::clamp(j, 0, h - 1) * w;
+    const i32 j1 = std::clamp(j + 1, 0, h - 1) * w;
+    indices[p] = j0 + i0;
+    indices[n + p] = j1 + i0;
+    indices[2 * n + p] = j0 + i1;
+    indices[3 * n + p] = j1 + i1;
+  }
+  for (h_size p = 0; p < n; ++p) {
+    // fractional part inside the unit square
+    const f32 gx = gridX(p);
+    const f32 gy = gridY(p);
+    const f32 x = gx - cell(gx);
+    const f32 y = gy - cell(gy);
+    weights[p] = (1.f - x) * (1.f - y);
+    weights[n + p] = (1.f - x) * y;
+    weights[2 * n + p] = x * (1.f - y);
+    weights[3 * n + p] = x * y;
+  }
+}
 
+} // namespace
+
+NearestStencil nearest(const geo::Grid2 &grid, core::Element loc,
+                       const hermes::geo::point2 &wp) {
+  // transform wp into index space
+  auto gp = grid.gridPosition(loc, wp);
+  NearestStencil stencil;
+  stencil.add(grid.safeFlatIndex(
+                  loc, {static_cast<i32>(std::floor(gp.x + 0.5f)),
+                        static_cast<i32>(std::floor(gp.y + 0.5f))}) -
+                  grid.elementIndexOffset(loc),
+              1.f);
   return stencil;
 }
 
-Stencil Stencil::bilinear(const geo::Grid2 &grid, core::Element loc,
-                          const hermes::geo::point2 &wp) {
+BilinearStencil bilinear(const geo::Grid2 &grid, core::Element loc,
+                         const hermes::geo::point2 &wp) {
   // transform wp into index space
   auto gp = grid.gridPosition(loc, wp);
+  const f32 fx = std::floor(gp.x);
+  const f32 fy = std::floor(gp.y);
   // consider the unit square
-  auto x = hermes::numbers::fract(gp.x);
-  auto y = hermes::numbers::fract(gp.y);
-
+  const f32 x = gp.x - fx;
+  const f32 y = gp.y - fy;
   // bottom left coordinates give the grid index
-  auto cell_index =
-      hermes::index2(static_cast<i32>(gp.x), static_cast<i32>(gp.y));
+  auto cell_index = hermes::index2(static_cast<i32>(fx), static_cast<i32>(fy));
+  auto offset = grid.elementIndexOffset(loc);
 
   ///   v12        x   v22
   ///              |
@@ -67,74 +137,84 @@ Stencil Stencil::bilinear(const geo::Grid2 &grid, core::Element loc,
   ///              |
   ///   v11        x   v21
 
-  auto v11 = grid.safeFlatIndex(loc, cell_index.plus(0, 0)) -
-             grid.elementIndexOffset(loc);
-  auto v21 = grid.safeFlatIndex(loc, cell_index.plus(1, 0)) -
-             grid.elementIndexOffset(loc);
-  auto v12 = grid.safeFlatIndex(loc, cell_index.plus(0, 1)) -
-             grid.elementIndexOffset(loc);
-  auto v22 = grid.safeFlatIndex(loc, cell_index.plus(1, 1)) -
-             grid.elementIndexOffset(loc);
-
-  // since wp may fall off the grid or on top of its edges/vertices
-  // we may have repeated indices
-
-  Stencil stencil;
-
-  if (v11 == v12 && v11 == v21 && v11 == v22) {
-    // we are on the corner
-    // v12 v22
-    // v11 v21
-    stencil.add(v11, 1.f);
-  } else if (v11 == v12 || v21 == v22) {
-    // we are above/bellow the grid
-    //  v12 ___________ v22
-    //  v11             v21
-    stencil.add(v11, x - 0.f);
-    stencil.add(v21, 1.f - x);
-  } else if (v12 == v22 || v11 == v21) {
-    // we are on the left/right side of the grid
-    // v12 v22
-    //    |
-    // v11 v21
-    stencil.add(v11, y - 0.f);
-    stencil.add(v12, 1.f - y);
-  } else {
-    // all must be different
-    HERMES_ASSERT(v11 != v12 && v11 != v21 && v11 != v22);
-
-    // w11 = (x2 - x)(y2 - y) / (x2 - x1)(y2 - y1)
-    // w12 = (x2 - x)(y - y1) / (x2 - x1)(y2 - y1)
-    // w21 = (x - x1)(y2 - y) / (x2 - x1)(y2 - y1)
-    // w22 = (x - x1)(y - y1) / (x2 - x1)(y2 - y1)
-
-    // since (x,y) are the fractional of gp:
-    // (x1, y1) = (0,0)
-    // (x2, y2) = (1,1)
-    // so the denominators  (x2 - x1)(y2 - y1) = 1
-    //
-    // w11 = (x2 - x)(y2 - y)
-    stencil.add(v11, (1.f - x) * (1.f - y));
-    // w12 = (x2 - x)(y - y1)
-    stencil.add(v12, (1.f - x) * (y - 0.f));
-    // w21 = (x - x1)(y2 - y)
-    stencil.add(v21, (x - 0.f) * (1.f - y));
-    // w22 = (x - x1)(y - y1)
-    stencil.add(v22, (x - 0.f) * (y - 0.f));
-  }
+  // since wp may fall off the grid or on top of its edges/vertices, clamped
+  // indices may repeat and get merged by the stencil
+  BilinearStencil stencil;
+  stencil.add(grid.safeFlatIndex(loc, cell_index.plus(0, 0)) - offset,
+              (1.f - x) * (1.f - y));
+  stencil.add(grid.safeFlatIndex(loc, cell_index.plus(0, 1)) - offset,
+              (1.f - x) * y);
+  stencil.add(grid.safeFlatIndex(loc, cell_index.plus(1, 0)) - offset,
+              x * (1.f - y));
+  stencil.add(grid.safeFlatIndex(loc, cell_index.plus(1, 1)) - offset, x * y);
+  return stencil;
+}
 
+BicubicStencil bicubic(const geo::Grid2 &grid, core::Element loc,
+                       const hermes::geo::point2 &wp) {
+  auto gp = grid.gridPosition(loc, wp);
+  const f32 fx = std::floor(gp.x);
+  const f32 fy = std::floor(gp.y);
+  auto wx = catmullRomWeights(gp.x - fx);
+  auto wy = catmullRomWeights(gp.y - fy);
+  auto cell_index = hermes::index2(static_cast<i32>(fx), static_cast<i32>(fy));
+  auto offset = grid.elementIndexOffset(loc);
+
+  BicubicStencil stencil;
+  for (i32 di = 0; di < 4; ++di)
+    for (i32 dj = 0; dj < 4; ++dj)
+      stencil.add(
+          grid.safeFlatIndex(loc, cell_index.plus(di - 1, dj - 1)) - offset,
+          wx[di] * wy[dj]);
   return stencil;
 }
 
-void Stencil::add(h_size index, float weight) {
-  indices_.emplace_back(index);
-  weights_.emplace_back(weight);
+h_size BilinearStencils::size() const { return size_; }
+
+std::span<const h_size> BilinearStencils::indices(h_size k) const {
+  return {indices_.data() + k * size_, size_};
 }
 
-h_size Stencil::size() const { return indices_.size(); }
+std::span<const f32> BilinearStencils::weights(h_size k) const {
+  return {weights_.data() + k * size_, size_};
+}
 
-const std::vector<h_size> Stencil::indices() const { return indices_; }
+void bilinear(const geo::Grid2 &grid, core::Element loc,
+              std::span<const f32> xs, std::span<const f32> ys,
+              BilinearStencils &stencils) {
+  HERMES_ASSERT(xs.size() == ys.size());
+  const h_size n = xs.size();
+  stencils.size_ = n;
+  stencils.indices_.resize(4 * n);
+  stencils.weights_.resize(4 * n);
+
+  const auto o = grid.origin(loc);
+  const auto cell_size = grid.cellSize();
+  const auto res = grid.resolution(loc);
+  GridFrame frame;
+  frame.ox = o.x;
+  frame.oy = o.y;
+  frame.inv_dx = 1.f / cell_size.x;
+  frame.inv_dy = 1.f / cell_size.y;
+  frame.w = static_cast<i32>(res.width);
+  frame.h = static_cast<i32>(res.height);
+  bilinearRows(frame, n, xs.data(), ys.data(), stencils.indices_.data(),
+               stencils.weights_.data());
+}
 
-const std::vector<f32> Stencil::weights() const { return weights_; }
+void bilinear(const geo::Grid2 &grid, core::Element loc,
+              std::span<const f32> xs, std::span<const f32> ys,
+              const geo::GridLayout &layout, BilinearStencils &stencils) {
+  bilinear(grid, loc, xs, ys, stencils);
+  if (layout.storage() == geo::GridStorage::ROW_MAJOR)
+    return;
+  // translate row-major node indices into the storage order
+  const h_size w = layout.resolution().width;
+  auto &indices = stencils.indices_;
+  parallelFor(0, indices.size(), [&](h_index k) {
+    indices[k] = layout.flatIndex(static_cast<i32>(indices[k] % w),
+                                  static_cast<i32>(indices[k] / w));
+  });
+}
 
 } // namespace naiades::sampling
@@ -1,4 +1,4 @@
-/* Copyright (c) 2025, FilipeCN.
+/* Copyright (c) 2026, FilipeCN.
  *
  * The MIT License (MIT)
  *
@@ -30,52 +30,138 @@
 #include <naiades/core/field.h>
 #include <naiades/geo/grid.h>
 
+#include <array>
+#include <span>
+
 namespace naiades::sampling {
 
-class Stencil {
+/// Fixed-capacity interpolation stencil.
+/// \note Nodes live on the stack; repeated indices (clamped at the grid
+///       borders) are merged by accumulating their weights.
+/// \tparam N Maximum number of nodes.
+template <h_size N> class Stencil {
 public:
-  static Stencil nearest(const geo::Grid2 &grid, core::Element loc,
-                         const hermes::geo::point2 &p);
-  static Stencil bilinear(const geo::Grid2 &grid, core::Element loc,
-                          const hermes::geo::point2 &p);
+  static constexpr h_size capacity = N;
 
-  template <typename T> T evaluate(const core::FieldCRef<T> &field) {
+  template <typename T> T evaluate(const core::FieldCRef<T> &field) const {
     T s = {};
-    const h_size n = indices_.size();
-    for (h_size i = 0; i < n; ++i) {
+    for (h_size i = 0; i < size_; ++i)
       s += field[indices_[i]] * weights_[i];
-    }
     return s;
   }
 
-  void add(h_size index, f32 weight);
+  void add(h_size index, f32 weight) {
+    for (h_size i = 0; i < size_; ++i)
+      if (indices_[i] == index) {
+        weights_[i] += weight;
+        return;
+      }
+    HERMES_ASSERT(size_ < N);
+    indices_[size_] = index;
+    weights_[size_++] = weight;
+  }
+  h_size size() const { return size_; }
+  std::span<const h_size> indices() const { return {indices_.data(), size_}; }
+  std::span<const f32> weights() const { return {weights_.data(), size_}; }
+
+private:
+  std::array<h_size, N> indices_{};
+  std::array<f32, N> weights_{};
+  h_size size_{0};
+};
+
+using NearestStencil = Stencil<1>;
+using BilinearStencil = Stencil<4>;
+using BicubicStencil = Stencil<16>;
+
+/// Nearest node of a world position.
+NearestStencil nearest(const geo::Grid2 &grid, core::Element loc,
+                       const hermes::geo::point2 &wp);
+/// Bilinear stencil of a world position.
+/// \note Nodes are ordered as (i,j), (i,j+1), (i+1,j), (i+1,j+1).
+BilinearStencil bilinear(const geo::Grid2 &grid, core::Element loc,
+                         const hermes::geo::point2 &wp);
+/// Catmull-Rom bicubic stencil of a world position.
+BicubicStencil bicubic(const geo::Grid2 &grid, core::Element loc,
+                       const hermes::geo::point2 &wp);
+
+/// Bilinear stencils of a batch of points in structure-of-arrays layout.
+/// \note Node k of point i is stored at k * size() + i and nodes are not
+///       merged, so every point keeps exactly 4 (possibly repeated) nodes.
+class BilinearStencils {
+public:
   h_size size() const;
-  const std::vector<h_size> indices() const;
-  const std::vector<f32> weights() const;
+  /// \param k Node in [0,4) following the order of bilinear().
+  std::span<const h_size> indices(h_size k) const;
+  /// \param k Node in [0,4) following the order of bilinear().
+  std::span<const f32> weights(h_size k) const;
+
+  template <typename T>
+  T evaluate(const core::FieldCRef<T> &field, h_size i) const {
+    T s = {};
+    for (h_size k = 0; k < 4; ++k)
+      s += field[indices_[k * size_ + i]] * weights_[k * size_ + i];
+    return s;
+  }
+
+  /// Evaluates the stencil of point i over contiguous values.
+  template <typename T>
+  T evaluate(std::span<const T> values, h_size i) const {
+    T s = {};
+    for (h_size k = 0; k < 4; ++k)
+      s += values[indices_[k * size_ + i]] * weights_[k * size_ + i];
+    return s;
+  }
 
 private:
+  friend void bilinear(const geo::Grid2 &grid, core::Element loc,
+                       std::span<const f32> xs, std::span<const f32> ys,
+                       BilinearStencils &stencils);
+  friend void bilinear(const geo::Grid2 &grid, core::Element loc,
+                       std::span<const f32> xs, std::span<const f32> ys,
+                       const geo::GridLayout &layout,
+                       BilinearStencils &stencils);
+
+  h_size size_{0};
   std::vector<h_size> indices_;
   std::vector<f32> weights_;
-
-#ifdef NAIADES_INCLUDE_DEBUG_TRAITS
-  friend struct hermes::DebugTraits<Stencil>;
-#endif
 };
 
+/// Computes the bilinear stencils of a batch of world positions.
+/// \note Storage is reused between calls of the same batch size.
+/// \param xs World x coordinates.
+/// \param ys World y coordinates.
+/// \param stencils Receives one stencil per point.
+void bilinear(const geo::Grid2 &grid, core::Element loc,
+              std::span<const f32> xs, std::span<const f32> ys,
+              BilinearStencils &stencils);
+/// Computes the bilinear stencils of a batch of world positions for values
+/// stored with the given layout.
+/// \param layout Storage layout of the loc elements.
+void bilinear(const geo::Grid2 &grid, core::Element loc,
+              std::span<const f32> xs, std::span<const f32> ys,
+              const geo::GridLayout &layout, BilinearStencils &stencils);
+
 } // namespace naiades::sampling
 
 #ifdef NAIADES_INCLUDE_DEBUG_TRAITS
 
 namespace hermes {
 
-template <> struct DebugTraits<naiades::sampling::Stencil> {
+template <h_size N> struct DebugTraits<naiades::sampling::Stencil<N>> {
   static HERMES_CONST_OR_CONSTEXPR bool is_string_serializable = true;
-  static DebugMessage message(const naiades::sampling::Stencil &data) {
+  static DebugMessage message(const naiades::sampling::Stencil<N> &data) {
+    auto indices = data.indices();
+    auto weights = data.weights();
     auto m = DebugMessage();
     m.addTitle("Stencil");
-    m.add("size", data.indices_.size());
-    m.add("indices", hermes::cstr::join(data.indices_, " "));
-    m.add("weights", hermes::cstr::join(data.weights_, " "));
+    m.add("size", data.size());
+    m.add("indices", hermes::cstr::join(
+                         std::vector<h_size>(indices.begin(), indices.end()),
+                         " "));
+    m.add("weights", hermes::cstr::join(
+                         std::vector<f32>(weights.begin(), weights.end()),
+                         " "));
     return m;
   }
 };
@@ -27,6 +27,7 @@
 
 #pragma once
 
+#include <naiades/base/parallel.h>
 #include <naiades/core/field.h>
 #include <naiades/geo/grid.h>
 #include <naiades/sampling/sampler.h>
@@ -73,7 +74,7 @@ NaResult advect(const geo::Grid2 &grid, const core::FieldCRef<f32> &u,
                                 sampling::sample(grid, u, in_field_element));
   auto v_v = v_v_field.template get<f32>(0);
   auto v_u = v_u_field.template get<f32>(0);
-  for (auto ij : hermes::range2(field_res)) {
+  parallelFor(hermes::range2(field_res), [&](auto ij) {
     auto wp = grid.center(in_field_element, ij);
     auto flat_index = grid.safeFlatIndex(in_field_element, ij);
     // sample velocity components
@@ -82,7 +83,7 @@ NaResult advect(const geo::Grid2 &grid, const core::FieldCRef<f32> &u,
     auto sp = wp - velocity * dt;
     // sample field at source
     out_field[flat_index] = sample_func(grid, in_field, sp);
-  }
+  });
   return NaResult::noError();
 }
 
@@ -0,0 +1,237 @@
+/* Copyright (c) 2026, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/// \file   semi_lagrangian.h
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-16
+/// \brief  Semi-Lagrangian advection on grids.
+
+#pragma once
+
+#include <naiades/base/parallel.h>
+#include <naiades/sampling/grid_sampler.h>
+
+#include <utility>
+#include <vector>
+
+namespace naiades::solvers {
+
+/// Time integration used to trace characteristics back in time.
+enum class Integrator { EULER, RK2, RK3 };
+
+/// Error compensation applied on top of the semi-Lagrangian step.
+enum class AdvectionCorrection { NONE, BFECC, MACCORMACK };
+
+/// \brief Velocity field given by its x and y components, each one stored on
+///        its own Grid2 element type (ex: staggered face velocities).
+class GridVelocity2 {
+public:
+  /// \param u x component.
+  /// \param v y component.
+  /// \param storage Storage order of both components.
+  /// \param tile_size Tile side of tiled storages.
+  GridVelocity2(const geo::Grid2 &grid, const core::FieldCRef<f32> &u,
+                const core::FieldCRef<f32> &v,
+                geo::GridStorage storage = geo::GridStorage::ROW_MAJOR,
+                u32 tile_size = 16)
+      : u_(grid, u.element(), u,
+           grid.layout(u.element(), storage, tile_size)),
+        v_(grid, v.element(), v,
+           grid.layout(v.element(), storage, tile_size)) {}
+
+  /// \return Bilinear interpolated velocity at the world position.
+  hermes::geo::vec2 operator()(const hermes::geo::point2 &wp) const {
+    return {sampling::LinearSampler::sample(u_, wp),
+            sampling::LinearSampler::sample(v_, wp)};
+  }
+
+private:
+  sampling::GridFieldView<f32> u_;
+  sampling::GridFieldView<f32> v_;
+};
+
+/// \brief Semi-Lagrangian advection of Grid2 fields.
+///
+/// Each element value is taken from the input field at the position where
+/// the characteristic through the element was dt seconds before. The
+/// interpolation is a compile-time Sampler (sampling::LinearSampler,
+/// sampling::CubicSampler). The grid is processed in parallel by square
+/// tiles of elements.
+///
+/// Fields may be stored in a tiled geo::GridStorage (see setStorage), in which
+/// case tiles are traversed in storage order and both writes and gathers stay
+/// within a few tiles.
+///
+/// Corrections estimate the advection error by advecting the result back in
+/// time:
+///  - BFECC advects the input field corrected by half the error.
+///  - MACCORMACK corrects the advected field by half the error.
+/// Corrected scalar values are limited to the range of the input values
+/// around the traced position. MACCORMACK falls back to the uncorrected
+/// value when the limit is violated.
+///
+/// \note Intermediate fields of corrections are kept between calls.
+/// \tparam T Field value type.
+template <typename T> class SemiLagrangian {
+public:
+  SemiLagrangian &setIntegrator(Integrator integrator) {
+    integrator_ = integrator;
+    return *this;
+  }
+  SemiLagrangian &setCorrection(AdvectionCorrection correction) {
+    correction_ = correction;
+    return *this;
+  }
+  /// \param tile_size Elements per tile side (rounded up to a power of two).
+  ///        It is also the tile of tiled storages.
+  SemiLagrangian &setTileSize(h_size tile_size) {
+    tile_size_ = std::max<h_size>(tile_size, 1);
+    return *this;
+  }
+  /// \param storage Storage order of the velocity and advected fields.
+  SemiLagrangian &setStorage(geo::GridStorage storage) {
+    storage_ = storage;
+    return *this;
+  }
+
+  /// \param grid
+  /// \param u Velocity x component.
+  /// \param v Velocity y component.
+  /// \param dt Time step.
+  /// \param in_field Input field.
+  /// \param out_field Advected field (same element type of in_field).
+  template <typename Sampler = sampling::LinearSampler>
+  NaResult advect(const geo::Grid2 &grid, const core::FieldCRef<f32> &u,
+                  const core::FieldCRef<f32> &v, f32 dt,
+                  const core::FieldCRef<T> &in_field,
+                  core::FieldRef<T> &out_field) const {
+    const auto element = in_field.element();
+    const auto res = grid.resolution(element);
+    if (!(out_field.element() == element) ||
+        in_field.size() != res.total() || out_field.size() != res.total()) {
+      HERMES_ERROR("Advection fields do not match the {} grid.",
+                   hermes::to_string(element));
+      return NaResult::checkError();
+    }
+    const auto tile_size = static_cast<u32>(tile_size_);
+    const auto layout = grid.layout(element, storage_, tile_size);
+    const GridVelocity2 velocity(grid, u, v, storage_, tile_size);
+    const sampling::GridFieldView<T> in(grid, element, in_field, layout);
+    if (correction_ == AdvectionCorrection::NONE) {
+      trace(velocity, in, dt, [&](h_index k, const hermes::geo::point2 &p) {
+        out_field[k] = Sampler::sample(in, p);
+      });
+      return NaResult::noError();
+    }
+
+    forward_.resize(res.total());
+    backward_.resize(res.total());
+    const sampling::GridFieldView<T, std::span<const T>> forward(
+        grid, element, forward_, layout);
+    const sampling::GridFieldView<T, std::span<const T>> backward(
+        grid, element, backward_, layout);
+    trace(velocity, in, dt, [&](h_index k, const hermes::geo::point2 &p) {
+      forward_[k] = Sampler::sample(in, p);
+    });
+    trace(velocity, forward, -dt,
+          [&](h_index k, const hermes::geo::point2 &p) {
+            backward_[k] = Sampler::sample(forward, p);
+          });
+
+    if (correction_ == AdvectionCorrection::BFECC) {
+      // backward_ becomes the corrected input field
+      parallelFor(0, backward_.size(), [&](h_index k) {
+        backward_[k] = in_field[k] + (in_field[k] - backward_[k]) * 0.5f;
+      });
+      trace(velocity, in, dt, [&](h_index k, const hermes::geo::point2 &p) {
+        T value = Sampler::sample(backward, p);
+        if constexpr (std::is_arithmetic_v<T>) {
+          auto range = localRange(in, p);
+          value = std::clamp(value, range.first, range.second);
+        }
+        out_field[k] = value;
+      });
+    } else {
+      trace(velocity, in, dt, [&](h_index k, const hermes::geo::point2 &p) {
+        T value = forward_[k] + (in_field[k] - backward_[k]) * 0.5f;
+        if constexpr (std::is_arithmetic_v<T>) {
+          auto range = localRange(in, p);
+          if (value < range.first || value > range.second)
+            value = forward_[k];
+        }
+        out_field[k] = value;
+      });
+    }
+    return NaResult::noError();
+  }
+
+private:
+  /// \return The traced position of wp, dt seconds before.
+  hermes::geo::point2 backtrace(const GridVelocity2 &velocity,
+                                const hermes::geo::point2 &wp, f32 dt) const {
+    auto k1 = velocity(wp);
+    switch (integrator_) {
+    case Integrator::EULER:
+      return wp - k1 * dt;
+    case Integrator::RK2:
+      return wp - velocity(wp - k1 * (0.5f * dt)) * dt;
+    case Integrator::RK3: {
+      // Ralston's third order method
+      auto k2 = velocity(wp - k1 * (0.5f * dt));
+      auto k3 = velocity(wp - k2 * (0.75f * dt));
+      return wp - (k1 * (2.f / 9.f) + k2 * (3.f / 9.f) + k3 * (4.f / 9.f)) * dt;
+    }
+    }
+    return wp;
+  }
+
+  /// Calls f(k, p) for every element k of the field grid, where p is the
+  /// position traced back from the element.
+  template <typename F, typename Function>
+  void trace(const GridVelocity2 &velocity,
+             const sampling::GridFieldView<T, F> &field, f32 dt,
+             const Function &f) const {
+    field.layout().forEach([&](h_index k, i32 i, i32 j) {
+      f(k, backtrace(velocity, field.worldPosition(i, j), dt));
+    });
+  }
+
+  /// \return The range of the four input values around p.
+  static std::pair<T, T> localRange(const sampling::GridFieldView<T> &in,
+                                    const hermes::geo::point2 &p) {
+    auto gp = in.gridPosition(p);
+    const i32 i = static_cast<i32>(std::floor(gp.x));
+    const i32 j = static_cast<i32>(std::floor(gp.y));
+    return std::minmax({in.at(i, j), in.at(i + 1, j), in.at(i, j + 1),
+                        in.at(i + 1, j + 1)});
+  }
+
+  Integrator integrator_{Integrator::RK2};
+  AdvectionCorrection correction_{AdvectionCorrection::NONE};
+  h_size tile_size_{32};
+  geo::GridStorage storage_{geo::GridStorage::ROW_MAJOR};
+  mutable std::vector<T> forward_;
+  mutable std::vector<T> backward_;
+};
+
+} // namespace naiades::solvers
@@ -108,8 +108,7 @@ NaResult SmokeSolver2::solveVelocity(f32 dt) {
   auto f = [](const naiades::geo::Grid2 &grid,
               const naiades::core::FieldCRef<f32> &field,
               const hermes::geo::point2 &p) -> f32 {
-    auto stencil =
-        naiades::sampling::Stencil::bilinear(grid, field.element(), p);
+    auto stencil = naiades::sampling::bilinear(grid, field.element(), p);
     return stencil.evaluate(field);
   };
 
@@ -30,13 +30,18 @@
 
 #include <hermes/base/index.h>
 
-#include <bitset>
 #include <functional>
+#include <vector>
 
-#define MORTON_TREE_ELEMENT_INDEX_BOUND 1 << 10
+/// Deepest level of a tree, 2^16 cells per side keep z-indices in 32 bits.
+#define MORTON_TREE_MAX_LEVEL 16
 
 namespace naiades::spatial {
 
+/// Linear quadtree of Morton (z-order) keys.
+/// \note Only leaves are stored, sorted by the z-index of their lower corner
+///       at the finest level, along with their levels. Level 0 is the root
+///       and max level cells have unit size.
 class MortonTree2 {
 public:
   class iterator {
@@ -53,10 +58,10 @@ public:
 
   private:
     friend class MortonTree2;
-    iterator(const MortonTree2 &mt, h_index z);
+    iterator(const MortonTree2 &mt, h_index leaf);
 
     const MortonTree2 &mt_;
-    h_index z_;
+    h_index leaf_;
   };
 
   /// \brief
@@ -64,6 +69,7 @@ public:
   /// \return
   static Result<MortonTree2> fromMaxLevel(h_size max_level);
   /// \brief
+  /// \note The resolution is rounded up to a power of two.
   /// \param resolution
   /// \return
   static Result<MortonTree2> fromResolution(h_size resolution);
@@ -74,7 +80,14 @@ public:
   iterator begin() const;
   iterator end() const;
 
-  /// /brief
+  /// \return The number of leaves.
+  h_size size() const;
+  /// \return The number of finest level cells per side.
+  h_size resolution() const;
+  /// \return The level of the finest cells.
+  h_index maxLevel() const;
+
+  /// \brief Collapses the tree into its root.
   void reset();
 
   struct PredicateData {
@@ -82,44 +95,25 @@ public:
     h_index level;
   };
 
-  /// /brief
-  /// /param predicate
-  /// /return
+  /// \brief Splits leaves until the predicate rejects them.
+  /// \note Leaves are tested concurrently, so the predicate must be
+  ///       thread-safe.
+  /// \param predicate Returns true if the leaf must be split.
+  /// \return
   NaResult refine(const std::function<bool(const PredicateData &)> &predicate);
 
 private:
-  ///
-  NaResult split(h_index z_index);
-  ///
-  NaResult merge(h_index z_index, h_index l);
-  /// \return true if the cell indexed by z-index is active.
-  bool isActive(h_index z_index) const;
-  ///
-  NaResult childrenIndices(h_index z_index, h_index l,
-                           h_index children_indices[4]) const;
   /// \return the side length of a cell at the given level.
-  h_index levelResolution(h_index level) const;
+  h_size levelResolution(h_index level) const;
   /// \return the area of a cell at the given level.
-  h_index levelArea(h_index level) const;
-  /// \return true if the given index can be a cell head.
-  bool isCellHead(h_index h_index) const;
-  /// The parent index at a given level is the largest z-index value multiple
-  /// of the size of the level that is smaller or equal the given index.
-  /// \return the index of the parent of the given index at specified level.
-  h_index parentIndex(h_index level, h_index z_index) const;
-  /// \note this assumes z_index is active.
-  /// \return The level of the given node.
-  h_index level(h_index active_z_index) const;
-  /// \return true if the given node is a leaf node.
-  bool isLeaf(h_index z_index) const;
-  /// \return The child index [0-4] of the given node in the parent children
-  /// list.
-  h_index parentChildIndex(h_index z_index) const;
-  /// \return The index area covered by the given cell.
-  hermes::range2 cellIndexBounds(h_index z_index) const;
-
-  std::bitset<MORTON_TREE_ELEMENT_INDEX_BOUND> active_cells_;
-  h_size resolution_{0};
+  h_size levelArea(h_index level) const;
+  /// \return The index area covered by the given leaf.
+  hermes::range2 cellIndexBounds(h_index leaf) const;
+
+  // leaves sorted by z-index
+  std::vector<u32> z_indices_;
+  std::vector<u8> levels_;
+  h_size resolution_{1};
   h_index max_level_{0};
 
 #ifdef NAIADES_INCLUDE_DEBUG_TRAITS
@@ -139,6 +133,8 @@ template <> struct DebugTraits<naiades::spatial::MortonTree2> {
     auto m = DebugMessage();
     m.addTitle("Morton Tree");
     m.add("resolution", data.resolution_);
+    m.add("max level", data.max_level_);
+    m.add("leaves", data.z_indices_.size());
     return m;
   }
 };
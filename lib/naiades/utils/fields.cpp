@@ -33,20 +33,20 @@ namespace naiades::utils {
 void zalesakVelocityField(const geo::Grid2 &grid,
                           core::FieldRef<hermes::geo::vec2> &field,
                           const hermes::geo::point2 &center, f32 omega) {
-  for (auto ij : hermes::range2(grid.resolution(field.element()))) {
+  parallelFor(hermes::range2(grid.resolution(field.element())), [&](auto ij) {
     auto flat_ij = grid.safeFlatIndex(field.element(), ij);
     auto wp = grid.center(field.element(), ij);
     field[flat_ij] = zalesak(wp, center, omega);
-  }
+  });
 }
 
 void enrightVelocityField(const geo::Grid2 &grid,
                           core::FieldRef<hermes::geo::vec2> &field, f32 t) {
-  for (auto ij : hermes::range2(grid.resolution(field.element()))) {
+  parallelFor(hermes::range2(grid.resolution(field.element())), [&](auto ij) {
     auto flat_ij = grid.safeFlatIndex(field.element(), ij);
     auto wp = grid.center(field.element(), ij);
     field[flat_ij] = enright(wp, t);
-  }
+  });
 }
 
 } // namespace naiades::utils
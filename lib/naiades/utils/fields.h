@@ -27,19 +27,23 @@
 
 #pragma once
 
+#include <naiades/base/parallel.h>
 #include <naiades/core/field.h>
 #include <naiades/geo/grid.h>
 
 namespace naiades::utils {
 
+/// Sets field values from a function of element center positions.
+/// \note f is called concurrently.
 template <typename FieldType>
 void setField(const geo::Grid2 &grid, core::FieldRef<FieldType> &field,
               const std::function<FieldType(const hermes::geo::point2 &)> &f) {
-  for (h_size flat_index = 0; flat_index < field.size(); ++flat_index) {
-    auto position = grid.center(
-        field.element(), grid.elementIndexOffset(field.element()) + flat_index);
+  parallelFor(0, field.size(), [&](h_index flat_index) {
+    auto position = grid.center(core::ElementIndex::global(
+        field.element(),
+        grid.elementIndexOffset(field.element()) + flat_index));
     field[flat_index] = f(position);
-  }
+  });
 }
 
 /// Constant vorticity velocity field
@@ -178,8 +178,11 @@ public:
   }
   SVG &draw(const core::Mesh2 &mesh) {
     // edges
-    for (const auto &face : mesh.elements(core::Element::face())) {
-      auto vertices = mesh.indices(face.globalIndex(), core::Element::vertex());
+    const auto &face_vertices =
+        mesh.connectivity(core::Element::face(), core::Element::vertex());
+    for (h_index face_index = 0; face_index < face_vertices.size();
+         ++face_index) {
+      auto vertices = face_vertices[face_index];
       doc_ << link(mesh.center(core::ElementIndex::global(
                        core::Element::vertex(), vertices[0])),
                    mesh.center(core::ElementIndex::global(
@@ -263,19 +266,20 @@ public:
     auto palette = colors::palettes::batlow();
     // get min and max values
     auto value_range = values.valueRange();
-    h_index cell_index = 0;
     if (values.element().is(core::element_primitive_bits::cell)) {
       // cells
-      for (const auto &cell_vertices :
-           mesh.indices(core::Element::cell(), core::Element::vertex())) {
+      const auto &cell_vertices =
+          mesh.connectivity(core::Element::cell(), core::Element::vertex());
+      for (h_index cell_index = 0; cell_index < cell_vertices.size();
+           ++cell_index) {
         std::vector<hermes::geo::point2> positions;
-        for (auto vertex_index : cell_vertices)
+        for (auto vertex_index : cell_vertices[cell_index])
           positions.emplace_back(mesh.center(core::ElementIndex::global(
               core::Element::vertex(), vertex_index)));
         // compute color
         doc_ << cell(positions, palette(hermes::numeric::smoothStep(
                                     value_range.low, value_range.high,
-                                    values[cell_index++])));
+                                    values[cell_index])));
       }
     }
     return *this;
@@ -285,19 +289,20 @@ public:
     auto palette = colors::palettes::batlow();
     // get min and max values
     auto value_range = values.valueRange();
-    h_index cell_index = 0;
     if (loc.is(core::element_primitive_bits::cell)) {
       // cells
-      for (const auto &cell_vertices :
-           mesh.indices(core::Element::cell(), core::Element::vertex())) {
+      const auto &cell_vertices =
+          mesh.connectivity(core::Element::cell(), core::Element::vertex());
+      for (h_index cell_index = 0; cell_index < cell_vertices.size();
+           ++cell_index) {
         std::vector<hermes::geo::point2> positions;
-        for (auto vertex_index : cell_vertices)
+        for (auto vertex_index : cell_vertices[cell_index])
           positions.emplace_back(mesh.center(core::ElementIndex::global(
               core::Element::vertex(), vertex_index)));
         // compute color
         doc_ << cell(positions, palette(hermes::numeric::smoothStep(
                                     value_range.low, value_range.high,
-                                    values[cell_index++])));
+                                    values[cell_index])));
       }
     }
     return *this;
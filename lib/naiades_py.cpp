@@ -114,7 +114,8 @@ struct py_Mesh {
     mesh.vertex_centers =
         vector_pyarray(grid.positions(naiades::core::Element::VERTEX));
 
-    auto g_indices = grid.indices(element, naiades::core::Element::VERTEX);
+    const auto &g_indices =
+        grid.connectivity(element, naiades::core::Element::VERTEX);
     std::vector<u32> data(g_indices.size() * 4);
     std::vector<h_size> shape = {
         grid.elementCount(naiades::core::Element::CELL), 4};
@@ -211,8 +212,7 @@ struct StableFluids2_py {
     auto f = [](const naiades::geo::Grid2 &grid,
                 const naiades::core::FieldCRef<f32> &field,
                 const hermes::geo::point2 &p) -> f32 {
-      auto stencil =
-          naiades::sampling::Stencil::bilinear(grid, field.element(), p);
+      auto stencil = naiades::sampling::bilinear(grid, field.element(), p);
       return stencil.evaluate(field);
     };
 
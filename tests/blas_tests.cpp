@@ -26,6 +26,30 @@ TEST_CASE("blas", "[core]") {
     //   1e-8f));
     // }
   }
+  SECTION("expressions") {
+    FieldSet fields;
+    fields.add<f32>(Element::Type::CELL, 0, {"a"});
+    fields.setElementCount(Element::Type::CELL, 100);
+    auto a = *fields.get<f32>("a");
+    Scalar x(100), y(100);
+    for (h_size i = 0; i < x.size(); ++i) {
+      x[i] = i * 0.01f;
+      y[i] = 1.f - i * 0.01f;
+    }
+    a = 2.f * numeric::sin(x) * y + 1.f;
+    auto e = numeric::abs(a - x * y);
+    REQUIRE(e.size() == 100);
+    Scalar s = e;
+    s += numeric::sqr(x);
+    for (h_size i = 0; i < x.size(); ++i) {
+      f32 expected = 2.f * std::sin(x[i]) * y[i] + 1.f;
+      REQUIRE_THAT(a[i], Catch::Matchers::WithinAbs(expected, 1e-5));
+      expected = std::fabs(expected - x[i] * y[i]) + x[i] * x[i];
+      REQUIRE_THAT(s[i], Catch::Matchers::WithinAbs(expected, 1e-5));
+    }
+    s = s - s;
+    REQUIRE_THAT(numeric::sum(s), Catch::Matchers::WithinAbs(0, 1e-8));
+  }
 }
 
 struct SampleTestCaseParameters {
@@ -227,6 +227,71 @@ TEST_CASE("FieldGroup", "[core]") {
   HERMES_INFO("{}", hermes::to_string(field_group));
 }
 
+TEST_CASE("FieldGroup SoA", "[core]") {
+  FieldGroup field_group(FieldStorage::SOA);
+  REQUIRE(field_group.pushField<f32>("x") == 0);
+  REQUIRE(field_group.pushField<hermes::geo::vec2>("v") == 1);
+  REQUIRE(field_group.pushField<i32>("i") == 2);
+  REQUIRE(field_group.fieldCount() == 3);
+  REQUIRE(field_group.resize(37) == HeError::None);
+  REQUIRE(field_group.size() == 37);
+  auto x = field_group.get<f32>(0);
+  auto v = field_group.get<hermes::geo::vec2>(1);
+  auto k = field_group.get<i32>(2);
+  for (int i = 0; i < 37; ++i) {
+    x[i] = i * 0.5f;
+    v[i] = {i * 1.f, -i * 1.f};
+    k[i] = -i;
+  }
+  // each sub-field is an aligned contiguous array
+  for (auto ptr : {reinterpret_cast<uintptr_t>(x.data()),
+                   reinterpret_cast<uintptr_t>(v.data()),
+                   reinterpret_cast<uintptr_t>(k.data())})
+    REQUIRE(ptr % FieldGroup::soa_alignment == 0);
+  REQUIRE(x.contiguous());
+  REQUIRE(v.contiguous());
+  REQUIRE(k.contiguous());
+  // values survive resizing
+  REQUIRE(field_group.resize(50) == HeError::None);
+  const auto &c_field_group = field_group;
+  auto cx = c_field_group.get<f32>(0);
+  auto cv = c_field_group.get<hermes::geo::vec2>(1);
+  auto ck = c_field_group.get<i32>(2);
+  REQUIRE(cx.size() == 50);
+  for (int i = 0; i < 37; ++i) {
+    REQUIRE(cx[i] == i * 0.5f);
+    REQUIRE(cv[i].x == i * 1.f);
+    REQUIRE(cv[i].y == -i * 1.f);
+    REQUIRE(ck[i] == -i);
+  }
+  // copies keep their values and alignment, whatever their address
+  std::vector<FieldGroup> copies(16, field_group);
+  FieldGroup assigned(FieldStorage::SOA);
+  assigned = field_group;
+  copies.emplace_back(assigned);
+  for (const auto &copy : copies) {
+    for (h_size f = 0; f < 3; ++f)
+      REQUIRE(reinterpret_cast<uintptr_t>(copy.getPtr(f, 0)) %
+                  FieldGroup::soa_alignment ==
+              0);
+    auto x_copy = copy.get<f32>(0);
+    auto v_copy = copy.get<hermes::geo::vec2>(1);
+    auto k_copy = copy.get<i32>(2);
+    REQUIRE(x_copy.size() == 50);
+    for (h_size i = 0; i < 37; ++i) {
+      REQUIRE(x_copy[i] == cx[i]);
+      REQUIRE(v_copy[i].x == cv[i].x);
+      REQUIRE(v_copy[i].y == cv[i].y);
+      REQUIRE(k_copy[i] == ck[i]);
+    }
+  }
+  // copies own their values
+  FieldGroup copy = field_group;
+  copy.get<i32>(2)[0] = 100;
+  REQUIRE(ck[0] == 0);
+  REQUIRE(copy.get<i32>(2)[0] == 100);
+}
+
 TEST_CASE("FieldSet", "[core]") {
   FieldSet field_set;
   field_set.add<i32>(Element::Type::ANY, 0, {"i32"});
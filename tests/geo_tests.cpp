@@ -1,6 +1,13 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include <naiades/geo/grid.h>
+#include <naiades/geo/he.h>
+#include <naiades/geo/reorder.h>
+#include <naiades/spatial/morton_tree.h>
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
 
 using namespace naiades;
 using namespace naiades::geo;
@@ -419,3 +426,312 @@ TEST_CASE("half-edge 2", "[geo]") {
   HERMES_INFO("{}", hermes::math::radians2degrees(std::atan2(
                         hermes::geo::cross(v2, v4), hermes::geo::dot(v2, v4))));
 }
+
+TEST_CASE("connectivity", "[geo]") {
+  using core::Element;
+  SECTION("grid") {
+    auto grid = Grid2::Config()
+                    .setCellSize({1, 1})
+                    .setResolution({2, 2})
+                    .build()
+                    .value();
+    const auto &cell_vertices =
+        grid.connectivity(Element::cell(), Element::vertex());
+    REQUIRE(cell_vertices.size() == 4);
+    REQUIRE(cell_vertices.nnz() == 16);
+    auto c0 = cell_vertices[0];
+    REQUIRE(std::vector<h_size>(c0.begin(), c0.end()) ==
+            std::vector<h_size>{0, 1, 4, 3});
+    const auto &vertex_cells =
+        grid.connectivity(Element::vertex(), Element::cell());
+    REQUIRE(vertex_cells.size() == 9);
+    REQUIRE(vertex_cells[0].size() == 1);
+    REQUIRE(vertex_cells[4].size() == 4);
+    const auto &face_vertices =
+        grid.connectivity(Element::face(), Element::vertex());
+    REQUIRE(face_vertices.size() == grid.elementCount(Element::face()));
+    REQUIRE(face_vertices.nnz() == 2 * face_vertices.size());
+    const auto &face_cells =
+        grid.connectivity(Element::face(), Element::cell());
+    REQUIRE(face_cells.size() == grid.elementCount(Element::face()));
+    h_size interior_faces = 0;
+    for (h_index f = 0; f < face_cells.size(); ++f) {
+      REQUIRE(!face_cells[f].empty());
+      REQUIRE(face_cells[f].size() <= 2);
+      interior_faces += face_cells[f].size() == 2;
+    }
+    REQUIRE(interior_faces == 4);
+    const auto &cell_cells =
+        grid.connectivity(Element::cell(), Element::cell());
+    for (h_index c = 0; c < cell_cells.size(); ++c)
+      REQUIRE(cell_cells[c].size() == 2);
+    // tables are built once
+    REQUIRE(&cell_cells ==
+            &grid.connectivity(Element::cell(), Element::cell()));
+  }
+  SECTION("half-edge") {
+    HE2 he;
+    he.addVertex({0, 0});
+    he.addVertex({1, 0});
+    he.addVertex({1, 1});
+    he.addVertex({0, 1});
+    he.addCell({0, 1, 2});
+    REQUIRE(he.connectivity(Element::cell(), Element::cell())[0].empty());
+    // adding cells drops the cached tables
+    he.addCell({0, 2, 3});
+    const auto &cell_cells = he.connectivity(Element::cell(), Element::cell());
+    REQUIRE(cell_cells.size() == 2);
+    REQUIRE(cell_cells[0].size() == 1);
+    REQUIRE(cell_cells[0][0] == 1);
+    REQUIRE(he.connectivity(Element::vertex(), Element::cell())[2].size() == 2);
+    auto star = he.star(core::ElementIndex::global(Element::cell(), 0),
+                        Element::face());
+    REQUIRE(star.size() == 4);
+    REQUIRE(he.isBoundary(core::ElementIndex::global(Element::cell(), 1)));
+  }
+}
+
+TEST_CASE("half-edge 2 from arrays", "[geo]") {
+  using core::Element;
+  using core::ElementIndex;
+  SECTION("fan") {
+    // a center vertex shared by n triangles
+    const h_size n = 12;
+    std::vector<hermes::geo::point2> vertices = {{0, 0}};
+    std::vector<h_index> offsets = {0};
+    std::vector<h_index> cells;
+    for (h_index i = 0; i < n; ++i) {
+      auto angle = hermes::math::constants::two_pi * i / n;
+      vertices.emplace_back(std::cos(angle), std::sin(angle));
+      cells.insert(cells.end(), {0, 1 + i, 1 + (i + 1) % n});
+      offsets.emplace_back(cells.size());
+    }
+    auto he = HE2::fromArrays(vertices, offsets, cells);
+    REQUIRE(he);
+    REQUIRE(he->elementCount(Element::cell()) == n);
+    REQUIRE(he->elementCount(Element::face()) == 2 * n);
+    REQUIRE(he->elementCount(Element::vertex()) == n + 1);
+    REQUIRE(he->boundaryIndices(Element::face()).size() == n);
+    REQUIRE(!he->isBoundary(ElementIndex::global(Element::vertex(), 0)));
+    REQUIRE(he->isBoundary(ElementIndex::global(Element::vertex(), 1)));
+    REQUIRE(he->connectivity(Element::vertex(), Element::cell())[0].size() ==
+            n);
+    for (h_index c = 0; c < n; ++c) {
+      auto cell_vertices =
+          he->indices(ElementIndex::global(Element::cell(), c),
+                      Element::vertex());
+      REQUIRE(cell_vertices == std::vector<h_size>(cells.begin() + 3 * c,
+                                                   cells.begin() + 3 * c + 3));
+      // two neighbour cells and one boundary face
+      REQUIRE(he->star(ElementIndex::global(Element::cell(), c),
+                       Element::face())
+                  .size() == 4);
+    }
+    // meshes built from arrays can still be extended
+    auto v = he->addVertex({2, 0});
+    he->addCell({1, v, 2});
+    REQUIRE(he->elementCount(Element::cell()) == n + 1);
+    REQUIRE(he->elementCount(Element::face()) == 2 * n + 2);
+  }
+  SECTION("large") {
+    // a strip of m quads split in two triangles, with more cells, faces and
+    // half-edges than 2^20
+    const h_size m = 530000;
+    std::vector<hermes::geo::point2> vertices;
+    for (h_index j = 0; j < 2; ++j)
+      for (h_index i = 0; i <= m; ++i)
+        vertices.emplace_back(i, j);
+    std::vector<h_index> offsets = {0};
+    std::vector<h_index> cells;
+    for (h_index i = 0; i < m; ++i) {
+      cells.insert(cells.end(), {i, m + 2 + i, m + 1 + i});
+      offsets.emplace_back(cells.size());
+      cells.insert(cells.end(), {i, i + 1, m + 2 + i});
+      offsets.emplace_back(cells.size());
+    }
+    auto he = HE2::fromArrays(vertices, offsets, cells);
+    REQUIRE(he);
+    REQUIRE(he->elementCount(Element::cell()) > (1u << 20));
+    REQUIRE(he->boundaryIndices(Element::face()).size() == 2 * m + 2);
+    // every vertex is on the boundary and sees all of its cells
+    auto vertex_cells = he->connectivity(Element::vertex(), Element::cell());
+    std::vector<h_size> expected(vertices.size(), 3);
+    expected[0] = expected[2 * m + 1] = 2;
+    expected[m] = expected[m + 1] = 1;
+    bool valid = true;
+    for (h_index v = 0; v < vertices.size(); ++v)
+      valid = valid && vertex_cells[v].size() == expected[v] &&
+              he->isBoundary(ElementIndex::global(Element::vertex(), v));
+    REQUIRE(valid);
+  }
+  SECTION("invalid input") {
+    std::vector<hermes::geo::point2> vertices = {
+        {0, 0}, {1, 0}, {1, 1}, {0, 1}};
+    std::vector<h_index> offsets = {0, 3, 6};
+    REQUIRE(HE2::fromArrays(vertices, offsets,
+                            std::vector<h_index>{0, 1, 2, 0, 2, 3}));
+    // out of range vertex
+    REQUIRE(!HE2::fromArrays(vertices, offsets,
+                             std::vector<h_index>{0, 1, 2, 0, 2, 4}));
+    // inconsistent orientation
+    REQUIRE(!HE2::fromArrays(vertices, offsets,
+                             std::vector<h_index>{0, 1, 2, 2, 0, 3}));
+    // degenerate cell
+    REQUIRE(!HE2::fromArrays(vertices, std::vector<h_index>{0, 2},
+                             std::vector<h_index>{0, 1}));
+  }
+}
+
+TEST_CASE("reordering", "[geo]") {
+  using core::Element;
+  using core::ElementIndex;
+  SECTION("permutation") {
+    REQUIRE(!Permutation::fromOrder({0, 2, 2}));
+    REQUIRE(!Permutation::fromOrder({0, 3, 1}));
+    auto p = *Permutation::fromOrder({2, 0, 1});
+    REQUIRE(p.newIndex(2) == 0);
+    REQUIRE(p.oldIndex(0) == 2);
+    std::vector<int> values = {10, 11, 12}, moved(3), restored(3);
+    p.apply(values, moved);
+    REQUIRE(moved == std::vector<int>{12, 10, 11});
+    p.applyInverse(moved, restored);
+    REQUIRE(restored == values);
+    p.inverse().apply(moved, restored);
+    REQUIRE(restored == values);
+  }
+  SECTION("half-edge") {
+    // quad mesh with cells inserted in a scattered order
+    const h_size n = 8;
+    std::vector<hermes::geo::point2> vertices;
+    for (h_size j = 0; j <= n; ++j)
+      for (h_size i = 0; i <= n; ++i)
+        vertices.emplace_back(static_cast<f32>(i), static_cast<f32>(j));
+    std::vector<h_index> offsets = {0};
+    std::vector<h_index> cells;
+    for (h_size k = 0; k < n * n; ++k) {
+      h_index c = (k * 37) % (n * n);
+      h_index v = (c / n) * (n + 1) + c % n;
+      cells.insert(cells.end(), {v, v + 1, v + n + 2, v + n + 1});
+      offsets.emplace_back(cells.size());
+    }
+    auto bandwidth = [](const core::Mesh2 &mesh) {
+      const auto &cell_cells =
+          mesh.connectivity(Element::cell(), Element::cell());
+      h_size b = 0;
+      for (h_index c = 0; c < cell_cells.size(); ++c)
+        for (auto d : cell_cells[c])
+          b = std::max<h_size>(b, c > d ? c - d : d - c);
+      return b;
+    };
+
+    for (auto ordering :
+         {Ordering::RCM, Ordering::MORTON, Ordering::HILBERT}) {
+      auto he = *HE2::fromArrays(vertices, offsets, cells);
+      auto old_bandwidth = bandwidth(he);
+      auto old_centers = he.centers(Element::cell());
+      auto old_boundary = he.boundaryIndices(Element::face()).size();
+      auto p = computeOrdering(he, ordering);
+      REQUIRE(p.cells.size() == n * n);
+      REQUIRE(p.faces.size() == he.elementCount(Element::face()));
+      REQUIRE(p.vertices.size() == (n + 1) * (n + 1));
+      REQUIRE(he.renumber(p));
+      for (h_index c = 0; c < n * n; ++c) {
+        auto center = he.center(ElementIndex::global(Element::cell(), c));
+        auto old_center = old_centers[p.cells.oldIndex(c)];
+        REQUIRE(center.x == old_center.x);
+        REQUIRE(center.y == old_center.y);
+        // cell vertices keep their positions
+        for (auto v : he.indices(ElementIndex::global(Element::cell(), c),
+                                 Element::vertex())) {
+          auto position = he.center(ElementIndex::global(Element::vertex(), v));
+          REQUIRE(std::abs(position.x - center.x) == 0.5f);
+          REQUIRE(std::abs(position.y - center.y) == 0.5f);
+        }
+      }
+      REQUIRE(he.boundaryIndices(Element::face()).size() == old_boundary);
+      if (ordering == Ordering::RCM)
+        REQUIRE(bandwidth(he) < old_bandwidth);
+    }
+  }
+}
+
+TEST_CASE("grid layout", "[geo]") {
+  const hermes::size2 res(37, 21);
+  const h_size n = res.total();
+  auto row_major = GridLayout(res);
+  for (auto storage : {GridStorage::ROW_MAJOR, GridStorage::TILED,
+                       GridStorage::MORTON_TILED}) {
+    GridLayout layout(res, storage, 6);
+    REQUIRE(layout.tileSize() == 8);
+    REQUIRE(layout.size() == n);
+    // storage indices are a permutation of [0, n)
+    std::vector<bool> used(n, false);
+    for (i32 j = 0; j < static_cast<i32>(res.height); ++j)
+      for (i32 i = 0; i < static_cast<i32>(res.width); ++i) {
+        auto k = layout.flatIndex(i, j);
+        REQUIRE(k < n);
+        REQUIRE(!used[k]);
+        used[k] = true;
+        REQUIRE(layout.index(k) == hermes::index2(i, j));
+      }
+    // tiles are contiguous
+    if (storage != GridStorage::ROW_MAJOR) {
+      REQUIRE(layout.flatIndex(7, 0) == 7);
+      REQUIRE(layout.flatIndex(0, 1) == 8);
+      REQUIRE(layout.flatIndex(7, 7) == 63);
+    }
+    // forEach runs on worker threads, so results are checked afterwards
+    std::vector<std::atomic<h_size>> visits(n);
+    std::vector<hermes::index2> visited(n);
+    layout.forEach([&](h_index k, i32 i, i32 j) {
+      if (k >= n)
+        return;
+      ++visits[k];
+      visited[k] = hermes::index2(i, j);
+    });
+    for (h_size k = 0; k < n; ++k) {
+      REQUIRE(visits[k] == 1);
+      REQUIRE(layout.flatIndex(visited[k]) == k);
+    }
+    // values survive a round trip between layouts
+    std::vector<h_index> values(n), stored(n), restored(n);
+    std::iota(values.begin(), values.end(), 0);
+    relayout(row_major, values, layout, stored);
+    REQUIRE(stored[layout.flatIndex(5, 3)] == values[3 * res.width + 5]);
+    relayout(layout, stored, row_major, restored);
+    REQUIRE(restored == values);
+  }
+}
+
+TEST_CASE("morton tree 2", "[spatial]") {
+  SECTION("bounds") {
+    REQUIRE(spatial::MortonTree2::fromMaxLevel(MORTON_TREE_MAX_LEVEL));
+    REQUIRE(!spatial::MortonTree2::fromMaxLevel(MORTON_TREE_MAX_LEVEL + 1));
+    auto mt = *spatial::MortonTree2::fromResolution(100);
+    REQUIRE(mt.resolution() == 128);
+    REQUIRE(mt.maxLevel() == 7);
+  }
+  SECTION("refine") {
+    auto mt = *spatial::MortonTree2::fromMaxLevel(MORTON_TREE_MAX_LEVEL);
+    // refine towards the origin corner
+    std::atomic<h_size> tests = 0;
+    REQUIRE(mt.refine([&](const auto &data) -> bool {
+      ++tests;
+      return data.bounds.lower() == hermes::index2(0, 0);
+    }));
+    REQUIRE(mt.size() == 1 + 3 * MORTON_TREE_MAX_LEVEL);
+    // rejected leaves are not tested again and finest leaves are never tested
+    REQUIRE(tests == 1 + 4 * (MORTON_TREE_MAX_LEVEL - 1));
+    h_size area = 0;
+    h_index z_index = 0;
+    for (auto leaf : mt) {
+      REQUIRE(leaf.z_index >= z_index);
+      z_index = leaf.z_index;
+      area += leaf.bounds.area();
+    }
+    REQUIRE(area == mt.resolution() * mt.resolution());
+    auto leaf = *mt.begin();
+    REQUIRE(leaf.level == MORTON_TREE_MAX_LEVEL);
+    REQUIRE(leaf.bounds.area() == 1);
+  }
+}
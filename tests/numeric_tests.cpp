@@ -1,8 +1,20 @@
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
 
 #include <naiades/geo/grid.h>
+#include <naiades/numeric/discrete_expression.h>
 #include <naiades/numeric/discrete_operator.h>
+#include <naiades/numeric/fast_poisson.h>
+#include <naiades/numeric/fft.h>
+#include <naiades/numeric/linear_solvers.h>
+#include <naiades/numeric/matrix_free.h>
+#include <naiades/numeric/multigrid.h>
+#include <naiades/numeric/preconditioners.h>
+
+#include <algorithm>
+#include <limits>
+#include <numbers>
 
 using namespace naiades;
 using namespace naiades::numeric;
@@ -22,6 +34,187 @@ TEST_CASE("Discrete Operator", "[numeric]") {
     REQUIRE_THAT(op[2], Catch::Matchers::WithinAbs(2.0, 1e-8));
   }
 }
+
+TEST_CASE("Discrete Expression", "[numeric]") {
+  SECTION("CSR") {
+    DiscreteExpression de(core::DiscreteSymbol::cell("p"));
+    DiscreteOperator op0(0);
+    op0.add(1, 2.0);
+    op0.add(0, 1.0);
+    op0.setConstant(3.0);
+    de.addIndexEntry(0, std::move(op0));
+    DiscreteOperator op2(2);
+    op2.add(2, 4.0);
+    de.addIndexEntry(2, std::move(op2));
+    REQUIRE(de.size() == 3);
+    REQUIRE(de.nodeCount() == 4);
+    REQUIRE(de.rowOffsets()[3] == 4);
+    REQUIRE(de.columns()[0] == 0);
+    REQUIRE(de.columns()[1] == 1);
+    REQUIRE_THAT(de.constant(0), Catch::Matchers::WithinAbs(3.0, 1e-8));
+    // skipped rows hold the mono-stencil
+    REQUIRE(de.columns()[2] == 1);
+    REQUIRE_THAT(de.weights()[2], Catch::Matchers::WithinAbs(1.0, 1e-8));
+
+    auto sum = de + (-de) + DiscreteExpression(1.0);
+    REQUIRE(sum.size() == 3);
+    for (auto row : sum) {
+      REQUIRE_THAT(row.constant(), Catch::Matchers::WithinAbs(1.0, 1e-8));
+      for (auto w : row.weights())
+        REQUIRE_THAT(w, Catch::Matchers::WithinAbs(0.0, 1e-8));
+    }
+  }
+  SECTION("replace rows") {
+    DiscreteExpression de(core::DiscreteSymbol::cell("p"));
+    auto row = [](h_index index, h_size count, real_t weight) {
+      DiscreteOperator op(index);
+      for (h_size k = 0; k < count; ++k)
+        op.add(index + k, weight);
+      op.setConstant(weight);
+      return op;
+    };
+    for (h_index i = 0; i < 3; ++i)
+      de.addIndexEntry(i, row(i, 2, 1.0));
+    auto check = [&](const std::vector<h_size> &offsets,
+                     const std::vector<h_size> &columns,
+                     const std::vector<real_t> &weights) {
+      REQUIRE(std::ranges::equal(de.rowOffsets(), offsets));
+      REQUIRE(std::ranges::equal(de.columns(), columns));
+      REQUIRE(std::ranges::equal(de.weights(), weights));
+    };
+    // grow, shrink and keep the size of the middle row
+    de.addIndexEntry(1, row(1, 4, 2.0));
+    check({0, 2, 6, 8}, {0, 1, 1, 2, 3, 4, 2, 3}, {1, 1, 2, 2, 2, 2, 1, 1});
+    de.addIndexEntry(1, row(1, 1, 3.0));
+    check({0, 2, 3, 5}, {0, 1, 1, 2, 3}, {1, 1, 3, 1, 1});
+    de.addIndexEntry(1, row(1, 1, 4.0));
+    check({0, 2, 3, 5}, {0, 1, 1, 2, 3}, {1, 1, 4, 1, 1});
+    REQUIRE_THAT(de.constant(1), Catch::Matchers::WithinAbs(4.0, 1e-8));
+    // the last row has no following rows to shift
+    de.addIndexEntry(2, row(2, 3, 5.0));
+    check({0, 2, 3, 6}, {0, 1, 1, 2, 3, 4}, {1, 1, 4, 5, 5, 5});
+  }
+  SECTION("rows") {
+    DiscreteExpression de(core::DiscreteSymbol::cell("p"));
+    DiscreteOperator op1(1);
+    op1.add(0, -1.0);
+    op1.add(1, 2.0);
+    op1.setConstant(3.0);
+    de.addIndexEntry(1, std::move(op1));
+    auto stored = de[1];
+    REQUIRE(stored.centerIndex() == 1);
+    REQUIRE(stored.size() == 2);
+    REQUIRE(stored.columns()[1] == 1);
+    REQUIRE_THAT(stored.weights()[0], Catch::Matchers::WithinAbs(-1.0, 1e-8));
+    REQUIRE_THAT(stored.constant(), Catch::Matchers::WithinAbs(3.0, 1e-8));
+    // rows past the stored ones hold the mono-stencil
+    auto fallback = de[5];
+    auto copy = fallback;
+    REQUIRE(copy.size() == 1);
+    REQUIRE(copy.columns()[0] == 5);
+    REQUIRE_THAT(copy.weights()[0], Catch::Matchers::WithinAbs(1.0, 1e-8));
+    std::vector<real_t> field = {1, 2, 3, 4, 5, 6};
+    REQUIRE_THAT(stored(field), Catch::Matchers::WithinAbs(6.0, 1e-8));
+    REQUIRE_THAT(copy(field), Catch::Matchers::WithinAbs(6.0, 1e-8));
+    // constant expressions have no nodes
+    auto constant = DiscreteExpression(2.0)[3];
+    REQUIRE(constant.size() == 0);
+    REQUIRE_THAT(constant.constant(), Catch::Matchers::WithinAbs(2.0, 1e-8));
+  }
+}
+
+TEST_CASE("Multigrid", "[numeric]") {
+  // 5-point Laplacian with homogeneous Neumann boundaries
+  auto laplacian = [](h_size w, h_size h) {
+    DiscreteExpression de(core::DiscreteSymbol::cell("p"));
+    for (h_size j = 0; j < h; ++j)
+      for (h_size i = 0; i < w; ++i) {
+        h_size row = j * w + i;
+        DiscreteOperator op(row);
+        real_t center = 0;
+        auto neighbour = [&](bool exists, h_size index) {
+          if (exists) {
+            op.add(index, 1.0);
+            center -= 1.0;
+          }
+        };
+        neighbour(i > 0, row - 1);
+        neighbour(i + 1 < w, row + 1);
+        neighbour(j > 0, row - w);
+        neighbour(j + 1 < h, row + w);
+        op.add(row, center);
+        de.addIndexEntry(row, std::move(op));
+      }
+    return de;
+  };
+  SECTION("V-cycle") {
+    solvers::MultigridHierarchy mg;
+    REQUIRE(mg.build({33, 20}, laplacian(33, 20)));
+    REQUIRE(mg.levelCount() == 4);
+    REQUIRE(mg.isSingular());
+    auto &b = mg.rhs();
+    for (h_size i = 0; i < b.size(); ++i)
+      b[i] = static_cast<real_t>(i % 5) - 2;
+    mg.removeMean(b);
+    auto r0 = mg.residualNorm();
+    for (int i = 0; i < 10; ++i)
+      mg.vcycle();
+    REQUIRE(mg.residualNorm() < 1e-6 * r0);
+  }
+  SECTION("Poisson") {
+    auto fd = numeric::Grid2FD::Config()
+                  .setCellSize({0.1f, 0.1f})
+                  .setResolution({40, 28})
+                  .build()
+                  .value();
+    auto p = core::DiscreteSymbol::cell("p");
+    auto f = core::DiscreteSymbol::cell("f");
+    fd.addFields<f32>({p.symbol, f.symbol});
+    fd.addBoundary(p.boundary_symbol,
+                   fd.mesh().boundaryIndices(core::Element::face()));
+    fd.setBoundaryCondition(p.boundary_symbol, bc::Dirichlet::Ptr::shared(1));
+    REQUIRE(fd.resolveBoundaries());
+    auto lhs = -fd.L(p);
+    const h_size n = lhs.size();
+    std::vector<real_t> source(n), expected(n), solution(n);
+    for (h_size i = 0; i < n; ++i)
+      source[i] = std::cos(0.3 * i);
+    core::FieldCRef<real_t> f_field(source.data(), n);
+    core::FieldRef<real_t> expected_field(expected.data(), n);
+    core::FieldRef<real_t> p_field(solution.data(), n);
+    solvers::LDLT ldlt;
+    ldlt.setUnknown(p).build(lhs, f);
+    ldlt.solve(expected_field, {f_field});
+    solvers::CG jacobi;
+    jacobi.setUnknown(p).setTolerance(1e-6).build(lhs, f);
+    jacobi.solve(p_field, {f_field});
+
+    auto check = [&](const solvers::SolveReport &report) {
+      REQUIRE(report.converged);
+      REQUIRE(report.error <= 1e-6);
+      REQUIRE(report.iterations < jacobi.iterations() / 4);
+      for (h_size i = 0; i < n; ++i)
+        REQUIRE_THAT(solution[i],
+                     Catch::Matchers::WithinAbs(expected[i], 1e-3));
+    };
+    SECTION("solver") {
+      solvers::Multigrid mg;
+      mg.setGrid(fd.mesh()).setUnknown(p).setTolerance(1e-6).build(lhs, f);
+      REQUIRE(mg.hierarchy().levelCount() == 5);
+      REQUIRE_FALSE(mg.hierarchy().isSingular());
+      check(mg.solve(p_field, {f_field}));
+    }
+    SECTION("preconditioner") {
+      solvers::PCG<solvers::MultigridPreconditioner> cg;
+      cg.preconditioner().setGrid(fd.mesh());
+      cg.setUnknown(p).setTolerance(1e-6).build(lhs, f);
+      REQUIRE(cg.preconditionerName() == "multigrid");
+      check(cg.solve(p_field, {f_field}));
+      REQUIRE(cg.iterations() < 10);
+    }
+  }
+}
+
 TEST_CASE("Grid2FD", "[numeric]") {
   auto fd = numeric::Grid2FD::Config()
                 .setCellSize({0.1f, 0.2f})
@@ -104,3 +297,920 @@ TEST_CASE("Grid2FD", "[numeric]") {
   //  HERMES_WARN("{}", naiades::to_string(op));
   //}
 }
+
+TEST_CASE("Operator assembly", "[numeric]") {
+  // exposes the generic per-element assembly of SpatialDiscretization
+  struct GenericFD : Grid2FD {
+    explicit GenericFD(const Grid2FD &fd) : Grid2FD(fd) {}
+    using Grid2FD::assembleRows;
+    DiscreteExpression
+    genericDerivative(derivative_bits d,
+                      const core::DiscreteSymbol &sym) const {
+      return SpatialDiscretization::derivativeExpression(d, sym);
+    }
+    DiscreteExpression genericLaplacian(const core::DiscreteSymbol &sym) const {
+      return SpatialDiscretization::laplacianExpression(sym);
+    }
+  };
+  GenericFD fd(numeric::Grid2FD::Config()
+                   .setCellSize({0.1f, 0.2f})
+                   .setResolution({7, 5})
+                   .build()
+                   .value());
+  // Dirichlet on the sides, Neumann at the bottom and top
+  auto p = core::DiscreteSymbol::cell("p");
+  h_size sides = 0, caps = 0;
+  auto faces = [&](core::Element::Type a, core::Element::Type b) {
+    auto indices = fd.mesh().boundaryIndices(a);
+    auto more = fd.mesh().boundaryIndices(b);
+    indices.insert(indices.end(), more.begin(), more.end());
+    return indices;
+  };
+  fd.addBoundary(p.boundary_symbol,
+                 faces(core::Element::Type::LEFT_FACE,
+                       core::Element::Type::RIGHT_FACE),
+                 &sides);
+  fd.addBoundary(
+      p.boundary_symbol,
+      faces(core::Element::Type::DOWN_FACE, core::Element::Type::UP_FACE),
+      &caps);
+  fd.setBoundaryCondition(p.boundary_symbol, sides,
+                          bc::Dirichlet::Ptr::shared(3));
+  fd.setBoundaryCondition(p.boundary_symbol, caps,
+                          bc::Neumann::Ptr::shared());
+  // vertices take the generic (mesh queried) path
+  auto q = core::DiscreteSymbol::vertex("q");
+  fd.addBoundary(q.boundary_symbol,
+                 fd.mesh().boundaryIndices(q.boundary_symbol.loc));
+  fd.setBoundaryCondition(q.boundary_symbol, bc::Dirichlet::Ptr::shared(2));
+  REQUIRE(fd.resolveBoundaries());
+
+  // every row, boundary ring included, matches the per-element operator
+  auto check = [&](const core::DiscreteSymbol &sym,
+                   const DiscreteExpression &e, const auto &reference) {
+    const h_size n = fd.mesh().elementCount(sym.symbol.loc);
+    REQUIRE(e.size() == n);
+    for (h_size i = 0; i < n; ++i) {
+      const DiscreteOperator op = reference(i);
+      const auto row = e[i];
+      REQUIRE(row.centerIndex() == i);
+      REQUIRE(row.size() == op.size());
+      REQUIRE_THAT(row.constant(),
+                   Catch::Matchers::WithinAbs(op.constant(), 1e-6));
+      for (h_size k = 0; k < row.size(); ++k) {
+        REQUIRE(row.columns()[k] == op.nodes()[k].first);
+        REQUIRE_THAT(row.weights()[k],
+                     Catch::Matchers::WithinAbs(op.nodes()[k].second, 1e-6));
+      }
+    }
+  };
+  for (const auto &sym : {p, q}) {
+    CAPTURE(sym.symbol.name);
+    for (auto d : {derivative_bits::x, derivative_bits::y}) {
+      auto reference = [&](h_size i) { return fd.derivative(d, i, sym); };
+      check(sym, d == derivative_bits::x ? fd.dx(sym) : fd.dy(sym), reference);
+      check(sym, fd.genericDerivative(d, sym), reference);
+    }
+    auto reference = [&](h_size i) { return fd.laplacian(i, sym); };
+    check(sym, fd.L(sym), reference);
+    check(sym, fd.genericLaplacian(sym), reference);
+  }
+  // rows are built once per element
+  const h_size n = fd.mesh().elementCount(p.symbol.loc);
+  std::vector<h_size> calls(n, 0);
+  auto e = fd.assembleRows(p, [&](h_index i, DiscreteOperator &op) {
+    ++calls[i];
+    op.add(i, 1);
+  });
+  REQUIRE(e.size() == n);
+  REQUIRE(std::all_of(calls.begin(), calls.end(),
+                      [](h_size count) { return count == 1; }));
+}
+
+TEST_CASE("Matrix-free Laplacian", "[numeric]") {
+  auto fd = numeric::Grid2FD::Config()
+                .setCellSize({0.1f, 0.2f})
+                .setResolution({7, 5})
+                .build()
+                .value();
+  auto p = core::DiscreteSymbol::cell("p");
+  fd.addBoundary(p.boundary_symbol,
+                 fd.mesh().boundaryIndices(core::Element::face()));
+  fd.setBoundaryCondition(p.boundary_symbol, bc::Dirichlet::Ptr::shared(3));
+  REQUIRE(fd.resolveBoundaries());
+
+  auto L = fd.L(p);
+  auto M = Grid2Laplacian::Config()
+               .setDiscretization(fd)
+               .setSymbol(p)
+               .build()
+               .value();
+  REQUIRE(M.boundaryRowCount() == 20);
+
+  SECTION("apply") {
+    Eigen::VectorXd x(35);
+    for (int i = 0; i < 35; ++i)
+      x[i] = std::sin(0.7 * i);
+    Eigen::VectorXd y = M * x;
+    M.addConstants(y, 1.0);
+    for (auto row : L) {
+      real_t expected = row(x);
+      // rows are evaluated in single precision, the operator in double
+      real_t magnitude = std::abs(row.constant());
+      for (h_size k = 0; k < row.size(); ++k)
+        magnitude += std::abs(row.weights()[k] * x[row.columns()[k]]);
+      REQUIRE_THAT(y[row.centerIndex()],
+                   Catch::Matchers::WithinAbs(
+                       expected, 8 * std::numeric_limits<real_t>::epsilon() *
+                                     magnitude));
+    }
+  }
+  SECTION("solve") {
+    auto f = core::DiscreteSymbol::cell("f");
+    std::vector<real_t> source(35), solution(35), expected(35), check(35);
+    for (h_size i = 0; i < 35; ++i)
+      source[i] = std::cos(0.3 * i);
+    core::FieldCRef<real_t> f_field(source.data(), 35);
+    core::FieldRef<real_t> p_field(solution.data(), 35);
+    core::FieldRef<real_t> expected_field(expected.data(), 35);
+    core::FieldRef<real_t> check_field(check.data(), 35);
+
+    solvers::CG cg;
+    cg.setUnknown(p).setTolerance(1e-7).build(L, f);
+    REQUIRE(cg.solve(expected_field, {f_field}).converged);
+    solvers::MatrixFreeCG mf;
+    mf.setTolerance(1e-7).build(M);
+    mf.solve(p_field, {f_field});
+    for (h_size i = 0; i < 35; ++i)
+      REQUIRE_THAT(solution[i], Catch::Matchers::WithinAbs(expected[i], 1e-5));
+    // L(u) = f
+    M.evaluate(p_field, check_field);
+    for (h_size i = 0; i < 35; ++i)
+      REQUIRE_THAT(check[i], Catch::Matchers::WithinAbs(source[i], 1e-3));
+  }
+}
+
+TEST_CASE("Expression evaluation", "[numeric]") {
+  auto fd = numeric::Grid2FD::Config()
+                .setCellSize({0.1f, 0.2f})
+                .setResolution({20, 12})
+                .build()
+                .value();
+  auto p = core::DiscreteSymbol::cell("p");
+  fd.addBoundary(p.boundary_symbol,
+                 fd.mesh().boundaryIndices(core::Element::face()));
+  fd.setBoundaryCondition(p.boundary_symbol, bc::Dirichlet::Ptr::shared(3));
+  REQUIRE(fd.resolveBoundaries());
+  const h_size n = 20 * 12;
+
+  std::vector<real_t> in(n), out(n);
+  for (h_size i = 0; i < n; ++i)
+    in[i] = std::sin(0.7 * i);
+  core::FieldCRef<real_t> in_field(in.data(), n);
+  core::FieldRef<real_t> out_field(out.data(), n);
+
+  auto check = [&](const DiscreteExpression &e) {
+    e.apply(in_field, out_field);
+    for (h_size i = 0; i < n; ++i)
+      REQUIRE_THAT(out[i], Catch::Matchers::WithinAbs(e[i](in), 1e-3));
+    std::vector<real_t> previous = out;
+    e.axpy(-0.5f, in_field, out_field);
+    for (h_size i = 0; i < n; ++i)
+      REQUIRE_THAT(out[i], Catch::Matchers::WithinAbs(
+                               previous[i] - 0.5f * e[i](in), 1e-3));
+  };
+
+  SECTION("laplacian") { check(fd.L(p)); }
+  SECTION("combined") { check(-fd.L(p) + fd.dx(p) + DiscreteExpression(2)); }
+  SECTION("rows added one by one") {
+    DiscreteExpression e(p);
+    for (auto row : fd.dy(p)) {
+      if (row.centerIndex() == n / 2)
+        break;
+      DiscreteOperator op(row.centerIndex());
+      for (h_size k = 0; k < row.size(); ++k)
+        op.add(row.columns()[k], row.weights()[k]);
+      e.addIndexEntry(row.centerIndex(), std::move(op));
+    }
+    check(e);
+  }
+  SECTION("constant") { check(DiscreteExpression(4)); }
+}
+
+TEST_CASE("Stencil evaluation", "[numeric]") {
+  auto fd = numeric::Grid2FD::Config()
+                .setCellSize({0.1f, 0.2f})
+                .setResolution({20, 12})
+                .build()
+                .value();
+  // Dirichlet on the sides, Neumann at the bottom and top
+  auto p = core::DiscreteSymbol::cell("p");
+  h_size sides = 0, caps = 0;
+  auto faces = [&](core::Element::Type a, core::Element::Type b) {
+    auto indices = fd.mesh().boundaryIndices(a);
+    auto more = fd.mesh().boundaryIndices(b);
+    indices.insert(indices.end(), more.begin(), more.end());
+    return indices;
+  };
+  fd.addBoundary(p.boundary_symbol,
+                 faces(core::Element::Type::LEFT_FACE,
+                       core::Element::Type::RIGHT_FACE),
+                 &sides);
+  fd.addBoundary(
+      p.boundary_symbol,
+      faces(core::Element::Type::DOWN_FACE, core::Element::Type::UP_FACE),
+      &caps);
+  fd.setBoundaryCondition(p.boundary_symbol, sides,
+                          bc::Dirichlet::Ptr::shared(3));
+  fd.setBoundaryCondition(p.boundary_symbol, caps,
+                          bc::Neumann::Ptr::shared());
+  REQUIRE(fd.resolveBoundaries());
+  const h_size w = 20;
+  const h_size h = 12;
+  const h_size n = w * h;
+
+  std::vector<real_t> in(n), out(n), expected(n);
+  core::FieldCRef<real_t> in_field(in.data(), n);
+  core::FieldRef<real_t> out_field(out.data(), n);
+  core::FieldRef<real_t> expected_field(expected.data(), n);
+
+  // Reference second order differences. Values outside of the grid are ghost
+  // values given by the boundary stencil of the face they are seen through,
+  // ghosts past a corner are the average of both boundary neighbours.
+  using orientation = core::element_orientation_bits;
+  auto ghost = [&](i32 i, i32 j, orientation side) {
+    auto neighbour = fd.mesh().neighbour(core::Element::cell(), {i, j}, side,
+                                         core::Element::face());
+    const auto &stencil =
+        fd.boundary(p.boundary_symbol).stencil(neighbour.element_index.index);
+    real_t value = stencil.constant();
+    for (const auto &node : stencil.nodes())
+      value += node.second * in[node.first];
+    return value;
+  };
+  auto at = [&](i32 i, i32 j, i32 di, i32 dj) {
+    const i32 ti = i + di;
+    const i32 tj = j + dj;
+    const bool inside_x = ti >= 0 && ti < static_cast<i32>(w);
+    const bool inside_y = tj >= 0 && tj < static_cast<i32>(h);
+    const auto x_side = di < 0 ? orientation::left : orientation::right;
+    const auto y_side = dj < 0 ? orientation::down : orientation::up;
+    if (inside_x && inside_y)
+      return in[tj * w + ti];
+    if (inside_y)
+      return ghost(i, tj, x_side);
+    if (inside_x)
+      return ghost(ti, j, y_side);
+    return 0.5f * (ghost(i, j, x_side) + ghost(i, j, y_side));
+  };
+  const real_t hx = 0.1f;
+  const real_t hy = 0.2f;
+  using numeric::derivative_bits;
+  // x and y are first derivatives here, xx and yy second derivatives
+  auto evaluate = [&](derivative_bits d, u32 order) {
+    if (d == derivative_bits::x || d == derivative_bits::y)
+      return fd.evaluateFirstDerivative(d, p, in_field, out_field, order);
+    return fd.evaluateDerivative(d, p, in_field, out_field, order);
+  };
+  auto reference = [&](derivative_bits d, i32 i, i32 j) -> real_t {
+    switch (d) {
+    case derivative_bits::x:
+      return (at(i, j, 1, 0) - at(i, j, -1, 0)) / (2 * hx);
+    case derivative_bits::y:
+      return (at(i, j, 0, 1) - at(i, j, 0, -1)) / (2 * hy);
+    case derivative_bits::xx:
+      return (at(i, j, -1, 0) - 2 * at(i, j, 0, 0) + at(i, j, 1, 0)) /
+             (hx * hx);
+    case derivative_bits::yy:
+      return (at(i, j, 0, -1) - 2 * at(i, j, 0, 0) + at(i, j, 0, 1)) /
+             (hy * hy);
+    default:
+      return (at(i, j, 1, 1) - at(i, j, 1, -1) - at(i, j, -1, 1) +
+              at(i, j, -1, -1)) /
+             (4 * hx * hy);
+    }
+  };
+
+  SECTION("second order matches operators") {
+    for (h_size i = 0; i < n; ++i)
+      in[i] = std::sin(0.7 * i);
+    auto check = [&](const DiscreteExpression &e) {
+      e.apply(in_field, expected_field);
+      for (h_size i = 0; i < n; ++i)
+        REQUIRE_THAT(out[i], Catch::Matchers::WithinAbs(expected[i], 1e-2));
+    };
+    REQUIRE(fd.evaluateLaplacian(p, in_field, out_field));
+    check(fd.L(p));
+    for (auto d : {derivative_bits::x, derivative_bits::xx}) {
+      REQUIRE(fd.evaluateDerivative(d, p, in_field, out_field));
+      check(fd.dx(p));
+    }
+    for (auto d : {derivative_bits::y, derivative_bits::yy}) {
+      REQUIRE(fd.evaluateDerivative(d, p, in_field, out_field));
+      check(fd.dy(p));
+    }
+  }
+  SECTION("fourth order interior") {
+    // u = x^3 + 2y^3 + xy^2 is differentiated exactly
+    auto x = [](h_size i) { return (i + 0.5f) * 0.1f; };
+    auto y = [](h_size j) { return (j + 0.5f) * 0.2f; };
+    for (h_size j = 0; j < h; ++j)
+      for (h_size i = 0; i < w; ++i)
+        in[j * w + i] = x(i) * x(i) * x(i) + 2 * y(j) * y(j) * y(j) +
+                        x(i) * y(j) * y(j);
+    auto check = [&](auto &&f) {
+      for (h_size j = 2; j + 2 < h; ++j)
+        for (h_size i = 2; i + 2 < w; ++i)
+          REQUIRE_THAT(out[j * w + i],
+                       Catch::Matchers::WithinAbs(f(x(i), y(j)), 1e-2));
+    };
+    REQUIRE(evaluate(derivative_bits::x, 4));
+    check([](real_t x, real_t y) { return 3 * x * x + y * y; });
+    REQUIRE(evaluate(derivative_bits::y, 4));
+    check([](real_t x, real_t y) { return 6 * y * y + 2 * x * y; });
+    REQUIRE(fd.evaluateDerivative(derivative_bits::xx, p, in_field,
+                                  out_field, 4));
+    check([](real_t x, real_t) { return 6 * x; });
+    REQUIRE(fd.evaluateDerivative(derivative_bits::yy, p, in_field,
+                                  out_field, 4));
+    check([](real_t x, real_t y) { return 12 * y + 2 * x; });
+    REQUIRE(fd.evaluateDerivative(derivative_bits::xy, p, in_field,
+                                  out_field, 4));
+    check([](real_t, real_t y) { return 2 * y; });
+    REQUIRE(fd.evaluateLaplacian(p, in_field, out_field, 4));
+    check([](real_t x, real_t y) { return 8 * x + 12 * y; });
+  }
+  SECTION("second order matches boundary stencils") {
+    for (h_size i = 0; i < n; ++i)
+      in[i] = std::sin(0.7 * i);
+    for (auto d : {derivative_bits::x, derivative_bits::y, derivative_bits::xx,
+                   derivative_bits::yy, derivative_bits::xy}) {
+      REQUIRE(evaluate(d, 2));
+      for (i32 j = 0; j < static_cast<i32>(h); ++j)
+        for (i32 i = 0; i < static_cast<i32>(w); ++i)
+          REQUIRE_THAT(out[j * w + i], Catch::Matchers::WithinAbs(
+                                           reference(d, i, j), 1e-3));
+    }
+  }
+  SECTION("fourth order ring") {
+    // cells closer than 2 to the boundary use the second order stencils
+    for (h_size i = 0; i < n; ++i)
+      in[i] = std::sin(0.7 * i);
+    auto ring = [&](i32 i, i32 j) {
+      return i < 2 || j < 2 || i + 2 >= static_cast<i32>(w) ||
+             j + 2 >= static_cast<i32>(h);
+    };
+    for (auto d : {derivative_bits::x, derivative_bits::y, derivative_bits::xx,
+                   derivative_bits::yy, derivative_bits::xy}) {
+      REQUIRE(evaluate(d, 4));
+      for (i32 j = 0; j < static_cast<i32>(h); ++j)
+        for (i32 i = 0; i < static_cast<i32>(w); ++i)
+          if (ring(i, j))
+            REQUIRE_THAT(out[j * w + i], Catch::Matchers::WithinAbs(
+                                             reference(d, i, j), 1e-3));
+    }
+    REQUIRE(fd.evaluateLaplacian(p, in_field, out_field, 4));
+    for (i32 j = 0; j < static_cast<i32>(h); ++j)
+      for (i32 i = 0; i < static_cast<i32>(w); ++i)
+        if (ring(i, j))
+          REQUIRE_THAT(out[j * w + i],
+                       Catch::Matchers::WithinAbs(
+                           reference(derivative_bits::xx, i, j) +
+                               reference(derivative_bits::yy, i, j),
+                           1e-3));
+  }
+  SECTION("invalid input") {
+    REQUIRE_FALSE(fd.evaluateLaplacian(p, in_field, out_field, 3));
+    REQUIRE_FALSE(fd.evaluateDerivative(numeric::derivative_bits::z, p,
+                                        in_field, out_field));
+    REQUIRE_FALSE(fd.evaluateFirstDerivative(numeric::derivative_bits::xx, p,
+                                             in_field, out_field));
+    core::FieldRef<real_t> small(out.data(), n - 1);
+    REQUIRE_FALSE(fd.evaluateLaplacian(p, in_field, small));
+  }
+}
+
+TEST_CASE("Boundary stencil lookup", "[numeric]") {
+  auto fd = numeric::Grid2FD::Config()
+                .setCellSize(0.1f)
+                .setResolution({16, 10})
+                .build()
+                .value();
+  auto p = core::DiscreteSymbol::cell("p");
+  auto faces = fd.mesh().boundaryIndices(core::Element::face());
+  auto down = fd.mesh().boundaryIndices(core::Element::Type::DOWN_FACE);
+
+  auto check = [&]() {
+    REQUIRE(fd.resolveBoundaries());
+    const auto &boundary = fd.boundary(p.boundary_symbol);
+    for (auto face : faces) {
+      // the first region containing the face owns its stencil
+      const DiscreteOperator *expected = nullptr;
+      for (const auto &region : boundary.regions())
+        if (!expected && region.contains(core::Index::global(face)))
+          expected = &region.stencil(core::Index::global(face));
+      REQUIRE(expected);
+      REQUIRE(&boundary.stencil(core::Index::global(face)) == expected);
+    }
+  };
+
+  SECTION("many regions") {
+    // sparse face indices use the hashed lookup
+    for (h_size i = 0; i < faces.size(); i += 3) {
+      h_size region = 0;
+      fd.addBoundary(p.boundary_symbol,
+                     {faces.begin() + i,
+                      faces.begin() + std::min<h_size>(i + 3, faces.size())},
+                     &region);
+      fd.setBoundaryCondition(p.boundary_symbol, region,
+                              bc::Dirichlet::Ptr::shared(region));
+    }
+    check();
+    // interior faces are not boundary elements
+    auto x_faces = fd.mesh().resolution(core::Element::Type::X_FACE);
+    REQUIRE(fd.boundary(p.boundary_symbol)
+                .stencil(core::Index::global(x_faces.width + 1))
+                .size() == 0);
+  }
+  SECTION("overlapping regions") {
+    // contiguous face indices use the direct lookup
+    h_size region = 0;
+    fd.addBoundary(p.boundary_symbol, down, &region);
+    fd.setBoundaryCondition(p.boundary_symbol, region,
+                            bc::Dirichlet::Ptr::shared(1));
+    faces = down;
+    check();
+    fd.addBoundary(p.boundary_symbol,
+                   fd.mesh().boundaryIndices(core::Element::face()), &region);
+    fd.setBoundaryCondition(p.boundary_symbol, region,
+                            bc::Dirichlet::Ptr::shared(2));
+    faces = fd.mesh().boundaryIndices(core::Element::face());
+    check();
+  }
+}
+
+TEST_CASE("LDLT", "[numeric]") {
+  auto fd = numeric::Grid2FD::Config()
+                .setCellSize({0.1f, 0.1f})
+                .setResolution({9, 7})
+                .build()
+                .value();
+  auto p = core::DiscreteSymbol::cell("p");
+  auto f = core::DiscreteSymbol::cell("f");
+  fd.addFields<f32>({p.symbol, f.symbol});
+  fd.addBoundary(p.boundary_symbol,
+                 fd.mesh().boundaryIndices(core::Element::face()));
+  fd.setBoundaryCondition(p.boundary_symbol, bc::Dirichlet::Ptr::shared(1));
+  REQUIRE(fd.resolveBoundaries());
+
+  auto f_field = *fd.getField<f32>(f.symbol);
+  for (h_size i = 0; i < f_field.size(); ++i)
+    f_field[i] = std::cos(0.3 * i);
+  auto p_field = *fd.getField<f32>(p.symbol);
+
+  auto lhs = -fd.L(p);
+  solvers::LDLT ldlt;
+  ldlt.setUnknown(p).build(lhs, f);
+  REQUIRE(ldlt.factorNonZeros() > 0);
+  ldlt.solve(p_field, {f_field});
+  // the solution satisfies the implicit system
+  for (auto row : lhs) {
+    real_t value = 0;
+    for (h_size k = 0; k < row.columns().size(); ++k)
+      value += row.weights()[k] * p_field[row.columns()[k]];
+    value += row.constant();
+    REQUIRE_THAT(value,
+                 Catch::Matchers::WithinAbs(f_field[row.centerIndex()], 1e-3));
+  }
+
+  SECTION("numeric refactorization") {
+    // same pattern, scaled coefficients
+    auto nnz = ldlt.factorNonZeros();
+    ldlt.build(lhs + lhs, f);
+    REQUIRE(ldlt.factorNonZeros() == nnz);
+    ldlt.solve(p_field, {f_field});
+    solvers::CG cg;
+    cg.setUnknown(p).setTolerance(1e-8).build(lhs + lhs, f);
+    std::vector<real_t> second(p_field.begin(), p_field.end());
+    cg.solve(p_field, {f_field});
+    for (h_size i = 0; i < p_field.size(); ++i)
+      REQUIRE_THAT(second[i], Catch::Matchers::WithinAbs(p_field[i], 1e-3));
+  }
+}
+
+TEST_CASE("Batched solve", "[numeric]") {
+  auto fd = numeric::Grid2FD::Config()
+                .setCellSize({0.1f, 0.1f})
+                .setResolution({9, 7})
+                .build()
+                .value();
+  auto p = core::DiscreteSymbol::cell("p");
+  auto f = core::DiscreteSymbol::cell("f");
+  fd.addFields<f32>({p.symbol, f.symbol});
+  fd.addBoundary(p.boundary_symbol,
+                 fd.mesh().boundaryIndices(core::Element::face()));
+  fd.setBoundaryCondition(p.boundary_symbol, bc::Dirichlet::Ptr::shared(1));
+  REQUIRE(fd.resolveBoundaries());
+  auto lhs = -fd.L(p);
+  const h_size n = lhs.size();
+
+  // up to four columns use fixed width kernels
+  const h_size count = GENERATE(3, 6);
+  std::vector<std::vector<real_t>> sources(count, std::vector<real_t>(n));
+  std::vector<std::vector<real_t>> solutions(count, std::vector<real_t>(n));
+  std::vector<core::FieldCRef<real_t>> explicit_fields;
+  std::vector<core::FieldRef<real_t>> unknown_fields;
+  for (h_size k = 0; k < count; ++k) {
+    for (h_size i = 0; i < n; ++i)
+      sources[k][i] = std::cos(0.3 * i * (k + 1)) + k;
+    explicit_fields.emplace_back(sources[k].data(), n);
+    unknown_fields.emplace_back(solutions[k].data(), n);
+  }
+
+  auto check = [&](const auto &solver) {
+    solver.solve(unknown_fields, explicit_fields);
+    for (h_size k = 0; k < count; ++k) {
+      std::vector<real_t> single(n);
+      core::FieldRef<real_t> single_field(single.data(), n);
+      solver.solve(single_field, {explicit_fields[k]});
+      for (h_size i = 0; i < n; ++i)
+        REQUIRE_THAT(solutions[k][i],
+                     Catch::Matchers::WithinAbs(single[i], 1e-3));
+    }
+  };
+
+  SECTION("CG") {
+    solvers::CG cg;
+    cg.setUnknown(p).setTolerance(1e-8).build(lhs, f);
+    check(cg);
+  }
+  SECTION("PCG") {
+    solvers::PCG<Eigen::IdentityPreconditioner> cg;
+    cg.setUnknown(p).setTolerance(1e-8).build(lhs, f);
+    check(cg);
+  }
+  SECTION("LDLT") {
+    solvers::LDLT ldlt;
+    ldlt.setUnknown(p).build(lhs, f);
+    check(ldlt);
+  }
+}
+
+TEST_CASE("Solve report", "[numeric]") {
+  auto fd = numeric::Grid2FD::Config()
+                .setCellSize({0.1f, 0.1f})
+                .setResolution({16, 12})
+                .build()
+                .value();
+  auto p = core::DiscreteSymbol::cell("p");
+  auto f = core::DiscreteSymbol::cell("f");
+  fd.addFields<f32>({p.symbol, f.symbol});
+  fd.addBoundary(p.boundary_symbol,
+                 fd.mesh().boundaryIndices(core::Element::face()));
+  fd.setBoundaryCondition(p.boundary_symbol, bc::Dirichlet::Ptr::shared(1));
+  REQUIRE(fd.resolveBoundaries());
+  auto lhs = -fd.L(p);
+  const h_size n = lhs.size();
+
+  std::vector<real_t> source(n), solution(n);
+  for (h_size i = 0; i < n; ++i)
+    source[i] = std::cos(0.3 * i);
+  core::FieldCRef<real_t> f_field(source.data(), n);
+  core::FieldRef<real_t> p_field(solution.data(), n);
+
+  solvers::CG cg;
+  cg.setUnknown(p).setTolerance(1e-5).build(lhs, f);
+  auto report = cg.solve(p_field, {f_field});
+  REQUIRE(report.converged);
+  REQUIRE(report.iterations > 0);
+  REQUIRE(report.residual_history.size() == report.iterations);
+  REQUIRE(report.residual_history.back() == report.residual);
+  REQUIRE(report.error <= 1e-5);
+  REQUIRE(report.solve_time > 0);
+
+  SECTION("warm start") {
+    // a slightly different system, as in the next time step
+    for (auto &value : source)
+      value *= 1.01f;
+    std::vector<real_t> cold(n);
+    core::FieldRef<real_t> cold_field(cold.data(), n);
+    auto cold_report = cg.solve(cold_field, {f_field});
+    auto warm_report = cg.setWarmStart(true).solve(p_field, {f_field});
+    REQUIRE(warm_report.converged);
+    REQUIRE(warm_report.initial_residual < cold_report.initial_residual);
+    REQUIRE(warm_report.iterations < cold_report.iterations);
+    for (h_size i = 0; i < n; ++i)
+      REQUIRE_THAT(solution[i], Catch::Matchers::WithinAbs(cold[i], 1e-3));
+  }
+  SECTION("absolute tolerance") {
+    solvers::SolverOptions options;
+    options.tolerance = 0;
+    options.absolute_tolerance = 0.5f * report.initial_residual;
+    report = cg.setOptions(options).solve(p_field, {f_field});
+    REQUIRE(report.converged);
+    REQUIRE(report.residual <= options.absolute_tolerance);
+  }
+  SECTION("iteration limit") {
+    report = cg.setMaxIterations(2).solve(p_field, {f_field});
+    REQUIRE_FALSE(report.converged);
+    REQUIRE(report.iterations == 2);
+  }
+  SECTION("direct") {
+    solvers::LDLT ldlt;
+    ldlt.setUnknown(p).build(lhs, f);
+    report = ldlt.solve(p_field, {f_field});
+    REQUIRE(report.converged);
+    REQUIRE(report.iterations == 0);
+    REQUIRE(report.error <= 1e-5);
+  }
+}
+
+TEST_CASE("Solver options", "[numeric]") {
+  // same resolution and boundaries, so both systems share their pattern
+  auto poisson = [](const hermes::geo::vec2 &cell_size) {
+    auto fd = numeric::Grid2FD::Config()
+                  .setCellSize(cell_size)
+                  .setResolution({16, 12})
+                  .build()
+                  .value();
+    auto p = core::DiscreteSymbol::cell("p");
+    fd.addBoundary(p.boundary_symbol,
+                   fd.mesh().boundaryIndices(core::Element::face()));
+    fd.setBoundaryCondition(p.boundary_symbol, bc::Dirichlet::Ptr::shared(1));
+    REQUIRE(fd.resolveBoundaries());
+    return -fd.L(p);
+  };
+  auto p = core::DiscreteSymbol::cell("p");
+  auto f = core::DiscreteSymbol::cell("f");
+  auto lhs = poisson({0.1f, 0.1f});
+  auto other_lhs = poisson({0.1f, 0.3f});
+  const h_size n = lhs.size();
+
+  std::vector<real_t> source(n), solution(n), expected(n);
+  for (h_size i = 0; i < n; ++i)
+    source[i] = std::cos(0.3 * i);
+  core::FieldCRef<real_t> f_field(source.data(), n);
+  core::FieldRef<real_t> p_field(solution.data(), n);
+  core::FieldRef<real_t> expected_field(expected.data(), n);
+
+  SECTION("options reach the solver") {
+    solvers::CG cg;
+    cg.setUnknown(p).setTolerance(1e-8).build(lhs, f);
+    auto tight = cg.solve(p_field, {f_field});
+    REQUIRE(tight.converged);
+    REQUIRE(tight.error <= 1e-8);
+
+    solvers::SolverOptions options;
+    options.tolerance = 1e-2;
+    cg.setOptions(options);
+    REQUIRE(cg.options().tolerance == options.tolerance);
+    auto loose = cg.solve(p_field, {f_field});
+    REQUIRE(loose.converged);
+    REQUIRE(loose.error <= 1e-2);
+    REQUIRE(loose.error > tight.error);
+    REQUIRE(loose.iterations < tight.iterations);
+
+    cg.setTolerance(1e-8).setMaxIterations(3);
+    REQUIRE(cg.options().max_iterations == 3);
+    auto limited = cg.solve(p_field, {f_field});
+    REQUIRE_FALSE(limited.converged);
+    REQUIRE(limited.iterations == 3);
+  }
+  SECTION("kept pattern") {
+    // refilling the values of a kept pattern solves the new system exactly
+    // as a fresh build does
+    auto check = [&](auto &kept, auto &fresh) {
+      kept.setUnknown(p).setTolerance(1e-8).setKeepPattern(true);
+      kept.build(lhs, f).solve(p_field, {f_field});
+      kept.build(other_lhs, f);
+      auto report = kept.solve(p_field, {f_field});
+      fresh.setUnknown(p).setTolerance(1e-8).build(other_lhs, f);
+      auto expected_report = fresh.solve(expected_field, {f_field});
+      REQUIRE(report.converged);
+      REQUIRE(report.iterations == expected_report.iterations);
+      for (h_size i = 0; i < n; ++i)
+        REQUIRE_THAT(solution[i],
+                     Catch::Matchers::WithinAbs(expected[i], 1e-5));
+    };
+    SECTION("cg") {
+      solvers::CG kept, fresh;
+      check(kept, fresh);
+    }
+    SECTION("ic0") {
+      solvers::ICCG kept, fresh;
+      check(kept, fresh);
+    }
+  }
+}
+
+TEST_CASE("Preconditioners", "[numeric]") {
+  // strongly anisotropic cells
+  const u32 width = 24;
+  auto fd = numeric::Grid2FD::Config()
+                .setCellSize({0.01f, 0.1f})
+                .setResolution({width, 16})
+                .build()
+                .value();
+  auto p = core::DiscreteSymbol::cell("p");
+  auto f = core::DiscreteSymbol::cell("f");
+  fd.addFields<f32>({p.symbol, f.symbol});
+  fd.addBoundary(p.boundary_symbol,
+                 fd.mesh().boundaryIndices(core::Element::face()));
+  fd.setBoundaryCondition(p.boundary_symbol, bc::Dirichlet::Ptr::shared(1));
+  REQUIRE(fd.resolveBoundaries());
+  auto lhs = -fd.L(p);
+  const h_size n = lhs.size();
+
+  std::vector<real_t> source(n), expected(n), solution(n);
+  for (h_size i = 0; i < n; ++i)
+    source[i] = std::cos(0.3 * i);
+  core::FieldCRef<real_t> f_field(source.data(), n);
+  core::FieldRef<real_t> expected_field(expected.data(), n);
+  core::FieldRef<real_t> p_field(solution.data(), n);
+  solvers::LDLT ldlt;
+  ldlt.setUnknown(p).build(lhs, f);
+  ldlt.solve(expected_field, {f_field});
+
+  solvers::CG jacobi;
+  jacobi.setUnknown(p).setTolerance(1e-8).build(lhs, f);
+  jacobi.solve(p_field, {f_field});
+  REQUIRE(jacobi.preconditionerName() == "jacobi");
+
+  auto check = [&](auto &cg, std::string_view name) {
+    cg.setUnknown(p).setTolerance(1e-8).build(lhs, f);
+    cg.solve(p_field, {f_field});
+    REQUIRE(cg.preconditionerName() == name);
+    REQUIRE(cg.iterations() < jacobi.iterations());
+    REQUIRE(cg.error() <= 1e-8);
+    for (h_size i = 0; i < n; ++i)
+      REQUIRE_THAT(solution[i], Catch::Matchers::WithinAbs(expected[i], 1e-3));
+  };
+
+  SECTION("level schedule") {
+    solvers::SparseMatrix A;
+    solvers::assemble(lhs, A, false);
+    solvers::LevelSchedule schedule;
+    schedule.build({A.outerIndexPtr(), n + 1},
+                   {A.innerIndexPtr(), static_cast<h_size>(A.nonZeros())},
+                   true);
+    // anti-diagonals of the grid
+    REQUIRE(schedule.levelCount() == width + 16 - 1);
+    REQUIRE(schedule.level(0).size() == 1);
+    REQUIRE(schedule.level(1).size() == 2);
+  }
+  SECTION("ic0") {
+    solvers::ICCG cg;
+    check(cg, "ic0");
+    const auto iterations = cg.iterations();
+    // same factorization, level-scheduled sweeps
+    cg.preconditioner().setParallel(true);
+    check(cg, "ic0");
+    REQUIRE(cg.iterations() == iterations);
+  }
+  SECTION("ssor") {
+    solvers::SSORCG cg;
+    cg.preconditioner().setRelaxation(1.5).setParallel(true);
+    check(cg, "ssor");
+  }
+  SECTION("block jacobi") {
+    solvers::BlockJacobiCG cg;
+    // one block per grid line
+    cg.preconditioner().setBlockSize(width);
+    check(cg, "block-jacobi");
+  }
+}
+
+TEST_CASE("FFT", "[numeric]") {
+  for (h_size n : {1, 8, 12, 17}) {
+    FFT fft(n);
+    std::vector<FFT::Complex> x(n), y(n);
+    for (h_size m = 0; m < n; ++m)
+      x[m] = y[m] = {std::sin(1.3 * m + 0.2), std::cos(0.7 * m * m)};
+    fft.forward(y.data());
+    for (h_size k = 0; k < n; ++k) {
+      FFT::Complex expected = 0;
+      for (h_size m = 0; m < n; ++m)
+        expected +=
+            x[m] * std::polar(1.0, -2 * std::numbers::pi * (k * m % n) / n);
+      REQUIRE_THAT(std::abs(y[k] - expected),
+                   Catch::Matchers::WithinAbs(0, 1e-10));
+    }
+    fft.inverse(y.data());
+    for (h_size m = 0; m < n; ++m)
+      REQUIRE_THAT(std::abs(y[m] / static_cast<double>(n) - x[m]),
+                   Catch::Matchers::WithinAbs(0, 1e-12));
+  }
+}
+
+TEST_CASE("Fast Poisson", "[numeric]") {
+  using Condition = solvers::FastPoisson::Condition;
+  auto fd = numeric::Grid2FD::Config()
+                .setCellSize({0.1f, 0.2f})
+                .setResolution({12, 7})
+                .build()
+                .value();
+  auto p = core::DiscreteSymbol::cell("p");
+  auto f = core::DiscreteSymbol::cell("f");
+  fd.addFields<f32>({p.symbol, f.symbol});
+  auto f_field = *fd.getField<f32>(f.symbol);
+  auto p_field = *fd.getField<f32>(p.symbol);
+  // zero mean source, compatible with pure Neumann conditions
+  for (h_size i = 0; i < f_field.size(); ++i)
+    f_field[i] = std::cos(0.3 * i) + std::sin(1.1 * i);
+  real_t mean = 0;
+  for (h_size i = 0; i < f_field.size(); ++i)
+    mean += f_field[i];
+  mean /= f_field.size();
+  for (h_size i = 0; i < f_field.size(); ++i)
+    f_field[i] -= mean;
+
+  auto dirichlet = bc::Dirichlet::Ptr::shared(2);
+  auto neumann = bc::Neumann::Ptr::shared();
+  const core::Element::Type sides[4] = {
+      core::Element::Type::LEFT_FACE, core::Element::Type::RIGHT_FACE,
+      core::Element::Type::DOWN_FACE, core::Element::Type::UP_FACE};
+  auto setConditions = [&](std::array<bc::BoundaryCondition::Ptr, 4> bcs) {
+    fd.boundary(p.boundary_symbol) = Boundary();
+    for (h_size s = 0; s < 4; ++s) {
+      h_size region = 0;
+      fd.addBoundary(p.boundary_symbol, fd.mesh().boundaryIndices(sides[s]),
+                     &region);
+      fd.setBoundaryCondition(p.boundary_symbol, region, bcs[s]);
+    }
+    REQUIRE(fd.resolveBoundaries());
+  };
+  auto checkSolution = [&]() {
+    auto lhs = fd.L(p);
+    for (auto row : lhs) {
+      real_t value = row.constant();
+      for (h_size k = 0; k < row.columns().size(); ++k)
+        value += row.weights()[k] * p_field[row.columns()[k]];
+      REQUIRE_THAT(value, Catch::Matchers::WithinAbs(
+                              f_field[row.centerIndex()], 1e-3));
+    }
+  };
+
+  SECTION("dirichlet") {
+    setConditions({dirichlet, dirichlet, dirichlet, dirichlet});
+    auto poisson = solvers::FastPoisson::Config()
+                       .setDiscretization(fd)
+                       .setSymbol(p)
+                       .build();
+    REQUIRE(poisson);
+    REQUIRE(poisson->condition(core::Element::Type::UP_FACE) ==
+            Condition::DIRICHLET);
+    poisson->solve(p_field, {f_field});
+    checkSolution();
+  }
+  SECTION("neumann") {
+    setConditions({neumann, neumann, neumann, neumann});
+    auto poisson = solvers::FastPoisson::Config()
+                       .setDiscretization(fd)
+                       .setSymbol(p)
+                       .build();
+    REQUIRE(poisson);
+    poisson->solve(p_field, {f_field});
+    checkSolution();
+  }
+  SECTION("mixed") {
+    setConditions({dirichlet, neumann, neumann, dirichlet});
+    auto poisson = solvers::FastPoisson::Config()
+                       .setDiscretization(fd)
+                       .setSymbol(p)
+                       .build();
+    REQUIRE(poisson);
+    REQUIRE(poisson->condition(core::Element::Type::LEFT_FACE) ==
+            Condition::DIRICHLET);
+    REQUIRE(poisson->condition(core::Element::Type::RIGHT_FACE) ==
+            Condition::NEUMANN);
+    poisson->solve(p_field, {f_field});
+    checkSolution();
+    setConditions({neumann, dirichlet, dirichlet, neumann});
+    poisson = solvers::FastPoisson::Config()
+                  .setDiscretization(fd)
+                  .setSymbol(p)
+                  .build();
+    REQUIRE(poisson);
+    poisson->solve(p_field, {f_field});
+    checkSolution();
+  }
+  SECTION("unsupported") {
+    fd.boundary(p.boundary_symbol) = Boundary();
+    h_size region = 0;
+    auto left = fd.mesh().boundaryIndices(core::Element::Type::LEFT_FACE);
+    fd.addBoundary(p.boundary_symbol, {left.begin(), left.begin() + 3},
+                   &region);
+    fd.setBoundaryCondition(p.boundary_symbol, region, neumann);
+    std::vector<h_size> rest(left.begin() + 3, left.end());
+    for (auto side : {sides[1], sides[2], sides[3]})
+      for (auto face : fd.mesh().boundaryIndices(side))
+        rest.emplace_back(face);
+    fd.addBoundary(p.boundary_symbol, rest, &region);
+    fd.setBoundaryCondition(p.boundary_symbol, region, dirichlet);
+    REQUIRE(fd.resolveBoundaries());
+    REQUIRE(!solvers::FastPoisson::Config()
+                 .setDiscretization(fd)
+                 .setSymbol(p)
+                 .build());
+  }
+}
@@ -6,8 +6,6 @@
 #include <naiades/sampling/stencil.h>
 #include <naiades/utils/fields.h>
 
-#include <hermes/sampling/sampling.h>
-
 using namespace naiades;
 using namespace naiades::sampling;
 
@@ -35,43 +33,43 @@ TEST_CASE("stencil", "[sampling]") {
      *   s0      s1       s2      s3
      */
     { // s0
-      auto s = Stencil::bilinear(grid, core::Element::Type::VERTEX,
-                                 hermes::geo::point2(-1, -1));
+      auto s = bilinear(grid, core::Element::Type::VERTEX,
+                        hermes::geo::point2(-1, -1));
 
       REQUIRE(s.indices()[0] == 0);
       REQUIRE(s.size() == 1);
     }
     { // s1
-      auto s = Stencil::bilinear(grid, core::Element::Type::VERTEX,
-                                 hermes::geo::point2(0.1, -1));
+      auto s = bilinear(grid, core::Element::Type::VERTEX,
+                        hermes::geo::point2(0.1, -1));
       REQUIRE(s.size() == 2);
       REQUIRE(s.indices()[0] == 0);
       REQUIRE(s.indices()[1] == 1);
     }
     { // s2
-      auto s = Stencil::bilinear(grid, core::Element::Type::VERTEX,
-                                 hermes::geo::point2(0.3, -1));
+      auto s = bilinear(grid, core::Element::Type::VERTEX,
+                        hermes::geo::point2(0.3, -1));
 
       REQUIRE(s.size() == 2);
       REQUIRE(s.indices()[0] == 1);
       REQUIRE(s.indices()[1] == 2);
     }
     { // s3
-      auto s = Stencil::bilinear(grid, core::Element::Type::VERTEX,
-                                 hermes::geo::point2(1, -1));
+      auto s = bilinear(grid, core::Element::Type::VERTEX,
+                        hermes::geo::point2(1, -1));
       REQUIRE(s.size() == 1);
       REQUIRE(s.indices()[0] == 2);
     }
     { // s4
-      auto s = Stencil::bilinear(grid, core::Element::Type::VERTEX,
-                                 hermes::geo::point2(-1, 0.05));
+      auto s = bilinear(grid, core::Element::Type::VERTEX,
+                        hermes::geo::point2(-1, 0.05));
       REQUIRE(s.size() == 2);
       REQUIRE(s.indices()[0] == 0);
       REQUIRE(s.indices()[1] == 3);
     }
     { // s5
-      auto s = Stencil::bilinear(grid, core::Element::Type::VERTEX,
-                                 hermes::geo::point2(0.1, 0.05));
+      auto s = bilinear(grid, core::Element::Type::VERTEX,
+                        hermes::geo::point2(0.1, 0.05));
       REQUIRE(s.size() == 4);
       REQUIRE(s.indices()[0] == 0);
       REQUIRE(s.indices()[1] == 3);
@@ -79,8 +77,8 @@ TEST_CASE("stencil", "[sampling]") {
       REQUIRE(s.indices()[3] == 4);
     }
     { // s6
-      auto s = Stencil::bilinear(grid, core::Element::Type::VERTEX,
-                                 hermes::geo::point2(0.3, 0.05));
+      auto s = bilinear(grid, core::Element::Type::VERTEX,
+                        hermes::geo::point2(0.3, 0.05));
       REQUIRE(s.size() == 4);
       REQUIRE(s.indices()[0] == 1);
       REQUIRE(s.indices()[1] == 4);
@@ -88,22 +86,22 @@ TEST_CASE("stencil", "[sampling]") {
       REQUIRE(s.indices()[3] == 5);
     }
     { // s7
-      auto s = Stencil::bilinear(grid, core::Element::Type::VERTEX,
-                                 hermes::geo::point2(1.0, 0.05));
+      auto s = bilinear(grid, core::Element::Type::VERTEX,
+                        hermes::geo::point2(1.0, 0.05));
       REQUIRE(s.size() == 2);
       REQUIRE(s.indices()[0] == 2);
       REQUIRE(s.indices()[1] == 5);
     }
     { // s8
-      auto s = Stencil::bilinear(grid, core::Element::Type::VERTEX,
-                                 hermes::geo::point2(-1, 0.15));
+      auto s = bilinear(grid, core::Element::Type::VERTEX,
+                        hermes::geo::point2(-1, 0.15));
       REQUIRE(s.size() == 2);
       REQUIRE(s.indices()[0] == 3);
       REQUIRE(s.indices()[1] == 6);
     }
     { // s9
-      auto s = Stencil::bilinear(grid, core::Element::Type::VERTEX,
-                                 hermes::geo::point2(0.1, 0.15));
+      auto s = bilinear(grid, core::Element::Type::VERTEX,
+                        hermes::geo::point2(0.1, 0.15));
       REQUIRE(s.size() == 4);
       REQUIRE(s.indices()[0] == 3);
       REQUIRE(s.indices()[1] == 6);
@@ -111,8 +109,8 @@ TEST_CASE("stencil", "[sampling]") {
       REQUIRE(s.indices()[3] == 7);
     }
     { // s10
-      auto s = Stencil::bilinear(grid, core::Element::Type::VERTEX,
-                                 hermes::geo::point2(0.3, 0.15));
+      auto s = bilinear(grid, core::Element::Type::VERTEX,
+                        hermes::geo::point2(0.3, 0.15));
       REQUIRE(s.size() == 4);
       REQUIRE(s.indices()[0] == 4);
       REQUIRE(s.indices()[1] == 7);
@@ -120,41 +118,81 @@ TEST_CASE("stencil", "[sampling]") {
       REQUIRE(s.indices()[3] == 8);
     }
     { // s11
-      auto s = Stencil::bilinear(grid, core::Element::Type::VERTEX,
-                                 hermes::geo::point2(1.0, 0.15));
+      auto s = bilinear(grid, core::Element::Type::VERTEX,
+                        hermes::geo::point2(1.0, 0.15));
       REQUIRE(s.size() == 2);
       REQUIRE(s.indices()[0] == 5);
       REQUIRE(s.indices()[1] == 8);
     }
     { // s12
-      auto s = Stencil::bilinear(grid, core::Element::Type::VERTEX,
-                                 hermes::geo::point2(-1, 1));
+      auto s = bilinear(grid, core::Element::Type::VERTEX,
+                        hermes::geo::point2(-1, 1));
 
       REQUIRE(s.size() == 1);
       REQUIRE(s.indices()[0] == 6);
     }
     { // s13
-      auto s = Stencil::bilinear(grid, core::Element::Type::VERTEX,
-                                 hermes::geo::point2(0.1, 1));
+      auto s = bilinear(grid, core::Element::Type::VERTEX,
+                        hermes::geo::point2(0.1, 1));
       REQUIRE(s.size() == 2);
       REQUIRE(s.indices()[0] == 6);
       REQUIRE(s.indices()[1] == 7);
     }
     { // s14
-      auto s = Stencil::bilinear(grid, core::Element::Type::VERTEX,
-                                 hermes::geo::point2(0.3, 1));
+      auto s = bilinear(grid, core::Element::Type::VERTEX,
+                        hermes::geo::point2(0.3, 1));
 
       REQUIRE(s.size() == 2);
       REQUIRE(s.indices()[0] == 7);
       REQUIRE(s.indices()[1] == 8);
     }
     { // s15
-      auto s = Stencil::bilinear(grid, core::Element::Type::VERTEX,
-                                 hermes::geo::point2(1, 1));
+      auto s = bilinear(grid, core::Element::Type::VERTEX,
+                        hermes::geo::point2(1, 1));
       REQUIRE(s.size() == 1);
       REQUIRE(s.indices()[0] == 8);
     }
   }
+  SECTION("batched bilinear") {
+    std::vector<f32> xs = {-1.f, 0.1f, 0.3f, 1.f, 0.1f, 0.37f};
+    std::vector<f32> ys = {-1.f, 0.05f, 0.05f, 0.15f, 1.f, 0.12f};
+    BilinearStencils stencils;
+    bilinear(grid, core::Element::Type::VERTEX, xs, ys, stencils);
+    REQUIRE(stencils.size() == xs.size());
+    for (h_size i = 0; i < xs.size(); ++i) {
+      auto s = bilinear(grid, core::Element::Type::VERTEX,
+                        hermes::geo::point2(xs[i], ys[i]));
+      // merge the batched nodes and compare against the single stencil
+      BilinearStencil merged;
+      for (h_size k = 0; k < 4; ++k)
+        merged.add(stencils.indices(k)[i], stencils.weights(k)[i]);
+      REQUIRE(merged.size() == s.size());
+      for (h_size k = 0; k < s.size(); ++k) {
+        REQUIRE(merged.indices()[k] == s.indices()[k]);
+        REQUIRE_THAT(merged.weights()[k],
+                     Catch::Matchers::WithinAbs(s.weights()[k], 1e-6));
+      }
+    }
+  }
+  SECTION("bicubic") {
+    auto s = bicubic(grid, core::Element::Type::VERTEX,
+                     hermes::geo::point2(0.13, 0.07));
+    f32 w = 0.f;
+    for (auto sw : s.weights())
+      w += sw;
+    REQUIRE_THAT(w, Catch::Matchers::WithinAbs(1, 1e-5));
+    REQUIRE(s.size() == 9);
+  }
+}
+
+/// Positions of a 21 x 21 lattice of spacing dx / 2 covering a 10 x 10 grid
+/// of cell size dx.
+std::vector<hermes::geo::point2> samplePositions(f32 dx) {
+  std::vector<hermes::geo::point2> positions;
+  for (i32 j = 0; j < 21; ++j)
+    for (i32 i = 0; i < 21; ++i)
+      positions.emplace_back(i * dx / 2, j * dx / 2);
+  return positions;
 }
 
 struct SampleTestCaseParameters {
@@ -217,11 +255,11 @@ TEST_CASE("sample", "[sampling]") {
         utils::setField<f32>(grid, dst_field, reset);
         sample<f32>(grid, src_field, dst_field);
         for (h_size k = 0; k < dst_field.size(); ++k) {
-          auto err =
-              grid.isBoundary(dst_field.element(),
-                              k + grid.elementIndexOffset(dst_field.element()))
-                  ? param.boundary_tol
-                  : param.tol;
+          auto err = grid.isBoundary(core::ElementIndex::global(
+                         dst_field.element(),
+                         k + grid.elementIndexOffset(dst_field.element())))
+                         ? param.boundary_tol
+                         : param.tol;
           REQUIRE_THAT(dst_field[k],
                        Catch::Matchers::WithinAbs(exact_dst_field[k], err));
         }
@@ -229,10 +267,7 @@ TEST_CASE("sample", "[sampling]") {
     }
   }
   SECTION("continum " + std::to_string(param.dx)) {
-    hermes::geo::vec2 sample_dx(param.dx / 2, param.dx / 2);
-    hermes::range2 range({0, 0}, {21, 21});
-    auto sample_positions = hermes::sampling::sampleGrid(
-        hermes::geo::bounds::bbox2::from<i32>(range, sample_dx), range.size());
+    auto sample_positions = samplePositions(param.dx);
     std::vector<f32> samples_exact;
     for (auto s : sample_positions)
       samples_exact.emplace_back(f(s));
@@ -332,11 +367,11 @@ TEST_CASE("sample vectors", "[sampling]") {
         utils::setField<hermes::geo::vec2>(grid, dst_field, reset);
         sample<hermes::geo::vec2>(grid, src_field, dst_field);
         for (h_size k = 0; k < dst_field.size(); ++k) {
-          auto err =
-              grid.isBoundary(dst_field.element(),
-                              k + grid.elementIndexOffset(dst_field.element()))
-                  ? param.boundary_tol
-                  : param.tol;
+          auto err = grid.isBoundary(core::ElementIndex::global(
+                         dst_field.element(),
+                         k + grid.elementIndexOffset(dst_field.element())))
+                         ? param.boundary_tol
+                         : param.tol;
           for (h_size c = 0; c < 2; ++c)
             REQUIRE_THAT(dst_field[k][c], Catch::Matchers::WithinAbs(
                                               exact_dst_field[k][c], err));
@@ -351,11 +386,12 @@ TEST_CASE("sample vectors", "[sampling]") {
           sample<hermes::geo::vec2>(grid, src_field, component,
                                     dst_scalar_field);
           for (h_size k = 0; k < dst_scalar_field.size(); ++k) {
-            auto err = grid.isBoundary(dst_scalar_field.element(),
-                                       k + grid.elementIndexOffset(
-                                               dst_scalar_field.element()))
-                           ? param.boundary_tol
-                           : param.tol;
+            auto err =
+                grid.isBoundary(core::ElementIndex::global(
+                    dst_scalar_field.element(),
+                    k + grid.elementIndexOffset(dst_scalar_field.element())))
+                    ? param.boundary_tol
+                    : param.tol;
             REQUIRE_THAT(
                 dst_scalar_field[k],
                 Catch::Matchers::WithinAbs(exact_dst_field[k][component], err));
@@ -365,10 +401,7 @@ TEST_CASE("sample vectors", "[sampling]") {
     }
   }
   SECTION("continum " + std::to_string(param.dx)) {
-    hermes::geo::vec2 sample_dx(param.dx / 2, param.dx / 2);
-    hermes::range2 range({0, 0}, {21, 21});
-    auto sample_positions = hermes::sampling::sampleGrid(
-        hermes::geo::bounds::bbox2::from<i32>(range, sample_dx), range.size());
+    auto sample_positions = samplePositions(param.dx);
     std::vector<hermes::geo::vec2> samples_exact;
     for (auto s : sample_positions)
       samples_exact.emplace_back(f(s));
@@ -387,3 +420,81 @@ TEST_CASE("sample vectors", "[sampling]") {
     }
   }
 }
+
+TEST_CASE("sample tiled storage", "[sampling]") {
+  // tiles do not divide the resolution, so border tiles are cropped
+  auto grid = geo::Grid2::Config()
+                  .setCellSize(0.1f)
+                  .setResolution({37, 21})
+                  .build()
+                  .value();
+  const auto loc = core::Element(core::Element::Type::CELL);
+  core::FieldSet fields;
+  fields.add<f32>(loc, 0, {"f", "tiled_f"});
+  fields.add<f32>(core::Element::Type::VERTEX, 0, {"v", "tiled_v"});
+  fields.setElementCountFrom(&grid);
+  auto f = *fields.get<f32>("f");
+  auto tiled_f = *fields.get<f32>("tiled_f");
+  auto v = *fields.get<f32>("v");
+  auto tiled_v = *fields.get<f32>("tiled_v");
+  utils::setField<f32>(grid, f, [](const hermes::geo::point2 &p) -> f32 {
+    return std::sin(3.f * p.x) * std::cos(2.f * p.y);
+  });
+  // points inside, on and outside of the grid
+  std::vector<hermes::geo::point2> positions;
+  std::vector<f32> xs, ys;
+  for (i32 j = -3; j < 50; ++j)
+    for (i32 i = -3; i < 80; ++i) {
+      positions.emplace_back(i * 0.0517f, j * 0.0461f);
+      xs.emplace_back(positions.back().x);
+      ys.emplace_back(positions.back().y);
+    }
+  const auto row_major = grid.layout(loc);
+  for (auto storage :
+       {geo::GridStorage::TILED, geo::GridStorage::MORTON_TILED}) {
+    const auto layout = grid.layout(loc, storage, 8);
+    geo::relayout(row_major, f, layout, tiled_f);
+    SECTION("bilinear " + std::to_string(static_cast<int>(storage))) {
+      // same nodes and weights, with nodes indexed by storage
+      BilinearStencils stencils, tiled_stencils;
+      bilinear(grid, loc, xs, ys, stencils);
+      bilinear(grid, loc, xs, ys, layout, tiled_stencils);
+      REQUIRE(tiled_stencils.size() == stencils.size());
+      for (h_size k = 0; k < 4; ++k)
+        for (h_size i = 0; i < stencils.size(); ++i) {
+          auto ij = row_major.index(stencils.indices(k)[i]);
+          REQUIRE(tiled_stencils.indices(k)[i] == layout.flatIndex(ij));
+          REQUIRE(tiled_stencils.weights(k)[i] == stencils.weights(k)[i]);
+        }
+    }
+    SECTION("sample " + std::to_string(static_cast<int>(storage))) {
+      auto samples = sample<f32>(grid, f, positions).value();
+      auto tiled_samples =
+          sample<f32>(grid, tiled_f, positions, layout).value();
+      REQUIRE(tiled_samples.size() == positions.size());
+      auto acc = samples.get<f32>(0);
+      auto tiled_acc = tiled_samples.get<f32>(0);
+      for (h_size i = 0; i < positions.size(); ++i)
+        REQUIRE_THAT(tiled_acc[i], Catch::Matchers::WithinAbs(acc[i], 1e-6));
+    }
+    SECTION("between fields " + std::to_string(static_cast<int>(storage))) {
+      // cells to vertices, both stored with the same storage
+      const auto v_layout =
+          grid.layout(core::Element::Type::VERTEX, storage, 8);
+      const auto v_row_major = grid.layout(core::Element::Type::VERTEX);
+      sample<f32>(grid, f, v);
+      sample<f32>(grid, tiled_f, tiled_v, layout, v_layout);
+      std::vector<f32> values(v.size());
+      geo::relayout(v_layout, tiled_v, v_row_major, values);
+      for (h_size k = 0; k < values.size(); ++k)
+        REQUIRE(values[k] == v[k]);
+      // the element overload keeps the storage of the field
+      auto samples =
+          sample<f32>(grid, tiled_f, core::Element::Type::VERTEX, layout);
+      REQUIRE(samples);
+      auto acc = samples->get<f32>(0);
+      for (h_size k = 0; k < acc.size(); ++k)
+        REQUIRE(acc[k] == tiled_v[k]);
+    }
+  }
+}
@@ -1,6 +1,7 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
 
+#include <naiades/base/parallel.h>
 #include <naiades/utils/utils.h>
 
 using namespace naiades;
@@ -40,3 +41,43 @@ TEST_CASE("IndexSet", "[core]") {
     }
   }
 }
+
+TEST_CASE("Parallel", "[base]") {
+  SECTION("for") {
+    ThreadPool::setThreadCount(4);
+    REQUIRE(ThreadPool::threadCount() == 4);
+    std::vector<h_size> v(1000, 0);
+    parallelFor(0, v.size(), [&](h_index i) { v[i] += i; }, 7);
+    for (h_size i = 0; i < v.size(); ++i)
+      REQUIRE(v[i] == i);
+    std::vector<h_size> w(13 * 17, 0);
+    parallelFor(hermes::range2(hermes::size2(13, 17)),
+                [&](const hermes::index2 &ij) { w[ij.j * 13 + ij.i]++; });
+    for (auto count : w)
+      REQUIRE(count == 1);
+    ThreadPool::setThreadCount(0);
+  }
+  SECTION("nested") {
+    ThreadPool::setThreadCount(3);
+    std::vector<h_size> v(64 * 64, 0);
+    parallelFor(0, 64, [&](h_index j) {
+      parallelFor(0, 64, [&](h_index i) { v[j * 64 + i] = j * 64 + i; });
+    });
+    for (h_size i = 0; i < v.size(); ++i)
+      REQUIRE(v[i] == i);
+    ThreadPool::setThreadCount(0);
+  }
+  SECTION("reduce") {
+    ThreadPool::setThreadCount(4);
+    auto sum = parallelReduce(
+        0, 10001, h_size(0), [](h_index i) { return i; },
+        [](h_size a, h_size b) { return a + b; }, 100);
+    REQUIRE(sum == 10000 * 10001 / 2);
+    auto count = parallelReduce(
+        hermes::range2(hermes::size2(10, 20)), h_size(0),
+        [](const hermes::index2 &ij) { return h_size(ij.i + ij.j * 10); },
+        [](h_size a, h_size b) { return a + b; });
+    REQUIRE(count == 199 * 200 / 2);
+    ThreadPool::setThreadCount(0);
+  }
+}